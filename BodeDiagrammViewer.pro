@@ -1,4 +1,4 @@
-QT       += core gui
+QT       += core gui concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets printsupport svg
 
@@ -9,17 +9,27 @@ CONFIG += c++17
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    bodecursor.cpp \
     bodeplot.cpp \
     exportbodeplot.cpp \
+    frequencyresponsedata.cpp \
+    frequencysweepprovider.cpp \
     main.cpp \
     mainwindow.cpp \
+    plotlinker.cpp \
+    polynomialparser.cpp \
     qcustomplot.cpp \
     transferfunction.cpp
 
 HEADERS += \
+    bodecursor.h \
     bodeplot.h \
     exportbodeplot.h \
+    frequencyresponsedata.h \
+    frequencysweepprovider.h \
     mainwindow.h \
+    plotlinker.h \
+    polynomialparser.h \
     qcustomplot.h \
     transferfunction.h
 
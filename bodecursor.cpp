@@ -0,0 +1,175 @@
+#include "bodecursor.h"
+#include <cmath>
+#include <limits>
+
+// Constructor for the BodeCursor class, creates the hidden cursor on both plots and follows the mouse on them
+BodeCursor::BodeCursor(QCustomPlot *magnitudePlot, QCustomPlot *phasePlot, QObject *parent)
+    : QObject(parent), magnitudeCursor(createItems(magnitudePlot)), phaseCursor(createItems(phasePlot))
+{
+    for (QCustomPlot *plot : {magnitudePlot, phasePlot}) {
+        connect(plot, &QCustomPlot::mouseMove, this, &BodeCursor::onMouseMove);
+        plot->installEventFilter(this);
+    }
+}
+
+// Sets the transfer function for exact readouts and hides the cursor, because its readouts belong to the previous plot
+void BodeCursor::setTransferFunction(const TransferFunction &transferFunction)
+{
+    model = transferFunction;
+    hide();
+}
+
+// Removes the transfer function for plots of measured data only and hides the cursor
+void BodeCursor::clearTransferFunction()
+{
+    model.reset();
+    hide();
+}
+
+// Hides the cursor items and repaints the cursor layers, but only if the cursor was visible
+void BodeCursor::hide()
+{
+    for (CursorItems *items : {&magnitudeCursor, &phaseCursor}) {
+        if (items->line->visible()) {
+            items->line->setVisible(false);
+            items->tracer->setVisible(false);
+            items->readout->setVisible(false);
+            items->layer->replot();
+        }
+    }
+}
+
+// Hides the cursor when the mouse leaves one of the plots
+bool BodeCursor::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::Leave) {
+        hide();
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+// Converts the mouse position on either plot to a frequency, both plots share the frequency axis
+void BodeCursor::onMouseMove(QMouseEvent *event)
+{
+    QCustomPlot *plot = qobject_cast<QCustomPlot *>(sender());
+    if (!plot || !plot->axisRect()->rect().contains(event->pos())) {
+        hide();
+        return;
+    }
+    moveTo(plot->xAxis->pixelToCoord(event->pos().x()));
+}
+
+// Creates a buffered layer above all other layers, so that moving the cursor doesn't redraw the graphs
+BodeCursor::CursorItems BodeCursor::createItems(QCustomPlot *plot)
+{
+    CursorItems items;
+    items.plot = plot;
+    plot->addLayer("cursor", nullptr, QCustomPlot::limAbove);
+    items.layer = plot->layer("cursor");
+    items.layer->setMode(QCPLayer::lmBuffered);
+
+    // Draws the cursor as a dashed vertical line through the frequency
+    items.line = new QCPItemStraightLine(plot);
+    items.line->setLayer(items.layer);
+    items.line->setPen(QPen(QColor(80, 80, 80), 1, Qt::DashLine));
+
+    // Marks the point of the graph at the frequency
+    items.tracer = new QCPItemTracer(plot);
+    items.tracer->setLayer(items.layer);
+    items.tracer->setStyle(QCPItemTracer::tsCircle);
+    items.tracer->setSize(7);
+    items.tracer->setPen(QPen(QColor(80, 80, 80)));
+    items.tracer->setBrush(Qt::white);
+
+    // Shows the readouts at the top of the axis rect next to the cursor line
+    items.readout = new QCPItemText(plot);
+    items.readout->setLayer(items.layer);
+    items.readout->position->setTypeX(QCPItemPosition::ptPlotCoords);
+    items.readout->position->setTypeY(QCPItemPosition::ptAxisRectRatio);
+    items.readout->setTextAlignment(Qt::AlignLeft);
+    items.readout->setPadding(QMargins(4, 2, 4, 2));
+    items.readout->setPen(QPen(QColor(180, 180, 180)));
+    items.readout->setBrush(QColor(255, 255, 255, 220));
+
+    // The cursor is always under the mouse, so it must not take part in selection
+    for (QCPAbstractItem *item : std::initializer_list<QCPAbstractItem *>{items.line, items.tracer, items.readout}) {
+        item->setSelectable(false);
+        item->setVisible(false);
+    }
+    return items;
+}
+
+// Places the items and keeps the readout inside the axis rect by showing it left of the cursor line in the right half
+void BodeCursor::placeItems(CursorItems &items, double w, double value, const QString &text)
+{
+    items.line->point1->setCoords(w, 0);
+    items.line->point2->setCoords(w, 1);
+    items.line->setVisible(true);
+
+    items.tracer->position->setCoords(w, value);
+    items.tracer->setVisible(std::isfinite(value));
+
+    QCPAxisRect *axisRect = items.plot->axisRect();
+    bool rightHalf = items.plot->xAxis->coordToPixel(w) > axisRect->center().x();
+    items.readout->position->setCoords(w, 0.02);
+    items.readout->setPositionAlignment(Qt::AlignTop | (rightHalf ? Qt::AlignRight : Qt::AlignLeft));
+    items.readout->setText(text);
+    items.readout->setVisible(true);
+
+    // Repaints only the cursor layer, all other layers keep their buffers
+    items.layer->replot();
+}
+
+// Finds the data points around w with findBegin in O(log n) and interpolates linearly over log(w) like the graph is drawn
+double BodeCursor::interpolate(const QCPGraph *graph, double w)
+{
+    QSharedPointer<QCPGraphDataContainer> data = graph->data();
+    QCPGraphDataContainer::const_iterator upper = data->findBegin(w, false);
+    if (upper == data->constEnd()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (upper->key == w) {
+        return upper->value;
+    }
+    if (upper == data->constBegin()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    QCPGraphDataContainer::const_iterator lower = upper - 1;
+    double t = lower->key > 0 ? std::log(w / lower->key) / std::log(upper->key / lower->key)
+                              : (w - lower->key) / (upper->key - lower->key);
+    return lower->value + t * (upper->value - lower->value);
+}
+
+// Calculates the readouts at w and shows them on both plots
+void BodeCursor::moveTo(double w)
+{
+    if (magnitudeCursor.plot->graphCount() == 0 || phaseCursor.plot->graphCount() == 0) {
+        hide();
+        return;
+    }
+
+    double magnitude;
+    double phase;
+    if (model) {
+        // Evaluates the transfer function exactly and shifts the phase by multiples of 360° to the unwrapped plotted phase
+        std::complex<double> H = model->evaluate(w);
+        magnitude = 20 * std::log10(std::abs(H));
+        phase = std::arg(H) * 180 / M_PI;
+        double plottedPhase = interpolate(phaseCursor.plot->graph(0), w);
+        if (std::isfinite(plottedPhase)) {
+            phase += 360 * std::round((plottedPhase - phase) / 360);
+        }
+    } else {
+        magnitude = interpolate(magnitudeCursor.plot->graph(0), w);
+        phase = interpolate(phaseCursor.plot->graph(0), w);
+    }
+
+    // Formats the readouts, values outside the plotted data are shown as a dash
+    QString magnitudeText = std::isfinite(magnitude) ? QString::number(magnitude, 'f', 2) + " dB" : "–";
+    QString phaseText = std::isfinite(phase) ? QString::number(phase, 'f', 1) + "°" : "–";
+    QString text = QString("ω = %1 rad/s\n|H| = %2\n∠H = %3").arg(w, 0, 'g', 4).arg(magnitudeText, phaseText);
+
+    placeItems(magnitudeCursor, w, magnitude, text);
+    placeItems(phaseCursor, w, phase, text);
+}
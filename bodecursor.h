@@ -0,0 +1,67 @@
+#ifndef BODECURSOR_H
+#define BODECURSOR_H
+
+#include <QObject>
+#include <optional>
+#include "qcustomplot.h"
+#include "transferfunction.h"
+
+// The BodeCursor class shows a vertical cursor with readouts of the frequency, magnitude and phase on both bode plots
+// It follows the mouse on either plot and is drawn on its own buffered layer, so that a mouse move only repaints the cursor
+class BodeCursor : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Creates the cursor layer and the cursor items on the magnitude and phase plots
+    BodeCursor(QCustomPlot *magnitudePlot, QCustomPlot *phasePlot, QObject *parent = nullptr);
+
+    // Sets the transfer function, whose readouts are then evaluated exactly instead of interpolated from the plotted data
+    void setTransferFunction(const TransferFunction &transferFunction);
+
+    // Removes the transfer function, so that the readouts are interpolated from the plotted data (e.g. measured data)
+    void clearTransferFunction();
+
+    // Hides the cursor on both plots, e.g. before exporting the plots
+    void hide();
+
+protected:
+    // Hides the cursor when the mouse leaves a plot
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    // Moves the cursor to the frequency under the mouse or hides it if the mouse is outside the axis rect
+    void onMouseMove(QMouseEvent *event);
+
+private:
+    // Holds the cursor items of one plot, which all reside on the cursor layer
+    struct CursorItems
+    {
+        QCustomPlot *plot = nullptr;
+        QCPLayer *layer = nullptr;
+        QCPItemStraightLine *line = nullptr;
+        QCPItemTracer *tracer = nullptr;
+        QCPItemText *readout = nullptr;
+    };
+
+    // Creates the cursor layer on top of the plot and the cursor items on it
+    static CursorItems createItems(QCustomPlot *plot);
+
+    // Places the cursor items of one plot at the frequency w and the value of its graph and repaints only the cursor layer
+    static void placeItems(CursorItems &items, double w, double value, const QString &text);
+
+    // Looks up the value of a graph at w by binary search and interpolation on the logarithmic frequency axis, returns NaN outside the data
+    static double interpolate(const QCPGraph *graph, double w);
+
+    // Moves the cursor on both plots to the frequency w
+    void moveTo(double w);
+
+    // Holds the cursor items of the magnitude plot and the phase plot
+    CursorItems magnitudeCursor;
+    CursorItems phaseCursor;
+
+    // Holds the transfer function of the plotted model, if any
+    std::optional<TransferFunction> model;
+};
+
+#endif
@@ -40,9 +40,9 @@ void BodePlot::plot(const std::vector<double> &frequencies, const std::vector<do
     magnitudePlot->xAxis->setNumberFormat("eb");
     magnitudePlot->xAxis->setNumberPrecision(0);
 
-    // Rescales only the y-axis to fit the data and replots the magnitude plot
+    // Rescales only the y-axis to fit the data and queues a replot of the magnitude plot
     magnitudePlot->yAxis->rescale();
-    magnitudePlot->replot();
+    magnitudePlot->replot(QCustomPlot::rpQueuedReplot);
 
     // Plots the phase data and sets the axis labels
     phasePlot->addGraph();
@@ -58,7 +58,91 @@ void BodePlot::plot(const std::vector<double> &frequencies, const std::vector<do
     phasePlot->xAxis->setNumberFormat("eb");
     phasePlot->xAxis->setNumberPrecision(0);
 
-    // Rescales only the y-axis to fit the data and replots the phase plot
+    // Rescales only the y-axis to fit the data and queues a replot of the phase plot
     phasePlot->yAxis->rescale();
-    phasePlot->replot();
+    phasePlot->replot(QCustomPlot::rpQueuedReplot);
+}
+
+// Plots the measured magnitude and phase responses on top of the current bode plots
+void BodePlot::plotMeasured(const FrequencyResponseData &measuredData)
+{
+    // Uses the data containers of the measured data directly, so no data points are copied
+    QCPGraph *magnitudeGraph = magnitudePlot->addGraph();
+    magnitudeGraph->setData(measuredData.magnitudeData());
+    magnitudeGraph->setName("Messung");
+    magnitudeGraph->setPen(QPen(Qt::red));
+
+    QCPGraph *phaseGraph = phasePlot->addGraph();
+    phaseGraph->setData(measuredData.phaseData());
+    phaseGraph->setPen(QPen(Qt::red));
+
+    // Sets the x-axis to logarithmic scale and the x-range to the measured frequencies if no model is plotted
+    bool foundRange;
+    QCPRange frequencyRange = measuredData.magnitudeData()->keyRange(foundRange, QCP::sdPositive);
+    for (QCustomPlot *plot : {magnitudePlot, phasePlot}) {
+        plot->xAxis->setLabel("Frequenz in rad/s");
+        plot->xAxis->setScaleType(QCPAxis::stLogarithmic);
+        plot->xAxis->setNumberFormat("eb");
+        plot->xAxis->setNumberPrecision(0);
+        if (foundRange && plot->graphCount() == 1) {
+            plot->xAxis->setRange(frequencyRange);
+        }
+    }
+    magnitudePlot->yAxis->setLabel("Amplitude in dB");
+    phasePlot->yAxis->setLabel("Phase in °");
+
+    // Rescales only the y-axes to fit the model and measured data and queues a replot of both plots
+    magnitudePlot->yAxis->rescale();
+    magnitudePlot->replot(QCustomPlot::rpQueuedReplot);
+    phasePlot->yAxis->rescale();
+    phasePlot->replot(QCustomPlot::rpQueuedReplot);
+}
+
+// Plots |S| and |T| as dashed graphs into the magnitude plot and shows a legend to tell them apart from the transfer function
+void BodePlot::plotSensitivity(const std::vector<double> &frequencies, const std::vector<double> &sensitivity,
+                               const std::vector<double> &complementarySensitivity)
+{
+    QVector<double> qFrequencies = QVector<double>(frequencies.begin(), frequencies.end());
+    QVector<double> qSensitivity = QVector<double>(sensitivity.begin(), sensitivity.end());
+    QVector<double> qComplementarySensitivity = QVector<double>(complementarySensitivity.begin(), complementarySensitivity.end());
+
+    magnitudePlot->graph(0)->setName("G(jω)");
+
+    QCPGraph *sensitivityGraph = magnitudePlot->addGraph();
+    sensitivityGraph->setData(qFrequencies, qSensitivity, true);
+    sensitivityGraph->setName("S(jω)");
+    sensitivityGraph->setPen(QPen(QColor(0, 150, 0), 1, Qt::DashLine));
+
+    QCPGraph *complementaryGraph = magnitudePlot->addGraph();
+    complementaryGraph->setData(qFrequencies, qComplementarySensitivity, true);
+    complementaryGraph->setName("T(jω)");
+    complementaryGraph->setPen(QPen(QColor(200, 120, 0), 1, Qt::DashLine));
+
+    // Keeps the y-range of the transfer function, so that large sensitivity peaks don't compress it
+    magnitudePlot->legend->setVisible(true);
+    magnitudePlot->replot(QCustomPlot::rpQueuedReplot);
+}
+
+// Plots the asymptotes as dotted graphs, they only consist of the break points and therefore add hardly any drawing effort
+void BodePlot::plotAsymptotes(const std::vector<double> &frequencies, const std::vector<double> &magnitude,
+                              const std::vector<double> &phase)
+{
+    QVector<double> qFrequencies = QVector<double>(frequencies.begin(), frequencies.end());
+    QVector<double> qMagnitude = QVector<double>(magnitude.begin(), magnitude.end());
+    QVector<double> qPhase = QVector<double>(phase.begin(), phase.end());
+    QPen asymptotePen(Qt::gray, 1, Qt::DotLine);
+
+    QCPGraph *magnitudeGraph = magnitudePlot->addGraph();
+    magnitudeGraph->setData(qFrequencies, qMagnitude, true);
+    magnitudeGraph->setName("Asymptoten");
+    magnitudeGraph->setPen(asymptotePen);
+
+    QCPGraph *phaseGraph = phasePlot->addGraph();
+    phaseGraph->setData(qFrequencies, qPhase, true);
+    phaseGraph->setName("Asymptoten");
+    phaseGraph->setPen(asymptotePen);
+
+    // Keeps the y-ranges of the transfer function and queues a replot of both plots
+    magnitudePlot->replot(QCustomPlot::rpQueuedReplot);
+    phasePlot->replot(QCustomPlot::rpQueuedReplot);
 }
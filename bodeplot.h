@@ -2,6 +2,7 @@
 #define BODEPLOT_H
 
 #include "qcustomplot.h"
+#include "frequencyresponsedata.h"
 #include <vector>
 
 // The BodePlot class is responsible for displaying the bode plots including magnitude and phase responses on designated QCustomPlot objects
@@ -15,6 +16,17 @@ public:
     void plot(const std::vector<double> &frequencies, const std::vector<double> &magnitude,
               const std::vector<double> &phase, double xMin, double xMax);
 
+    // Adds the sensitivity and complementary sensitivity magnitudes in dB as additional graphs to the magnitude plot
+    void plotSensitivity(const std::vector<double> &frequencies, const std::vector<double> &sensitivity,
+                         const std::vector<double> &complementarySensitivity);
+
+    // Adds the straight-line asymptotes of the magnitude and phase as additional graphs to the magnitude and phase plots
+    void plotAsymptotes(const std::vector<double> &frequencies, const std::vector<double> &magnitude,
+                        const std::vector<double> &phase);
+
+    // Adds the measured frequency response as an additional graph to the magnitude and phase plots
+    void plotMeasured(const FrequencyResponseData &measuredData);
+
 private:
     // Plots the magnitude response and the phase response
     QCustomPlot *magnitudePlot;
@@ -0,0 +1,19 @@
+# common project settings of the benchmark examples, included after TARGET is set
+
+QT       += core gui
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets printsupport
+
+greaterThan(QT_MAJOR_VERSION, 4): CONFIG += c++11
+lessThan(QT_MAJOR_VERSION, 5): QMAKE_CXXFLAGS += -std=c++11
+
+TEMPLATE = app
+CONFIG += console
+
+INCLUDEPATH += $$PWD/../../ $$PWD
+SOURCES += \
+    $$PWD/../../qcustomplot.cpp
+
+HEADERS += \
+    $$PWD/../../qcustomplot.h \
+    $$PWD/benchmarkutil.h
@@ -0,0 +1,120 @@
+/***************************************************************************
+**                                                                        **
+**  QCustomPlot, an easy to use, modern plotting widget for Qt            **
+**  Copyright (C) 2011-2022 Emanuel Eichhammer                            **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************/
+
+/*
+  Helpers shared by the benchmark examples: reading the size argument, timing replots and printing
+  the result table. Included by the benchmarks via benchmark.pri.
+*/
+
+#ifndef BENCHMARKUTIL_H
+#define BENCHMARKUTIL_H
+
+#include <QElapsedTimer>
+#include <QStringList>
+#include <cstdio>
+#include "qcustomplot.h"
+
+namespace benchmark
+{
+
+// returns the time since timer was started in milliseconds:
+inline double elapsedMs(const QElapsedTimer &timer)
+{
+  return timer.nsecsElapsed()/1e6;
+}
+
+// reads the first command line argument into size, or uses defaultSize if there is none. Prints an
+// error and returns false if the argument isn't a positive number:
+inline bool readSizeArgument(int argc, char *argv[], int defaultSize, const char *what, int &size)
+{
+  size = argc > 1 ? QString(argv[1]).toInt() : defaultSize;
+  if (size <= 0)
+  {
+    std::printf("invalid %s\n", what);
+    return false;
+  }
+  return true;
+}
+
+// resizes the plot to the size all benchmarks replot at:
+inline void setupPlot(QCustomPlot *plot)
+{
+  plot->resize(1200, 600);
+}
+
+// replots once to allocate buffers and caches, then calls prepare(i) before each of replotCount
+// timed replots and returns the average replot time:
+template <class Prepare>
+double averageReplotMs(QCustomPlot *plot, int replotCount, Prepare prepare)
+{
+  plot->replot(QCustomPlot::rpImmediateRefresh);
+  QElapsedTimer timer;
+  timer.start();
+  for (int i=0; i<replotCount; ++i)
+  {
+    prepare(i);
+    plot->replot(QCustomPlot::rpImmediateRefresh);
+  }
+  return elapsedMs(timer)/replotCount;
+}
+
+// replots without changes in between, see above:
+inline double averageReplotMs(QCustomPlot *plot, int replotCount)
+{
+  return averageReplotMs(plot, replotCount, [](int) {});
+}
+
+// prints the result table: a name column of nameWidth characters followed by one millisecond column
+// per entry of columns. With two columns, the speedup of the second over the first is appended:
+class Table
+{
+public:
+  Table(int nameWidth, const QStringList &columns) :
+    mNameWidth(nameWidth),
+    mColumns(columns)
+  {
+    std::printf("%-*s", mNameWidth, "");
+    for (int i=0; i<mColumns.size(); ++i)
+      std::printf(" %*s", columnWidth(i), mColumns.at(i).toLatin1().constData());
+    if (mColumns.size() == 2)
+      std::printf(" %9s", "speedup");
+    std::printf("\n");
+  }
+  
+  void printRow(const QString &name, const QVector<double> &ms) const
+  {
+    std::printf("%-*s", mNameWidth, name.toLatin1().constData());
+    for (int i=0; i<ms.size() && i<mColumns.size(); ++i)
+      std::printf(" %*.3f", columnWidth(i), ms.at(i));
+    if (mColumns.size() == 2 && ms.size() == 2)
+      std::printf(" %8.2fx", ms.at(1) > 0 ? ms.at(0)/ms.at(1) : 0.0);
+    std::printf("\n");
+  }
+  
+private:
+  int mNameWidth;
+  QStringList mColumns;
+  
+  int columnWidth(int column) const { return qMax(12, int(mColumns.at(column).size())); }
+};
+
+}
+
+#endif // BENCHMARKUTIL_H
@@ -0,0 +1,5 @@
+TARGET = colormap-benchmark
+include(../benchmark-common/benchmark.pri)
+
+SOURCES += \
+        main.cpp
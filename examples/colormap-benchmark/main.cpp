@@ -0,0 +1,107 @@
+/***************************************************************************
+**                                                                        **
+**  QCustomPlot, an easy to use, modern plotting widget for Qt            **
+**  Copyright (C) 2011-2022 Emanuel Eichhammer                            **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************/
+
+/*
+  Measures the colorization of a large color map (QCPColorMap::updateMapImage) with linear and
+  logarithmic data scale, with and without alpha data. Every replot modifies two opposite corner
+  cells, so the whole map image is colorized again. Finally, a waterfall diagram is measured, where
+  every replot appends one row with QCPColorMapData::appendValueRow, so only that row is
+  colorized.
+  
+  Usage: colormap-benchmark [map size]
+*/
+
+#include <QApplication>
+#include <cmath>
+#include "benchmarkutil.h"
+
+using namespace benchmark;
+
+namespace
+{
+
+// marks all cells modified before each replot by touching two opposite corner cells, returns the
+// average replot time:
+double averageFullReplotMs(QCustomPlot *plot, QCPColorMap *colorMap)
+{
+  QCPColorMapData *data = colorMap->data();
+  return averageReplotMs(plot, 5, [data](int)
+  {
+    data->setCell(0, 0, data->cell(0, 0));
+    data->setCell(data->keySize()-1, data->valueSize()-1, data->cell(data->keySize()-1, data->valueSize()-1));
+  });
+}
+
+// appends a row before each replot, returns the average replot time:
+double averageAppendReplotMs(QCustomPlot *plot, QCPColorMap *colorMap)
+{
+  QCPColorMapData *data = colorMap->data();
+  QVector<double> row(data->keySize());
+  return averageReplotMs(plot, 50, [data, &row](int i)
+  {
+    for (int x=0; x<row.size(); ++x)
+      row[x] = std::pow(10.0, 6.0*(0.5+0.5*std::sin(x*0.01+i*0.1)));
+    data->appendValueRow(row);
+  });
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+  QApplication a(argc, argv);
+  int size;
+  if (!readSizeArgument(argc, argv, 4096, "map size", size))
+    return 1;
+  
+  // frequency response like data spanning several decades:
+  QCustomPlot plot;
+  setupPlot(&plot);
+  QCPColorMap *colorMap = new QCPColorMap(plot.xAxis, plot.yAxis);
+  colorMap->data()->setSize(size, size);
+  colorMap->data()->setRange(QCPRange(0, 1), QCPRange(0, 1));
+  for (int x=0; x<size; ++x)
+  {
+    for (int y=0; y<size; ++y)
+      colorMap->data()->setCell(x, y, std::pow(10.0, 6.0*(0.5+0.5*std::sin(x*0.01)*std::cos(y*0.013))));
+  }
+  colorMap->setGradient(QCPColorGradient::gpJet);
+  colorMap->setInterpolate(false);
+  plot.rescaleAxes();
+  
+  std::printf("%dx%d cells, %d threads\n", size, size, QThread::idealThreadCount());
+  const Table table(20, QStringList() << "replot ms");
+  for (int alpha=0; alpha<2; ++alpha)
+  {
+    if (alpha)
+      colorMap->data()->fillAlpha(128);
+    for (int logarithmic=0; logarithmic<2; ++logarithmic)
+    {
+      colorMap->setDataScaleType(logarithmic ? QCPAxis::stLogarithmic : QCPAxis::stLinear);
+      colorMap->rescaleDataRange(true);
+      const QString name = QString("%1%2").arg(logarithmic ? "logarithmic" : "linear").arg(alpha ? " (alpha)" : "");
+      table.printRow(name, QVector<double>() << averageFullReplotMs(&plot, colorMap));
+    }
+  }
+  colorMap->data()->clearAlpha();
+  table.printRow("waterfall (append)", QVector<double>() << averageAppendReplotMs(&plot, colorMap));
+  
+  return 0;
+}
@@ -0,0 +1,5 @@
+TARGET = datacontainer-benchmark
+include(../benchmark-common/benchmark.pri)
+
+SOURCES += \
+        main.cpp
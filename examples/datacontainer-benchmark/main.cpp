@@ -0,0 +1,138 @@
+/***************************************************************************
+**                                                                        **
+**  QCustomPlot, an easy to use, modern plotting widget for Qt            **
+**  Copyright (C) 2011-2022 Emanuel Eichhammer                            **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************/
+
+/*
+  Compares the point based QCPGraphDataContainer with the column based QCPGraphDataColumns.
+  
+  Usage: datacontainer-benchmark [point count]
+*/
+
+#include <QApplication>
+#include <cstdlib>
+#include "benchmarkutil.h"
+
+using namespace benchmark;
+
+namespace
+{
+
+// replots the plot with several zoom levels of the key axis and returns the average replot time:
+double averageZoomReplotMs(QCustomPlot *plot, double keyMin, double keyMax)
+{
+  return averageReplotMs(plot, 20, [plot, keyMin, keyMax](int i)
+  {
+    const double span = (keyMax-keyMin)/double(1 << (i % 10));
+    const double center = keyMin+(keyMax-keyMin)*(0.3+0.04*(i % 10));
+    plot->xAxis->setRange(center-span/2.0, center+span/2.0);
+  });
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+  QApplication a(argc, argv);
+  int n;
+  if (!readSizeArgument(argc, argv, 10000000, "point count", n))
+    return 1;
+  
+  // generate a noisy signal with sorted keys:
+  QVector<double> keys(n), values(n);
+  QVector<QCPGraphData> points(n);
+  for (int i=0; i<n; ++i)
+  {
+    keys[i] = i*1e-3;
+    values[i] = qSin(keys.at(i))*10+(std::rand()/double(RAND_MAX)-0.5);
+    points[i] = QCPGraphData(keys.at(i), values.at(i));
+  }
+  std::printf("%d points\n", n);
+  const Table table(34, QStringList() << "container ms" << "columns ms");
+  
+  QElapsedTimer timer;
+  double containerMs, columnsMs;
+  QSharedPointer<QCPGraphDataContainer> container(new QCPGraphDataContainer);
+  QSharedPointer<QCPGraphDataColumns> columns(new QCPGraphDataColumns);
+  
+  // filling:
+  timer.start();
+  container->set(points, true);
+  containerMs = elapsedMs(timer);
+  timer.start();
+  columns->set(keys, values, true);
+  columnsMs = elapsedMs(timer);
+  table.printRow("set (copy)", QVector<double>() << containerMs << columnsMs);
+  timer.start();
+  columns->setRawData(keys.constData(), values.constData(), n);
+  columnsMs = elapsedMs(timer);
+  table.printRow("set (external columns)", QVector<double>() << containerMs << columnsMs);
+  
+  // value range of all points, the container once with a linear scan and once with its min/max index:
+  bool foundRange;
+  QCPRange containerRange, columnsRange;
+  container->setValueIndexEnabled(false);
+  timer.start();
+  containerRange = container->valueRange(foundRange);
+  containerMs = elapsedMs(timer);
+  timer.start();
+  columnsRange = columns->valueRange(foundRange);
+  columnsMs = elapsedMs(timer);
+  table.printRow("valueRange (linear scan)", QVector<double>() << containerMs << columnsMs);
+  if (containerRange != columnsRange)
+    std::printf("  value ranges differ\n");
+  container->setValueIndexEnabled(true);
+  container->valueRange(foundRange); // builds the index
+  timer.start();
+  for (int i=0; i<1000; ++i)
+    container->valueRange(foundRange, QCP::sdBoth, QCPRange(i, n*1e-3-i));
+  containerMs = elapsedMs(timer)/1000.0;
+  timer.start();
+  for (int i=0; i<1000; ++i)
+    columns->valueRange(foundRange, QCP::sdBoth, QCPRange(i, n*1e-3-i));
+  columnsMs = elapsedMs(timer)/1000.0;
+  table.printRow("valueRange in key range (index)", QVector<double>() << containerMs << columnsMs);
+  
+  // binary searches:
+  const int searchCount = 1000000;
+  qint64 checksum = 0;
+  timer.start();
+  for (int i=0; i<searchCount; ++i)
+    checksum += container->findBegin((qint64(i)*7919 % n)*1e-3)-container->constBegin();
+  containerMs = elapsedMs(timer);
+  timer.start();
+  for (int i=0; i<searchCount; ++i)
+    checksum -= columns->findBegin((qint64(i)*7919 % n)*1e-3);
+  columnsMs = elapsedMs(timer);
+  table.printRow("1M findBegin", QVector<double>() << containerMs << columnsMs);
+  if (checksum != 0)
+    std::printf("  search results differ\n");
+  
+  // replots of a graph displaying the container and the columns:
+  QCustomPlot plot;
+  setupPlot(&plot);
+  plot.addGraph();
+  plot.graph(0)->setData(container);
+  plot.graph(0)->rescaleAxes();
+  containerMs = averageZoomReplotMs(&plot, 0, n*1e-3);
+  plot.graph(0)->setDataColumns(columns);
+  columnsMs = averageZoomReplotMs(&plot, 0, n*1e-3);
+  table.printRow("replot while zooming", QVector<double>() << containerMs << columnsMs);
+  
+  return 0;
+}
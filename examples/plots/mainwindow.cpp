@@ -724,6 +724,14 @@ void MainWindow::setupRealtimeDataDemo(QCustomPlot *customPlot)
   customPlot->graph(0)->setPen(QPen(QColor(40, 110, 255)));
   customPlot->addGraph(); // red line
   customPlot->graph(1)->setPen(QPen(QColor(255, 110, 40)));
+  // store the data in ring buffers, which discard the oldest points in constant time once full
+  // (10000 points cover the visible 8 seconds at one point every 2 ms):
+  for (int i=0; i<2; ++i)
+  {
+    QSharedPointer<QCPGraphDataColumns> columns(new QCPGraphDataColumns);
+    columns->setCapacity(10000);
+    customPlot->graph(i)->setDataColumns(columns);
+  }
 
   QSharedPointer<QCPAxisTickerTime> timeTicker(new QCPAxisTickerTime);
   timeTicker->setTimeFormat("%h:%m:%s");
@@ -1450,7 +1458,7 @@ void MainWindow::realtimeDataSlot()
     ui->statusBar->showMessage(
           QString("%1 FPS, Total Data points: %2")
           .arg(frameCount/(key-lastFpsKey), 0, 'f', 0)
-          .arg(ui->customPlot->graph(0)->data()->size()+ui->customPlot->graph(1)->data()->size())
+          .arg(ui->customPlot->graph(0)->dataCount()+ui->customPlot->graph(1)->dataCount())
           , 0);
     lastFpsKey = key;
     frameCount = 0;
@@ -0,0 +1,77 @@
+/***************************************************************************
+**                                                                        **
+**  QCustomPlot, an easy to use, modern plotting widget for Qt            **
+**  Copyright (C) 2011-2022 Emanuel Eichhammer                            **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************/
+
+/*
+  Compares replotting dense graphs with the default pixmap paint buffers and with the software
+  rasterizer (QCustomPlot::setSoftwareRasterizer), for several pen widths with and without fill.
+  
+  Usage: rasterizer-benchmark [point count]
+*/
+
+#include <QApplication>
+#include <cstdlib>
+#include <cmath>
+#include "benchmarkutil.h"
+
+using namespace benchmark;
+
+int main(int argc, char *argv[])
+{
+  QApplication a(argc, argv);
+  int n;
+  if (!readSizeArgument(argc, argv, 100000, "point count", n))
+    return 1;
+  
+  // noisy signal, so the line covers many pixels per column:
+  QVector<double> keys(n), values(n);
+  for (int i=0; i<n; ++i)
+  {
+    keys[i] = i;
+    values[i] = std::sin(i/double(n)*20.0) + 0.5*std::rand()/double(RAND_MAX);
+  }
+  
+  QCustomPlot plot;
+  setupPlot(&plot);
+  plot.addGraph();
+  plot.graph(0)->setData(keys, values, true);
+  plot.graph(0)->setAdaptiveSampling(false);
+  plot.graph(0)->rescaleAxes();
+  plot.setAntialiasedElements(QCP::aePlottables | QCP::aeFills);
+  
+  std::printf("%d points\n", n);
+  const Table table(20, QStringList() << "pixmap ms" << "rasterizer ms");
+  const double widths[] = {1, 2, 4};
+  for (int fill=0; fill<2; ++fill)
+  {
+    plot.graph(0)->setBrush(fill ? QBrush(QColor(0, 0, 255, 50)) : QBrush(Qt::NoBrush));
+    for (int w=0; w<3; ++w)
+    {
+      plot.graph(0)->setPen(QPen(QBrush(Qt::blue), widths[w]));
+      plot.setSoftwareRasterizer(false);
+      const double pixmapMs = averageReplotMs(&plot, 10);
+      plot.setSoftwareRasterizer(true);
+      const double rasterizerMs = averageReplotMs(&plot, 10);
+      const QString name = QString("width %1%2").arg(widths[w]).arg(fill ? " (fill)" : "");
+      table.printRow(name, QVector<double>() << pixmapMs << rasterizerMs);
+    }
+  }
+  
+  return 0;
+}
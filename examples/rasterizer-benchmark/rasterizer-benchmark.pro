@@ -0,0 +1,5 @@
+TARGET = rasterizer-benchmark
+include(../benchmark-common/benchmark.pri)
+
+SOURCES += \
+        main.cpp
@@ -0,0 +1,88 @@
+/***************************************************************************
+**                                                                        **
+**  QCustomPlot, an easy to use, modern plotting widget for Qt            **
+**  Copyright (C) 2011-2022 Emanuel Eichhammer                            **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************/
+
+/*
+  Compares drawing scatters shape by shape with blitting cached sprites (QCP::phCacheScatters)
+  for all scatter shapes.
+  
+  Usage: scatter-benchmark [point count]
+*/
+
+#include <QApplication>
+#include <cstdlib>
+#include "benchmarkutil.h"
+
+using namespace benchmark;
+
+int main(int argc, char *argv[])
+{
+  QApplication a(argc, argv);
+  int n;
+  if (!readSizeArgument(argc, argv, 100000, "point count", n))
+    return 1;
+  
+  // scatter points spread randomly over the axis rect, so scatters don't share pixel positions:
+  QVector<double> keys(n), values(n);
+  for (int i=0; i<n; ++i)
+  {
+    keys[i] = i;
+    values[i] = std::rand()/double(RAND_MAX);
+  }
+  
+  QCustomPlot plot;
+  setupPlot(&plot);
+  plot.addGraph();
+  plot.graph(0)->setData(keys, values, true);
+  plot.graph(0)->setLineStyle(QCPGraph::lsNone);
+  plot.graph(0)->setAdaptiveSampling(false);
+  plot.graph(0)->setPen(QPen(Qt::blue));
+  plot.graph(0)->rescaleAxes();
+  
+  QPainterPath customPath;
+  customPath.addRect(-3, -1, 6, 2);
+  QPixmap pixmap(7, 7);
+  pixmap.fill(Qt::red);
+  
+  std::printf("%d points\n", n);
+  const Table table(20, QStringList() << "shapes ms" << "sprites ms");
+  const QMetaEnum shapeEnum = QCPScatterStyle::staticMetaObject.enumerator(QCPScatterStyle::staticMetaObject.indexOfEnumerator("ScatterShape"));
+  for (int shape=QCPScatterStyle::ssDot; shape<=QCPScatterStyle::ssCustom; ++shape)
+  {
+    QCPScatterStyle style(QCPScatterStyle::ScatterShape(shape), QPen(Qt::blue), QBrush(QColor(255, 200, 0)), 8);
+    if (shape == QCPScatterStyle::ssPixmap)
+      style.setPixmap(pixmap);
+    else if (shape == QCPScatterStyle::ssCustom)
+      style.setCustomPath(customPath);
+    plot.graph(0)->setScatterStyle(style);
+    
+    for (int antialiased=0; antialiased<2; ++antialiased)
+    {
+      plot.setAntialiasedElement(QCP::aeScatters, antialiased);
+      plot.setPlottingHint(QCP::phCacheScatters, false);
+      const double shapesMs = averageReplotMs(&plot, 10);
+      plot.setPlottingHint(QCP::phCacheScatters, true);
+      const double spritesMs = averageReplotMs(&plot, 10); // the warm-up replot renders the sprites
+      const QString name = QString("%1%2").arg(shapeEnum.valueToKey(shape)).arg(antialiased ? " (aa)" : "");
+      table.printRow(name, QVector<double>() << shapesMs << spritesMs);
+    }
+  }
+  
+  return 0;
+}
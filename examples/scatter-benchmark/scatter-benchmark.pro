@@ -0,0 +1,5 @@
+TARGET = scatter-benchmark
+include(../benchmark-common/benchmark.pri)
+
+SOURCES += \
+        main.cpp
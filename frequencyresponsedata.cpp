@@ -0,0 +1,378 @@
+#include "frequencyresponsedata.h"
+#include <QFile>
+#include <QThread>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+// Describes how the value columns of a data file are interpreted
+enum class ValueFormat { DecibelAngle, MagnitudeAngle, RealImaginary };
+
+// Holds the format of a data file, the frequency scale converts the frequency column to rad/s
+struct FileFormat
+{
+    double frequencyScale = 1.0;
+    ValueFormat valueFormat = ValueFormat::DecibelAngle;
+    bool touchstone = false;
+};
+
+// Holds one row of the data file as it was read
+struct Sample
+{
+    double frequency;
+    double value1;
+    double value2;
+};
+
+// Holds a part of the mapped file that is parsed by one thread, split at line boundaries
+struct Chunk
+{
+    const char *begin;
+    const char *end;
+    QVector<Sample> samples;
+    int lineCount = 0;
+    int errorLine = -1;
+    int maxColumnCount = 0;
+};
+
+// Checks if a character separates the columns of a row (CSV, semicolon separated and Touchstone files)
+inline bool isSeparator(char c)
+{
+    return c == ' ' || c == '\t' || c == ',' || c == ';' || c == '\r';
+}
+
+// Returns the end of the line starting at p, which is either the next line feed or the end of the buffer
+inline const char *findLineEnd(const char *p, const char *end)
+{
+    const char *lineEnd = static_cast<const char *>(std::memchr(p, '\n', end - p));
+    return lineEnd ? lineEnd : end;
+}
+
+// Parses the next number of a row without allocating and advances p behind it
+bool parseNumber(const char *&p, const char *lineEnd, double &value)
+{
+    while (p < lineEnd && isSeparator(*p)) {
+        ++p;
+    }
+
+    // std::from_chars doesn't accept an explicit plus sign
+    if (p < lineEnd && *p == '+') {
+        ++p;
+    }
+
+    std::from_chars_result result = std::from_chars(p, lineEnd, value);
+    if (result.ec != std::errc() || result.ptr == p) {
+        return false;
+    }
+
+    // The number has to be followed by a separator, an inline comment or the end of the line
+    p = result.ptr;
+    return p == lineEnd || isSeparator(*p) || *p == '!';
+}
+
+// Parses all rows of a chunk, skips comments and empty rows and records the first invalid row
+// Only the first three columns are used, further columns (e.g. S21, S12 and S22 of a S2P file) are counted to report them
+void parseChunk(Chunk &chunk)
+{
+    chunk.samples.reserve(int((chunk.end - chunk.begin) / 24));
+
+    const char *p = chunk.begin;
+    while (p < chunk.end) {
+        const char *lineEnd = findLineEnd(p, chunk.end);
+        ++chunk.lineCount;
+
+        while (p < lineEnd && isSeparator(*p)) {
+            ++p;
+        }
+
+        if (p < lineEnd && *p != '!' && *p != '#') {
+            Sample sample;
+            if (parseNumber(p, lineEnd, sample.frequency) && parseNumber(p, lineEnd, sample.value1) &&
+                parseNumber(p, lineEnd, sample.value2)) {
+                chunk.samples.append(sample);
+                int columnCount = 3;
+                double extraValue;
+                while (parseNumber(p, lineEnd, extraValue)) {
+                    ++columnCount;
+                }
+                chunk.maxColumnCount = std::max(chunk.maxColumnCount, columnCount);
+            } else if (chunk.errorLine < 0) {
+                chunk.errorLine = chunk.lineCount;
+            }
+        }
+
+        p = lineEnd + 1;
+    }
+}
+
+// Reads the options of a Touchstone option line, e.g. "# HZ S DB R 50"
+void parseOptionLine(const QByteArray &line, FileFormat &format)
+{
+    // Touchstone files default to GHz and magnitude-angle values
+    format.touchstone = true;
+    format.frequencyScale = 2 * M_PI * 1e9;
+    format.valueFormat = ValueFormat::MagnitudeAngle;
+
+    const QList<QByteArray> options = line.simplified().toUpper().split(' ');
+    for (const QByteArray &option : options) {
+        if (option == "HZ") {
+            format.frequencyScale = 2 * M_PI;
+        } else if (option == "KHZ") {
+            format.frequencyScale = 2 * M_PI * 1e3;
+        } else if (option == "MHZ") {
+            format.frequencyScale = 2 * M_PI * 1e6;
+        } else if (option == "GHZ") {
+            format.frequencyScale = 2 * M_PI * 1e9;
+        } else if (option == "DB") {
+            format.valueFormat = ValueFormat::DecibelAngle;
+        } else if (option == "MA") {
+            format.valueFormat = ValueFormat::MagnitudeAngle;
+        } else if (option == "RI") {
+            format.valueFormat = ValueFormat::RealImaginary;
+        }
+    }
+}
+
+// Searches for the first crossing of the given level in the data and interpolates the value of the other data at this point
+bool findCrossing(const QCPGraphDataContainer &data, double level, const QCPGraphDataContainer &other, double &otherValue)
+{
+    const int count = std::min(data.size(), other.size());
+    for (int i = 1; i < count; ++i) {
+        double before = data.at(i - 1)->value - level;
+        double after = data.at(i)->value - level;
+
+        if (before == 0 || before * after < 0) {
+            double t = (before == after) ? 0 : before / (before - after);
+            double otherBefore = other.at(i - 1)->value;
+            double otherAfter = other.at(i)->value;
+            otherValue = otherBefore + t * (otherAfter - otherBefore);
+            return true;
+        }
+    }
+    return false;
+}
+
+}
+
+// Constructor for the FrequencyResponseData class, initializes empty magnitude and phase data containers
+FrequencyResponseData::FrequencyResponseData()
+    : magnitude(new QCPGraphDataContainer), phase(new QCPGraphDataContainer)
+{
+}
+
+// Loads measured data with the columns frequency, magnitude and phase
+// CSV files are interpreted as frequency in rad/s, magnitude in dB and phase in °,
+// Touchstone files are interpreted according to their option line (frequency unit and DB, MA or RI values)
+bool FrequencyResponseData::load(const QString &fileName)
+{
+    lastWarning.clear();
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        lastError = file.errorString();
+        return false;
+    }
+
+    // Maps the file into memory so that the threads parse it without copying, QFile unmaps it when it's destroyed
+    const qint64 fileSize = file.size();
+    if (fileSize <= 0) {
+        lastError = "Die Datei enthält keine Messdaten.";
+        return false;
+    }
+    const char *data = reinterpret_cast<const char *>(file.map(0, fileSize));
+    if (!data) {
+        lastError = file.errorString();
+        return false;
+    }
+    const char *end = data + fileSize;
+
+    // Reads the header lines (comments, Touchstone option line and CSV column titles) up to the first data row
+    FileFormat format;
+    int headerLines = 0;
+    const char *p = data;
+    while (p < end) {
+        const char *lineEnd = findLineEnd(p, end);
+        const char *first = p;
+        while (first < lineEnd && isSeparator(*first)) {
+            ++first;
+        }
+
+        if (first < lineEnd && *first == '#') {
+            parseOptionLine(QByteArray(first + 1, int(lineEnd - first - 1)), format);
+        } else if (first < lineEnd && *first != '!' &&
+                   (std::isdigit(static_cast<unsigned char>(*first)) || *first == '+' || *first == '-' || *first == '.')) {
+            break;
+        }
+
+        ++headerLines;
+        p = std::min(lineEnd + 1, end);
+    }
+
+    // Splits the remaining data into chunks at line boundaries, using one chunk per thread but at least 1 MiB per chunk
+    const qint64 dataSize = end - p;
+    const int chunkCount = int(qBound<qint64>(1, dataSize / (1 << 20), QThread::idealThreadCount()));
+    QVector<Chunk> chunks;
+    chunks.reserve(chunkCount);
+    const char *chunkBegin = p;
+    for (int i = 1; i <= chunkCount && chunkBegin < end; ++i) {
+        const char *chunkEnd = end;
+        if (i < chunkCount) {
+            chunkEnd = std::max(chunkBegin, p + dataSize * i / chunkCount);
+            chunkEnd = std::min(findLineEnd(chunkEnd, end) + 1, end);
+        }
+
+        Chunk chunk;
+        chunk.begin = chunkBegin;
+        chunk.end = chunkEnd;
+        chunks.append(chunk);
+        chunkBegin = chunkEnd;
+    }
+
+    // Parses the chunks in parallel
+    QtConcurrent::blockingMap(chunks, parseChunk);
+
+    // Merges the chunks in file order and reports the first invalid row with its line number in the file
+    QVector<Sample> samples;
+    int sampleCount = 0;
+    for (const Chunk &chunk : chunks) {
+        sampleCount += chunk.samples.size();
+    }
+    samples.reserve(sampleCount);
+
+    int lineOffset = headerLines;
+    int columnCount = 0;
+    for (const Chunk &chunk : chunks) {
+        if (chunk.errorLine >= 0) {
+            lastError = QString("Ungültige Daten in Zeile %1.").arg(lineOffset + chunk.errorLine);
+            return false;
+        }
+        samples += chunk.samples;
+        lineOffset += chunk.lineCount;
+        columnCount = std::max(columnCount, chunk.maxColumnCount);
+    }
+
+    if (samples.isEmpty()) {
+        lastError = "Die Datei enthält keine Messdaten.";
+        return false;
+    }
+
+    // Rejects data that can't be shown on the logarithmic frequency axis and reports rows that are only partly shown
+    int invalidFrequencyCount = 0;
+    for (const Sample &sample : samples) {
+        if (!(sample.frequency > 0 && std::isfinite(sample.frequency))) {
+            ++invalidFrequencyCount;
+        }
+    }
+    if (invalidFrequencyCount == samples.size()) {
+        lastError = "Die Datei enthält keine Messpunkte mit positiver Frequenz.";
+        return false;
+    }
+
+    // Sorts the samples by frequency, because the phase unwrapping requires ascending frequencies
+    if (!std::is_sorted(samples.constBegin(), samples.constEnd(),
+                        [](const Sample &a, const Sample &b) { return a.frequency < b.frequency; })) {
+        std::stable_sort(samples.begin(), samples.end(),
+                         [](const Sample &a, const Sample &b) { return a.frequency < b.frequency; });
+    }
+
+    // Converts the samples to frequency in rad/s, magnitude in dB and phase in °
+    QVector<QCPGraphData> magnitudePoints;
+    QVector<QCPGraphData> phasePoints;
+    magnitudePoints.reserve(samples.size());
+    phasePoints.reserve(samples.size());
+    double lastUnwrappedPhase = 0.0;
+    int invalidValueCount = 0;
+
+    for (int i = 0; i < samples.size(); ++i) {
+        const Sample &sample = samples.at(i);
+        double w = sample.frequency * format.frequencyScale;
+        double magnitudeDb = 0.0;
+        double unwrappedPhase = 0.0;
+
+        switch (format.valueFormat) {
+        case ValueFormat::DecibelAngle:
+            magnitudeDb = sample.value1;
+            unwrappedPhase = sample.value2;
+            break;
+        case ValueFormat::MagnitudeAngle:
+            magnitudeDb = 20 * std::log10(sample.value1);
+            unwrappedPhase = sample.value2;
+            break;
+        case ValueFormat::RealImaginary:
+            magnitudeDb = 20 * std::log10(std::hypot(sample.value1, sample.value2));
+            unwrappedPhase = std::atan2(sample.value2, sample.value1) * 180 / M_PI;
+            break;
+        }
+
+        // Skips samples whose magnitude can't be shown in dB, e.g. a magnitude of 0 (-inf dB) or a negative linear magnitude
+        if (!std::isfinite(magnitudeDb) || !std::isfinite(unwrappedPhase)) {
+            ++invalidValueCount;
+            continue;
+        }
+
+        // Unwraps phase jumps so that the phase reaches values of more than 180° and less than -180°
+        if (!phasePoints.isEmpty()) {
+            double phaseDifference = unwrappedPhase - lastUnwrappedPhase;
+            if (phaseDifference > 180) {
+                unwrappedPhase -= 360 * std::ceil((phaseDifference - 180) / 360);
+            } else if (phaseDifference < -180) {
+                unwrappedPhase += 360 * std::ceil((std::abs(phaseDifference) - 180) / 360);
+            }
+        }
+        lastUnwrappedPhase = unwrappedPhase;
+
+        magnitudePoints.append(QCPGraphData(w, magnitudeDb));
+        phasePoints.append(QCPGraphData(w, unwrappedPhase));
+    }
+
+    if (magnitudePoints.isEmpty()) {
+        lastError = "Die Datei enthält keine Messpunkte mit gültigem Betrag und gültiger Phase.";
+        return false;
+    }
+
+    QStringList warnings;
+    if (columnCount > 3) {
+        warnings << QString("Die Datei enthält %1 Datenspalten, übernommen wurden nur die ersten drei (%2).")
+                    .arg(columnCount).arg(format.touchstone ? "Frequenz und S11" : "Frequenz, Betrag und Phase");
+    }
+    if (invalidFrequencyCount > 0) {
+        warnings << QString("%1 Messpunkte ohne positive Frequenz können nicht angezeigt werden.").arg(invalidFrequencyCount);
+    }
+    if (invalidValueCount > 0) {
+        warnings << QString("%1 Messpunkte mit Betrag 0, negativem Betrag oder ungültiger Phase wurden übersprungen.").arg(invalidValueCount);
+    }
+    lastWarning = warnings.join("\n");
+
+    // Fills the data containers, which are shared with the graphs of the bode plots
+    magnitude->set(magnitudePoints, true);
+    phase->set(phasePoints, true);
+    lastError.clear();
+    return true;
+}
+
+// Calculates the gain margin from the measured magnitude at the first phase crossover (where the phase crosses -180°)
+double FrequencyResponseData::calculateGainMargin() const
+{
+    double magnitudeAtPhaseCrossover;
+    if (findCrossing(*phase, -180, *magnitude, magnitudeAtPhaseCrossover)) {
+        return -magnitudeAtPhaseCrossover;
+    } else {
+        return std::numeric_limits<double>::infinity();
+    }
+}
+
+// Calculates the phase margin from the measured phase at the first gain crossover (where the magnitude crosses 0 dB)
+double FrequencyResponseData::calculatePhaseMargin() const
+{
+    double phaseAtGainCrossover;
+    if (findCrossing(*magnitude, 0, *phase, phaseAtGainCrossover)) {
+        return 180 + phaseAtGainCrossover;
+    } else {
+        return std::numeric_limits<double>::infinity();
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef FREQUENCYRESPONSEDATA_H
+#define FREQUENCYRESPONSEDATA_H
+
+#include <QString>
+#include <QSharedPointer>
+#include "qcustomplot.h"
+
+// The FrequencyResponseData class imports measured frequency response data (FRD) from CSV or Touchstone-like files
+// and provides the magnitude and phase responses as data containers for the bode plots
+class FrequencyResponseData
+{
+public:
+    // Initializes empty magnitude and phase data containers
+    FrequencyResponseData();
+
+    // Loads the measured data from a file and returns false if the file could not be read or parsed
+    bool load(const QString &fileName);
+
+    // Returns a description of the last error that occurred while loading
+    QString errorString() const { return lastError; }
+
+    // Returns a notice about data of the last successfully loaded file that was not imported, or an empty string
+    QString warningString() const { return lastWarning; }
+
+    // Returns the magnitude response in dB and the phase response in ° over the frequency in rad/s
+    QSharedPointer<QCPGraphDataContainer> magnitudeData() const { return magnitude; }
+    QSharedPointer<QCPGraphDataContainer> phaseData() const { return phase; }
+
+    // Returns whether no measured data points are available
+    bool isEmpty() const { return magnitude->isEmpty(); }
+
+    // Calculates the gain margin and the phase margin from the measured data
+    double calculateGainMargin() const;
+    double calculatePhaseMargin() const;
+
+private:
+    // Stores the measured magnitude and phase responses
+    QSharedPointer<QCPGraphDataContainer> magnitude;
+    QSharedPointer<QCPGraphDataContainer> phase;
+
+    // Stores the description of the last loading error and the notice about skipped data of the last loaded file
+    QString lastError;
+    QString lastWarning;
+};
+
+#endif
@@ -0,0 +1,193 @@
+#include "frequencysweepprovider.h"
+#include <QFutureWatcher>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Number of points per tile, a tile of level L covers 2^-L decades
+const int pointsPerTile = 64;
+
+// Highest resolution level, which limits the density to 64 * 2^40 points per decade
+const int maxLevel = 40;
+
+// Number of cached tiles, i.e. about 260000 points per graph, above which the tiles outside the requested range are evicted
+const int maxCachedTiles = 4096;
+
+// Removes the points at the given frequencies, which are sorted ascending, from the container in a single pass
+void removePoints(QCPGraphDataContainer &data, const std::vector<double> &frequencies)
+{
+    QVector<QCPGraphData> keptPoints;
+    keptPoints.reserve(data.size());
+    std::vector<double>::const_iterator frequency = frequencies.begin();
+    for (QCPGraphDataContainer::const_iterator it = data.constBegin(); it != data.constEnd(); ++it) {
+        while (frequency != frequencies.end() && *frequency < it->key) {
+            ++frequency;
+        }
+        if (frequency == frequencies.end() || *frequency != it->key) {
+            keptPoints.append(*it);
+        }
+    }
+    data.set(keptPoints, true);
+}
+
+}
+
+// Constructor for the FrequencySweepProvider class
+FrequencySweepProvider::FrequencySweepProvider(QObject *parent)
+    : QObject(parent)
+{
+}
+
+// Sets the transfer function and determines the phase offset from the first plotted point, all tiles computed before are forgotten
+void FrequencySweepProvider::setTransferFunction(const TransferFunction &transferFunction, QSharedPointer<QCPGraphDataContainer> magnitude,
+                                                 QSharedPointer<QCPGraphDataContainer> phase)
+{
+    clear();
+    model = std::make_shared<const TransferFunction>(transferFunction);
+    magnitudeData = magnitude;
+    phaseData = phase;
+    if (!phase->isEmpty()) {
+        phaseOffset = phase->constBegin()->value - model->continuousPhase(phase->constBegin()->key);
+    }
+}
+
+// Discards the transfer function and all pending results
+void FrequencySweepProvider::clear()
+{
+    ++generation;
+    model.reset();
+    magnitudeData.clear();
+    phaseData.clear();
+    phaseOffset = 0.0;
+    requestedTiles.clear();
+}
+
+// Chooses the level whose tiles hold at least one point per pixel and requests the missing tiles of the visible range,
+// extended by half the visible decades on both sides, so that panning finds the data already computed
+// If too many tiles are cached afterwards, all tiles outside this extended range are evicted
+void FrequencySweepProvider::requestRange(const QCPRange &range, int pixelWidth)
+{
+    if (!model || range.lower <= 0 || pixelWidth <= 0) {
+        return;
+    }
+
+    double logLower = std::log10(range.lower);
+    double logUpper = std::log10(range.upper);
+    double decades = logUpper - logLower;
+    if (!(decades > 0)) {
+        return;
+    }
+    double pointsPerDecade = pixelWidth / decades;
+    int level = qBound(0, int(std::ceil(std::log2(pointsPerDecade / pointsPerTile))), maxLevel);
+    double tilesPerDecade = std::ldexp(1.0, level);
+
+    qint64 firstIndex = qint64(std::floor((logLower - decades / 2) * tilesPerDecade));
+    qint64 lastIndex = qint64(std::floor((logUpper + decades / 2) * tilesPerDecade));
+    QVector<Tile> tiles;
+    QSet<Tile> rangeTiles;
+    for (qint64 index = firstIndex; index <= lastIndex; ++index) {
+        Tile tile(level, index);
+        rangeTiles.insert(tile);
+        if (!requestedTiles.contains(tile)) {
+            requestedTiles.insert(tile);
+            tiles.append(tile);
+        }
+    }
+    if (requestedTiles.size() > maxCachedTiles) {
+        evictTiles(rangeTiles);
+    }
+    if (tiles.isEmpty()) {
+        return;
+    }
+
+    // Computes the tiles in the background and merges them in the GUI thread, because the graphs read the containers while drawing
+    QFutureWatcher<SweepResult> *watcher = new QFutureWatcher<SweepResult>(this);
+    connect(watcher, &QFutureWatcher<SweepResult>::finished, this, [this, watcher]() {
+        mergeResult(watcher->result());
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run(&FrequencySweepProvider::computeTiles, model, phaseOffset, tiles, generation));
+}
+
+// Evaluates the transfer function at the points of each tile, which lie in the middle of equal logarithmic steps, so that the
+// points of different levels never coincide
+// The phase takes the branch of arg(H(jw)) that is closest to the continuous phase, so the tiles connect to the plotted phase
+FrequencySweepProvider::SweepResult FrequencySweepProvider::computeTiles(std::shared_ptr<const TransferFunction> transferFunction,
+                                                                         double phaseOffset, QVector<Tile> tiles, quint64 generation)
+{
+    std::sort(tiles.begin(), tiles.end(), [](const Tile &a, const Tile &b) { return a.second < b.second; });
+
+    SweepResult result;
+    result.generation = generation;
+    result.tiles = tiles;
+    result.magnitude.reserve(tiles.size() * pointsPerTile);
+    result.phase.reserve(tiles.size() * pointsPerTile);
+    for (const Tile &tile : tiles) {
+        for (int i = 0; i < pointsPerTile; ++i) {
+            double w = tileFrequency(tile, i);
+            std::complex<double> H = transferFunction->evaluate(w);
+            double phase = std::arg(H) * 180 / M_PI;
+            double referencePhase = transferFunction->continuousPhase(w) + phaseOffset;
+            phase += 360 * std::round((referencePhase - phase) / 360);
+
+            result.magnitude.append(QCPGraphData(w, 20 * std::log10(std::abs(H))));
+            result.phase.append(QCPGraphData(w, phase));
+        }
+    }
+    return result;
+}
+
+// Merges the sorted points into the containers, which are shared with the graphs, and notifies the plots
+void FrequencySweepProvider::mergeResult(const SweepResult &result)
+{
+    if (result.generation != generation || !magnitudeData || !phaseData) {
+        return;
+    }
+
+    QVector<QCPGraphData> magnitude, phase;
+    magnitude.reserve(result.magnitude.size());
+    phase.reserve(result.phase.size());
+    for (int i = 0; i < result.tiles.size(); ++i) {
+        if (requestedTiles.contains(result.tiles.at(i))) {
+            magnitude += result.magnitude.mid(i * pointsPerTile, pointsPerTile);
+            phase += result.phase.mid(i * pointsPerTile, pointsPerTile);
+        }
+    }
+    if (magnitude.isEmpty()) {
+        return;
+    }
+    magnitudeData->add(magnitude, true);
+    phaseData->add(phase, true);
+    emit dataMerged();
+}
+
+// Removes the points of all evicted tiles from the containers in one pass, pending tiles are skipped when their results arrive
+void FrequencySweepProvider::evictTiles(const QSet<Tile> &keptTiles)
+{
+    std::vector<double> evictedFrequencies;
+    for (QSet<Tile>::iterator it = requestedTiles.begin(); it != requestedTiles.end();) {
+        if (keptTiles.contains(*it)) {
+            ++it;
+            continue;
+        }
+        for (int i = 0; i < pointsPerTile; ++i) {
+            evictedFrequencies.push_back(tileFrequency(*it, i));
+        }
+        it = requestedTiles.erase(it);
+    }
+    if (evictedFrequencies.empty() || !magnitudeData || !phaseData) {
+        return;
+    }
+    std::sort(evictedFrequencies.begin(), evictedFrequencies.end());
+    removePoints(*magnitudeData, evictedFrequencies);
+    removePoints(*phaseData, evictedFrequencies);
+}
+
+// Places the points of a tile in the middle of equal logarithmic steps, a tile of level L covers 2^-L decades
+double FrequencySweepProvider::tileFrequency(const Tile &tile, int point)
+{
+    double tileWidth = std::ldexp(1.0, -tile.first);
+    return std::pow(10, (tile.second + (point + 0.5) / pointsPerTile) * tileWidth);
+}
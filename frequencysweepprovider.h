@@ -0,0 +1,86 @@
+#ifndef FREQUENCYSWEEPPROVIDER_H
+#define FREQUENCYSWEEPPROVIDER_H
+
+#include <QObject>
+#include <QPair>
+#include <QSet>
+#include <QSharedPointer>
+#include <QVector>
+#include <memory>
+#include "qcustomplot.h"
+#include "transferfunction.h"
+
+// The FrequencySweepProvider class extends the plotted magnitude and phase of a transfer function on demand, so that zooming in
+// shows more detail and panning beyond the computed frequencies shows the response there
+// The frequency axis is divided into tiles of fixed logarithmic width per resolution level, a tile holds a fixed number of points
+// Each visible range request computes only the tiles that are neither computed nor pending at a density of about one point per
+// pixel, in the background, and merges their points into the data containers of the graphs
+// Once more tiles are cached than a fixed limit, the tiles outside the current request are evicted with their points
+class FrequencySweepProvider : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Creates a provider without a transfer function
+    explicit FrequencySweepProvider(QObject *parent = nullptr);
+
+    // Sets the transfer function and the data containers of its plotted magnitude and phase, which are extended on demand
+    // The phase container must already hold the unwrapped phase, because new points continue its phase branch
+    void setTransferFunction(const TransferFunction &transferFunction, QSharedPointer<QCPGraphDataContainer> magnitude,
+                             QSharedPointer<QCPGraphDataContainer> phase);
+
+    // Removes the transfer function, so that no more data is computed and pending results are discarded
+    void clear();
+
+    // Requests the data for the visible frequency range at the resolution of an axis rect that is pixelWidth pixels wide
+    void requestRange(const QCPRange &range, int pixelWidth);
+
+signals:
+    // Is emitted after computed points were merged into the data containers, so that the plots can be replotted
+    void dataMerged();
+
+private:
+    // Identifies a tile by its resolution level and its index on the logarithmic frequency axis
+    typedef QPair<int, qint64> Tile;
+
+    // Holds the points computed for a number of tiles in ascending frequency order, pointsPerTile points per tile
+    struct SweepResult
+    {
+        quint64 generation = 0;
+        QVector<Tile> tiles;
+        QVector<QCPGraphData> magnitude;
+        QVector<QCPGraphData> phase;
+    };
+
+    // Computes the magnitude and phase of the tiles, runs in a thread of the global thread pool
+    static SweepResult computeTiles(std::shared_ptr<const TransferFunction> transferFunction, double phaseOffset,
+                                    QVector<Tile> tiles, quint64 generation);
+
+    // Merges the result into the data containers, unless the transfer function changed in the meantime
+    // Points of tiles that were evicted while they were computed are skipped
+    void mergeResult(const SweepResult &result);
+
+    // Forgets all tiles except the given ones and removes their points from the data containers
+    void evictTiles(const QSet<Tile> &keptTiles);
+
+    // Returns the frequency in rad/s of a point of a tile, which is computed the same way for evaluating and evicting it
+    static double tileFrequency(const Tile &tile, int point);
+
+    // Holds the transfer function, which is shared with the running computations
+    std::shared_ptr<const TransferFunction> model;
+
+    // Holds the data containers of the plotted magnitude and phase
+    QSharedPointer<QCPGraphDataContainer> magnitudeData;
+    QSharedPointer<QCPGraphDataContainer> phaseData;
+
+    // Holds the difference between the plotted phase and the continuous phase of the transfer function
+    double phaseOffset = 0.0;
+
+    // Holds the tiles that are computed or pending for the current transfer function
+    QSet<Tile> requestedTiles;
+
+    // Counts the transfer functions, so that results for a previous one are discarded
+    quint64 generation = 0;
+};
+
+#endif
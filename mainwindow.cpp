@@ -5,6 +5,15 @@
 #include "exportbodeplot.h"
 #include <QFileDialog>
 
+// Formats a stability margin for display, handling infinity as a special case
+static QString formatMargin(double margin, const QString &unit)
+{
+    if (std::isinf(margin)) {
+        return "unendlich";
+    }
+    return QString::number(margin, 'f', 2) + unit;
+}
+
 // Constructor for the MainWindow
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -16,12 +25,38 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->numeratorInput, &QLineEdit::textChanged, this, &MainWindow::updateTransferFunctionDisplay);
     connect(ui->denominatorInput, &QLineEdit::textChanged, this, &MainWindow::updateTransferFunctionDisplay);
 
+    // Populates the combo box with the display forms of the transfer function and updates the display when it changes
+    ui->displayFormComboBox->addItem("Polynom");
+    ui->displayFormComboBox->addItem("Faktorisiert");
+    ui->displayFormComboBox->addItem("Pol-Nullstellen");
+    connect(ui->displayFormComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::updateTransferFunctionDisplay);
+
     // Plots the bode plot when the 'Start' button is clicked
     connect(ui->plotButton, &QPushButton::clicked, this, &MainWindow::plotBode);
 
     // Initializes the ExportBodePlot class for exporting the magnitude and phase plots
     exporter = new ExportBodePlot(ui->magnitudePlot, ui->phasePlot);
 
+    // Creates the cursor with readouts, which follows the mouse on both plots
+    cursor = new BodeCursor(ui->magnitudePlot, ui->phasePlot, this);
+
+    // Allows zooming and dragging the frequency axis and links the frequency axes of both plots
+    frequencyLink = new PlotLinker(this);
+    for (QCustomPlot *plot : {ui->magnitudePlot, ui->phasePlot}) {
+        plot->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom);
+        plot->axisRect()->setRangeDrag(Qt::Horizontal);
+        plot->axisRect()->setRangeZoom(Qt::Horizontal);
+        frequencyLink->addAxis(plot->xAxis);
+    }
+    connect(frequencyLink, &PlotLinker::rangeChanged, this, &MainWindow::onFrequencyRangeChanged);
+
+    // Replots both plots after the sweep provider merged new points into the transfer function graphs
+    sweepProvider = new FrequencySweepProvider(this);
+    connect(sweepProvider, &FrequencySweepProvider::dataMerged, this, [this]() {
+        ui->magnitudePlot->replot(QCustomPlot::rpQueuedReplot);
+        ui->phasePlot->replot(QCustomPlot::rpQueuedReplot);
+    });
+
     // Populates the combo box with available export formats
     ui->exportComboBox->addItem("PNG");
     ui->exportComboBox->addItem("JPG");
@@ -30,6 +65,9 @@ MainWindow::MainWindow(QWidget *parent)
 
     // Connects the 'Exportieren' button to the export function
     connect(ui->exportButton, &QPushButton::clicked, this, &MainWindow::onExportButtonClicked);
+
+    // Connects the 'Messdaten laden' button to the import function
+    connect(ui->importButton, &QPushButton::clicked, this, &MainWindow::onImportButtonClicked);
 }
 
 MainWindow::~MainWindow()
@@ -37,43 +75,49 @@ MainWindow::~MainWindow()
     delete ui;
 }
 
-// Helper function to parse the inputs of the coefficients from the QLineEdit field
-// Converts a comma-separated string into a vector of doubles representing the coefficients
-std::vector<double> MainWindow::parseInput(const QString &input)
+// Describes the position and reason of a parse error, the position is counted from 1 for the user
+QString MainWindow::describeParseError(const QString &name, const ParsedPolynomial &polynomial) const
+{
+    return QString("%1: Fehler an Position %2 (%3)").arg(name).arg(polynomial.errorPosition + 1).arg(polynomial.errorMessage);
+}
+
+// Updates the label of the numerator or denominator, skipping parsing and formatting if nothing changed since the last update
+void MainWindow::updatePolynomialLabel(QLabel *label, const QString &name, const QString &input, int displayForm, FormattedInput &cache)
 {
-    std::vector<double> coefficients;
-    QStringList coeffList = input.split(",");
-    for (const QString &coeffStr : coeffList) {
-        coefficients.push_back(coeffStr.toDouble());
+    if (cache.input == input && cache.displayForm == displayForm) {
+        return;
+    }
+    cache.input = input;
+    cache.displayForm = displayForm;
+
+    // Parses the input, which is either a coefficient list or an expression in s, and displays it or the position of an input error
+    ParsedPolynomial polynomial = PolynomialParser::parse(input);
+    if (polynomial.valid) {
+        label->setText(TransferFunction::formatPolynomial(polynomial, TransferFunction::DisplayForm(displayForm)));
+    } else {
+        label->setText(describeParseError(name, polynomial));
     }
-    return coefficients;
 }
 
 // Updates the display of the transfer function based on the numerator and denominator inputs
 void MainWindow::updateTransferFunctionDisplay()
 {
-    // Gets inputs from the user interface
-    QString numeratorInput = ui->numeratorInput->text();
-    QString denominatorInput = ui->denominatorInput->text();
-
-    // Parses the inputs and creates the transfer function object
-    std::vector<double> numerator = parseInput(numeratorInput);
-    std::vector<double> denominator = parseInput(denominatorInput);
-    TransferFunction tf(numerator, denominator);
-
-    // Updates the labels to display the formatted numerator and denominator
-    ui->numeratorLabel->setText(tf.getFormattedNumerator());
-    ui->denominatorLabel->setText(tf.getFormattedDenominator());
+    int displayForm = qMax(0, ui->displayFormComboBox->currentIndex());
+    updatePolynomialLabel(ui->numeratorLabel, "Zähler", ui->numeratorInput->text(), displayForm, numeratorDisplay);
+    updatePolynomialLabel(ui->denominatorLabel, "Nenner", ui->denominatorInput->text(), displayForm, denominatorDisplay);
 }
 
 // Generates and displays the bode plot for the transfer function with the specified frequency range
 void MainWindow::plotBode()
 {
-    // Retrieves the numerator and denominator inputs
-    QString numeratorInput = ui->numeratorInput->text();
-    QString denominatorInput = ui->denominatorInput->text();
-    std::vector<double> numerator = parseInput(numeratorInput);
-    std::vector<double> denominator = parseInput(denominatorInput);
+    // Retrieves and validates the numerator and denominator inputs
+    ParsedPolynomial numerator = PolynomialParser::parse(ui->numeratorInput->text());
+    ParsedPolynomial denominator = PolynomialParser::parse(ui->denominatorInput->text());
+    if (!numerator.valid || !denominator.valid) {
+        QMessageBox::warning(this, "Falsche Eingabe", !numerator.valid ? describeParseError("Zähler", numerator)
+                                                                       : describeParseError("Nenner", denominator));
+        return;
+    }
 
     // Gets and validates the frequency range from the user input
     bool okMin, okMax;
@@ -99,22 +143,69 @@ void MainWindow::plotBode()
     BodePlot bodePlot(ui->magnitudePlot, ui->phasePlot);
     bodePlot.plot(frequencies, magnitude, phase, xMin, xMax);
 
+    // Adds the measured frequency response on top of the model, if available
+    if (!measuredData.isEmpty()) {
+        bodePlot.plotMeasured(measuredData);
+    }
+
+    // Evaluates the readouts of the cursor exactly from the transfer function and extends its graphs when zooming and panning
+    cursor->setTransferFunction(tf);
+    sweepProvider->setTransferFunction(tf, ui->magnitudePlot->graph(0)->data(), ui->phasePlot->graph(0)->data());
+
     // Calculates and displays the phase margin and gain margin
     double phaseMargin = tf.calculatePhaseMargin();
     double gainMargin = tf.calculateGainMargin();
 
-    // Displays the phase margin, handling infinity as a special case
-    if (std::isinf(phaseMargin)) {
-        ui->phaseMarginLabel->setText("unendlich");
+    // Displays the phase margin and the gain margin, followed by the margins of the measured data if available
+    QString phaseMarginText = formatMargin(phaseMargin, "°");
+    QString gainMarginText = formatMargin(gainMargin, " dB");
+    if (!measuredData.isEmpty()) {
+        phaseMarginText += " (Messung: " + formatMargin(measuredData.calculatePhaseMargin(), "°") + ")";
+        gainMarginText += " (Messung: " + formatMargin(measuredData.calculateGainMargin(), " dB") + ")";
+    }
+    ui->phaseMarginLabel->setText(phaseMarginText);
+    ui->gainMarginLabel->setText(gainMarginText);
+
+    // Adds the straight-line asymptotes and displays the bandwidth, the resonance peak and the corner frequencies
+    std::vector<double> asymptoteFrequencies, magnitudeAsymptote, phaseAsymptote;
+    tf.asymptoteData(asymptoteFrequencies, magnitudeAsymptote, phaseAsymptote, xMin, xMax);
+    bodePlot.plotAsymptotes(asymptoteFrequencies, magnitudeAsymptote, phaseAsymptote);
+
+    FrequencyCharacteristics characteristics = tf.frequencyCharacteristics();
+    if (characteristics.bandwidth > 0) {
+        ui->bandwidthLabel->setText(QString::number(characteristics.bandwidth, 'g', 3) + " rad/s");
+    } else {
+        ui->bandwidthLabel->setText("keine");
+    }
+    if (characteristics.resonanceFrequency > 0) {
+        ui->resonanceLabel->setText(QString("%1 dB bei %2 rad/s").arg(characteristics.resonancePeak, 0, 'f', 2)
+                                    .arg(characteristics.resonanceFrequency, 0, 'g', 3));
     } else {
-        ui->phaseMarginLabel->setText(QString::number(phaseMargin, 'f', 2) + "°");
+        ui->resonanceLabel->setText("keine");
     }
+    QStringList cornerFrequencies;
+    for (double frequency : characteristics.cornerFrequencies) {
+        cornerFrequencies << QString::number(frequency, 'g', 3);
+    }
+    ui->cornerFrequenciesLabel->setText(cornerFrequencies.isEmpty() ? "keine" : cornerFrequencies.join(", ") + " rad/s");
+
+    // Calculates the sensitivity functions of the closed loop, plots them and displays their peaks and the disk margin
+    std::vector<double> sensitivityFrequencies, sensitivity, complementarySensitivity;
+    SensitivityPeaks peaks = tf.sensitivityData(sensitivityFrequencies, sensitivity, complementarySensitivity);
+    bodePlot.plotSensitivity(sensitivityFrequencies, sensitivity, complementarySensitivity);
 
-    // Displays the gain margin, handling infinity as a special case
-    if (std::isinf(gainMargin)) {
-        ui->gainMarginLabel->setText("unendlich");
+    // The peaks and the disk margin are only meaningful if the closed loop itself is stable
+    if (peaks.closedLoopStable) {
+        ui->sensitivityPeakLabel->setText(QString("%1 bei %2 rad/s").arg(peaks.peakSensitivity, 0, 'f', 2)
+                                          .arg(peaks.peakSensitivityFrequency, 0, 'g', 3));
+        ui->complementaryPeakLabel->setText(QString("%1 bei %2 rad/s").arg(peaks.peakComplementarySensitivity, 0, 'f', 2)
+                                            .arg(peaks.peakComplementarySensitivityFrequency, 0, 'g', 3));
+        ui->diskMarginLabel->setText(QString("%1 (±%2, ±%3)").arg(peaks.diskMargin, 0, 'f', 2)
+                                     .arg(formatMargin(peaks.diskGainMargin, " dB"), formatMargin(peaks.diskPhaseMargin, "°")));
     } else {
-        ui->gainMarginLabel->setText(QString::number(gainMargin, 'f', 2) + " dB");
+        ui->sensitivityPeakLabel->setText("nicht verfügbar (Regelkreis instabil)");
+        ui->complementaryPeakLabel->setText("nicht verfügbar (Regelkreis instabil)");
+        ui->diskMarginLabel->setText("nicht verfügbar (Regelkreis instabil)");
     }
 
     // Determines the system stability based on the calculated margins and displays the result
@@ -150,6 +241,55 @@ void MainWindow::onExportButtonClicked()
         return;
     }
 
-    // Calls the export function to save the plot in the specified format
+    // Calls the export function to save the plot in the specified format, without the cursor
+    cursor->hide();
     exporter->exportPlot(selectedFormat, fileName);
 }
+
+// Opens a file dialog to import measured frequency response data and plots it together with the transfer function
+void MainWindow::onImportButtonClicked()
+{
+    QString fileName = QFileDialog::getOpenFileName(this, "Messdaten laden", "",
+                                                    "Messdaten (*.csv *.txt *.s1p *.s2p);;Alle Dateien (*)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    if (!measuredData.load(fileName)) {
+        QMessageBox::warning(this, "Falsche Eingabe", "Die Messdaten konnten nicht geladen werden: " + measuredData.errorString());
+        return;
+    }
+    if (!measuredData.warningString().isEmpty()) {
+        QMessageBox::information(this, "Messdaten", measuredData.warningString());
+    }
+
+    // Replots the transfer function together with the measured data if a transfer function was entered
+    if (!ui->numeratorInput->text().isEmpty() && !ui->denominatorInput->text().isEmpty()) {
+        plotBode();
+        return;
+    }
+
+    // Otherwise plots only the measured data and displays its margins
+    ui->magnitudePlot->clearGraphs();
+    ui->phasePlot->clearGraphs();
+    BodePlot bodePlot(ui->magnitudePlot, ui->phasePlot);
+    bodePlot.plotMeasured(measuredData);
+    cursor->clearTransferFunction();
+    sweepProvider->clear();
+
+    ui->phaseMarginLabel->setText(formatMargin(measuredData.calculatePhaseMargin(), "°") + " (Messung)");
+    ui->gainMarginLabel->setText(formatMargin(measuredData.calculateGainMargin(), " dB") + " (Messung)");
+    ui->stabilityLabel->clear();
+    ui->sensitivityPeakLabel->clear();
+    ui->complementaryPeakLabel->clear();
+    ui->diskMarginLabel->clear();
+    ui->bandwidthLabel->clear();
+    ui->resonanceLabel->clear();
+    ui->cornerFrequenciesLabel->clear();
+}
+
+// Requests the missing data at a density of about one point per pixel of the axis rect, the data arrives asynchronously
+void MainWindow::onFrequencyRangeChanged(const QCPRange &range)
+{
+    sweepProvider->requestRange(range, ui->magnitudePlot->axisRect()->width());
+}
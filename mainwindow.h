@@ -2,9 +2,15 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
+#include <QLabel>
 #include <vector>
 #include <QString>
 #include "exportbodeplot.h"
+#include "bodecursor.h"
+#include "plotlinker.h"
+#include "frequencysweepprovider.h"
+#include "frequencyresponsedata.h"
+#include "polynomialparser.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -32,15 +38,47 @@ private slots:
     // Initiates the export process for the bode plots
     void onExportButtonClicked();
 
+    // Imports measured frequency response data and shows it together with the bode plot
+    void onImportButtonClicked();
+
+    // Requests the data of the transfer function that is missing for the visible frequency range
+    void onFrequencyRangeChanged(const QCPRange &range);
+
 private:
-    // Converts a comma-separated string into a vector of coefficients
-    std::vector<double> parseInput(const QString &input);
+    // Describes a parse error of the numerator or denominator input for display
+    QString describeParseError(const QString &name, const ParsedPolynomial &polynomial) const;
+
+    // Holds the input and display form that a numerator or denominator label was last formatted for
+    struct FormattedInput
+    {
+        QString input;
+        int displayForm = -1;
+    };
+
+    // Parses and formats one half of the transfer function, but only if its input or the display form changed
+    void updatePolynomialLabel(QLabel *label, const QString &name, const QString &input, int displayForm, FormattedInput &cache);
 
     // Points to the user interface elements
     Ui::MainWindow *ui;
 
     // Handles the export functionality for the bode plots
     ExportBodePlot *exporter;
+
+    // Shows the frequency, magnitude and phase under the mouse on both bode plots
+    BodeCursor *cursor;
+
+    // Keeps the frequency axes of both bode plots in sync while zooming and dragging
+    PlotLinker *frequencyLink;
+
+    // Computes the magnitude and phase of the transfer function on demand for the visible frequency range
+    FrequencySweepProvider *sweepProvider;
+
+    // Holds the imported measured frequency response data
+    FrequencyResponseData measuredData;
+
+    // Caches the formatted numerator and denominator, so that editing one half doesn't rebuild the other one
+    FormattedInput numeratorDisplay;
+    FormattedInput denominatorDisplay;
 };
 
 #endif
@@ -0,0 +1,76 @@
+#include "plotlinker.h"
+#include <QSet>
+#include <QTimer>
+
+// Constructor for the PlotLinker class
+PlotLinker::PlotLinker(QObject *parent)
+    : QObject(parent)
+{
+}
+
+// Adds the axis and synchronizes it with the already linked axes, the first axis defines the linked range
+void PlotLinker::addAxis(QCPAxis *axis)
+{
+    if (!axis || axes.contains(axis)) {
+        return;
+    }
+    if (axes.isEmpty()) {
+        linkedRange = axis->range();
+    }
+    axes.append(axis);
+    connect(axis, QOverload<const QCPRange &>::of(&QCPAxis::rangeChanged), this, &PlotLinker::onAxisRangeChanged);
+
+    synchronizing = true;
+    axis->setRange(linkedRange);
+    synchronizing = false;
+}
+
+// Disconnects the axis and removes it from the link
+void PlotLinker::removeAxis(QCPAxis *axis)
+{
+    if (axes.removeAll(axis) > 0) {
+        disconnect(axis, nullptr, this, nullptr);
+    }
+}
+
+// Synchronizes the linked axes without recursion and relies on rpQueuedReplot, so that each widget replots once per event loop iteration
+void PlotLinker::onAxisRangeChanged(const QCPRange &range)
+{
+    if (synchronizing) {
+        return;
+    }
+    synchronizing = true;
+    linkedRange = range;
+
+    // Applies the range to the other axes and collects the widgets, which may hold several linked axes
+    QCPAxis *source = qobject_cast<QCPAxis *>(sender());
+    QSet<QCustomPlot *> plots;
+    for (const QPointer<QCPAxis> &axis : axes) {
+        if (!axis) {
+            continue;
+        }
+        if (axis != source) {
+            axis->setRange(range);
+        }
+        plots.insert(axis->parentPlot());
+    }
+    synchronizing = false;
+
+    // Queues the replots, a queued replot that is already pending (e.g. from a range drag) absorbs further requests
+    for (QCustomPlot *plot : plots) {
+        plot->replot(QCustomPlot::rpQueuedReplot);
+    }
+
+    // Emits the range change only once, after all range changes of this event loop iteration have been applied
+    if (!emitQueued) {
+        emitQueued = true;
+        QTimer::singleShot(0, this, &PlotLinker::emitRangeChanged);
+    }
+}
+
+// Emits the last range of the event loop iteration
+void PlotLinker::emitRangeChanged()
+{
+    emitQueued = false;
+    emit rangeChanged(linkedRange);
+}
@@ -0,0 +1,55 @@
+#ifndef PLOTLINKER_H
+#define PLOTLINKER_H
+
+#include <QObject>
+#include <QList>
+#include <QPointer>
+#include "qcustomplot.h"
+
+// The PlotLinker class keeps the ranges of axes on several QCustomPlot widgets equal, e.g. the frequency axes of the bode plots
+// A range change of one axis is applied to all linked axes at once, and each affected widget is replotted only once per
+// event loop iteration, no matter how many range changes occur in between
+class PlotLinker : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Creates a linker without axes
+    explicit PlotLinker(QObject *parent = nullptr);
+
+    // Adds an axis to the link, the axis takes over the range of the axes that are already linked
+    void addAxis(QCPAxis *axis);
+
+    // Removes an axis from the link, its range is no longer synchronized
+    void removeAxis(QCPAxis *axis);
+
+    // Returns the range that all linked axes currently share
+    QCPRange range() const { return linkedRange; }
+
+signals:
+    // Is emitted once per event loop iteration after the linked range changed, with the last range
+    // Receivers use it for lazy updates that depend on the visible range, like recomputing data that doesn't cover it
+    void rangeChanged(const QCPRange &range);
+
+private slots:
+    // Applies the new range of one axis to all other linked axes and queues a replot of all affected widgets
+    void onAxisRangeChanged(const QCPRange &range);
+
+    // Emits the coalesced range change
+    void emitRangeChanged();
+
+private:
+    // Holds the linked axes, which may be deleted together with their widgets
+    QList<QPointer<QCPAxis>> axes;
+
+    // Holds the range shared by all linked axes
+    QCPRange linkedRange;
+
+    // Prevents the range changes of the synchronized axes from being handled again
+    bool synchronizing = false;
+
+    // Indicates that the coalesced rangeChanged signal is already queued for this event loop iteration
+    bool emitQueued = false;
+};
+
+#endif
@@ -0,0 +1,328 @@
+#include "polynomialparser.h"
+#include <QByteArray>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+
+namespace {
+
+// Polynomial with coefficients in ascending powers of s, which simplifies the arithmetic
+typedef std::vector<double> Polynomial;
+
+// Holds a parsed expression as constant gain times a product of polynomial factors
+struct FactoredPolynomial
+{
+    double gain = 1.0;
+    std::vector<Polynomial> factors;
+};
+
+// Multiplies two polynomials
+Polynomial multiply(const Polynomial &a, const Polynomial &b)
+{
+    Polynomial result(a.size() + b.size() - 1, 0.0);
+    for (size_t i = 0; i < a.size(); ++i) {
+        for (size_t j = 0; j < b.size(); ++j) {
+            result[i + j] += a[i] * b[j];
+        }
+    }
+    return result;
+}
+
+// Expands a factored polynomial into a single polynomial
+Polynomial expand(const FactoredPolynomial &factored)
+{
+    Polynomial result(1, factored.gain);
+    for (const Polynomial &factor : factored.factors) {
+        result = multiply(result, factor);
+    }
+    return result;
+}
+
+// Removes vanishing coefficients of the highest powers, but keeps at least the constant coefficient
+void trim(Polynomial &polynomial)
+{
+    while (polynomial.size() > 1 && polynomial.back() == 0) {
+        polynomial.pop_back();
+    }
+}
+
+// Recursive descent parser for polynomial expressions in s, which works directly on the Latin-1 representation of the input
+class ExpressionParser
+{
+public:
+    ExpressionParser(const QByteArray &text)
+        : begin(text.constData()), p(text.constData()), end(text.constData() + text.size()) {}
+
+    // Parses the complete input and fails if characters are left over
+    bool parse(FactoredPolynomial &result)
+    {
+        if (!parseExpression(result)) {
+            return false;
+        }
+        skipSpaces();
+        if (p != end) {
+            return fail(*p == ')' ? "Öffnende Klammer fehlt" : "Unerwartetes Zeichen");
+        }
+        return true;
+    }
+
+    // Holds the position and description of the first error
+    int errorPosition = -1;
+    QString errorMessage;
+
+private:
+    const char *begin;
+    const char *p;
+    const char *end;
+
+    void skipSpaces()
+    {
+        while (p < end && std::isspace(static_cast<unsigned char>(*p))) {
+            ++p;
+        }
+    }
+
+    bool fail(const QString &message)
+    {
+        errorPosition = int(p - begin);
+        errorMessage = message;
+        return false;
+    }
+
+    // expression := term (('+' | '-') term)*
+    // A sum of several terms loses its factorization and becomes a single factor
+    bool parseExpression(FactoredPolynomial &result)
+    {
+        if (!parseTerm(result)) {
+            return false;
+        }
+        skipSpaces();
+        if (p == end || (*p != '+' && *p != '-')) {
+            return true;
+        }
+
+        Polynomial sum = expand(result);
+        while (p < end && (*p == '+' || *p == '-')) {
+            double sign = (*p == '-') ? -1.0 : 1.0;
+            ++p;
+
+            FactoredPolynomial term;
+            if (!parseTerm(term)) {
+                return false;
+            }
+            Polynomial expandedTerm = expand(term);
+            if (expandedTerm.size() > sum.size()) {
+                sum.resize(expandedTerm.size(), 0.0);
+            }
+            for (size_t i = 0; i < expandedTerm.size(); ++i) {
+                sum[i] += sign * expandedTerm[i];
+            }
+            skipSpaces();
+        }
+
+        trim(sum);
+        result = FactoredPolynomial();
+        if (sum.size() == 1) {
+            result.gain = sum[0];
+        } else {
+            result.factors.push_back(sum);
+        }
+        return true;
+    }
+
+    // term := ('+' | '-')* factor (['*'] factor)*, where the '*' may be omitted before '(' and 's'
+    bool parseTerm(FactoredPolynomial &result)
+    {
+        skipSpaces();
+        double sign = 1.0;
+        while (p < end && (*p == '+' || *p == '-')) {
+            if (*p == '-') {
+                sign = -sign;
+            }
+            ++p;
+            skipSpaces();
+        }
+
+        if (!parseFactor(result)) {
+            return false;
+        }
+
+        for (;;) {
+            skipSpaces();
+            if (p < end && *p == '*') {
+                ++p;
+            } else if (!(p < end && (*p == '(' || *p == 's' || *p == 'S'))) {
+                break;
+            }
+
+            FactoredPolynomial factor;
+            if (!parseFactor(factor)) {
+                return false;
+            }
+            result.gain *= factor.gain;
+            result.factors.insert(result.factors.end(), factor.factors.begin(), factor.factors.end());
+        }
+
+        result.gain *= sign;
+        return true;
+    }
+
+    // factor := primary ['^' integer]
+    bool parseFactor(FactoredPolynomial &result)
+    {
+        if (!parsePrimary(result)) {
+            return false;
+        }
+        skipSpaces();
+        if (p == end || *p != '^') {
+            return true;
+        }
+        ++p;
+        skipSpaces();
+
+        int exponent = 0;
+        std::from_chars_result parsed = std::from_chars(p, end, exponent);
+        if (parsed.ec != std::errc() || exponent < 0 || exponent > 1000) {
+            return fail("Ganzzahliger Exponent erwartet");
+        }
+        p = parsed.ptr;
+
+        // Repeats the factors so that every root keeps its multiplicity
+        FactoredPolynomial base = result;
+        result = FactoredPolynomial();
+        result.gain = std::pow(base.gain, exponent);
+        for (int i = 0; i < exponent; ++i) {
+            result.factors.insert(result.factors.end(), base.factors.begin(), base.factors.end());
+        }
+        return true;
+    }
+
+    // primary := number | 's' | '(' expression ')'
+    bool parsePrimary(FactoredPolynomial &result)
+    {
+        skipSpaces();
+        if (p == end) {
+            return fail("Unerwartetes Ende der Eingabe");
+        }
+
+        if (*p == '(') {
+            ++p;
+            if (!parseExpression(result)) {
+                return false;
+            }
+            skipSpaces();
+            if (p == end || *p != ')') {
+                return fail("Schließende Klammer erwartet");
+            }
+            ++p;
+            return true;
+        }
+
+        if (*p == 's' || *p == 'S') {
+            ++p;
+            result = FactoredPolynomial();
+            result.factors.push_back(Polynomial{0.0, 1.0});
+            return true;
+        }
+
+        if (std::isdigit(static_cast<unsigned char>(*p)) || *p == '.') {
+            double value = 0.0;
+            std::from_chars_result parsed = std::from_chars(p, end, value);
+            if (parsed.ec != std::errc() || !std::isfinite(value)) {
+                return fail("Ungültige Zahl");
+            }
+            p = parsed.ptr;
+            result = FactoredPolynomial();
+            result.gain = value;
+            return true;
+        }
+
+        return fail("Unerwartetes Zeichen");
+    }
+};
+
+// Parses a comma-separated list of coefficients in descending powers of s
+bool parseCoefficientList(const QByteArray &text, std::vector<double> &coefficients, int &errorPosition, QString &errorMessage)
+{
+    const char *begin = text.constData();
+    const char *end = begin + text.size();
+    const char *p = begin;
+    coefficients.reserve(std::count(text.begin(), text.end(), ',') + 1);
+
+    for (;;) {
+        while (p < end && std::isspace(static_cast<unsigned char>(*p))) {
+            ++p;
+        }
+        if (p < end && *p == '+') {
+            ++p;
+        }
+
+        double value = 0.0;
+        std::from_chars_result parsed = std::from_chars(p, end, value);
+        if (parsed.ec != std::errc() || !std::isfinite(value)) {
+            errorPosition = int(p - begin);
+            errorMessage = "Zahl erwartet";
+            return false;
+        }
+        coefficients.push_back(value);
+
+        p = parsed.ptr;
+        while (p < end && std::isspace(static_cast<unsigned char>(*p))) {
+            ++p;
+        }
+        if (p == end) {
+            return true;
+        }
+        if (*p != ',') {
+            errorPosition = int(p - begin);
+            errorMessage = "Komma erwartet";
+            return false;
+        }
+        ++p;
+    }
+}
+
+}
+
+// Parses the user input either as a list of coefficients or as an expression in s
+ParsedPolynomial PolynomialParser::parse(const QString &input)
+{
+    ParsedPolynomial result;
+    QByteArray text = input.toLatin1();
+
+    if (input.trimmed().isEmpty()) {
+        result.errorPosition = 0;
+        result.errorMessage = "Leere Eingabe";
+        return result;
+    }
+
+    // Keeps the coefficients of a list exactly as entered, the whole polynomial is its only factor
+    if (text.contains(',')) {
+        if (!parseCoefficientList(text, result.coefficients, result.errorPosition, result.errorMessage)) {
+            return result;
+        }
+        result.factors.push_back(result.coefficients);
+        result.valid = true;
+        return result;
+    }
+
+    ExpressionParser parser(text);
+    FactoredPolynomial factored;
+    if (!parser.parse(factored)) {
+        result.errorPosition = parser.errorPosition;
+        result.errorMessage = parser.errorMessage;
+        return result;
+    }
+
+    // Converts the expanded polynomial and the factors to descending powers of s
+    Polynomial expanded = expand(factored);
+    trim(expanded);
+    result.coefficients.assign(expanded.rbegin(), expanded.rend());
+    result.gain = factored.gain;
+    for (const Polynomial &factor : factored.factors) {
+        result.factors.emplace_back(factor.rbegin(), factor.rend());
+    }
+    result.valid = true;
+    return result;
+}
@@ -0,0 +1,32 @@
+#ifndef POLYNOMIALPARSER_H
+#define POLYNOMIALPARSER_H
+
+#include <vector>
+#include <QString>
+
+// Holds a polynomial in s parsed from the user input, both as expanded coefficients and as a product of factors
+struct ParsedPolynomial
+{
+    // Indicates whether the input was valid, otherwise the error position and message describe the problem
+    bool valid = false;
+    int errorPosition = -1;
+    QString errorMessage;
+
+    // Coefficients of the expanded polynomial in descending powers of s
+    std::vector<double> coefficients;
+
+    // Constant gain and polynomial factors in descending powers of s, so that coefficients = gain * factors[0] * factors[1] * ...
+    double gain = 1.0;
+    std::vector<std::vector<double>> factors;
+};
+
+// The PolynomialParser class converts the user input into a polynomial in s
+// The input is either a comma-separated list of coefficients (e.g. "1, 2, 5") or an expression in s (e.g. "1e3*(s+10)" or "(s+1)(s^2+2s+5)")
+class PolynomialParser
+{
+public:
+    // Parses the input in a single pass and returns the polynomial or the position and description of the first error
+    static ParsedPolynomial parse(const QString &input);
+};
+
+#endif
@@ -268,6 +268,333 @@ QCPVector2D &QCPVector2D::operator-=(const QCPVector2D &vector)
   mY -= vector.mY;
   return *this;
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPSegmentIndex
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPSegmentIndex
+  \brief A uniform grid over line segments in pixel coordinates, for fast hit-testing
+  
+  Plottables with many data points spend most of their \ref QCPAbstractPlottable::selectTest time
+  measuring the distance of the cursor to every line segment. This class sorts the segments into
+  the cells of a uniform grid once, after which \ref nearest only needs to test the segments in the
+  cells around the queried point. The result is identical to a linear search over all segments.
+  
+  The index is built lazily by the plottables on the first hit-test after a change. Each build is
+  tagged with a signature (see \ref isValid), which holds everything the pixel positions depend on,
+  e.g. the data revision, the axis ranges and the axis rect geometry. A mismatching signature
+  causes a rebuild, so the index is implicitly invalidated by range and data changes.
+*/
+
+/*!
+  Creates an empty segment index. Use \ref build to fill it.
+*/
+QCPSegmentIndex::QCPSegmentIndex() :
+  mMode(smPolyline),
+  mBuilt(false),
+  mColumns(0),
+  mRows(0),
+  mCellWidth(1),
+  mCellHeight(1)
+{
+}
+
+/*!
+  Returns whether the index was built with the given \a signature, i.e. whether it still describes
+  the currently displayed segments. The signature is chosen by the user of the index, and should
+  contain everything the pixel positions of the segments depend on, e.g. the axis ranges and a
+  data revision.
+*/
+bool QCPSegmentIndex::isValid(const QVector<double> &signature) const
+{
+  return mBuilt && mSignature == signature;
+}
+
+/*!
+  Builds the index for the segments formed by \a points according to \a mode, and stores \a
+  signature for later checks with \ref isValid. Segments with NaN or infinite coordinates are
+  skipped, so they create gaps like in the drawn lines.
+
+  The grid covers the bounding box of the segments, limited to \a focusRect if it is valid.
+  Segments outside the focus rect are assigned to the border cells, so queries stay exact, but the
+  cells are only as fine as needed around the focus rect (typically the area around the axis rect).
+
+  Each segment is only assigned to the cells it actually crosses (see \ref segmentCells), so the
+  size of the index grows with the total length of the segments in cells, not with the area of
+  their bounding boxes.
+*/
+void QCPSegmentIndex::build(const QVector<QPointF> &points, SegmentMode mode, const QVector<double> &signature, const QRectF &focusRect)
+{
+  mPoints = points;
+  mMode = mode;
+  mSignature = signature;
+  mBuilt = true;
+  mColumns = 0;
+  mRows = 0;
+  mCellStart.clear();
+  mCellSegments.clear();
+  
+  // determine the bounding box of all valid segments:
+  const int count = segmentCount();
+  QPointF p1, p2;
+  int validCount = 0;
+  double left = (std::numeric_limits<double>::max)();
+  double top = left;
+  double right = -left;
+  double bottom = -left;
+  for (int i=0; i<count; ++i)
+  {
+    if (!segment(i, p1, p2))
+      continue;
+    ++validCount;
+    left = qMin(left, qMin(p1.x(), p2.x()));
+    right = qMax(right, qMax(p1.x(), p2.x()));
+    top = qMin(top, qMin(p1.y(), p2.y()));
+    bottom = qMax(bottom, qMax(p1.y(), p2.y()));
+  }
+  if (validCount == 0)
+    return;
+  if (focusRect.isValid())
+  {
+    left = qBound(focusRect.left(), left, focusRect.right());
+    right = qBound(focusRect.left(), right, focusRect.right());
+    top = qBound(focusRect.top(), top, focusRect.bottom());
+    bottom = qBound(focusRect.top(), bottom, focusRect.bottom());
+  }
+  
+  // choose the grid so that a cell holds about two segments on average, with roughly square cells:
+  const double width = qMax(right-left, 1.0);
+  const double height = qMax(bottom-top, 1.0);
+  const int cellCount = qBound(1, validCount/2, 1<<16);
+  mColumns = qBound(1, int(qSqrt(cellCount*width/height)+0.5), cellCount);
+  mRows = qBound(1, cellCount/mColumns, cellCount);
+  mCellWidth = width/mColumns;
+  mCellHeight = height/mRows;
+  mGridOrigin = QPointF(left, top);
+  
+  // count the segments of each cell, then store the segment indices cell by cell:
+  QVector<int> cells;
+  mCellStart.fill(0, mColumns*mRows+1);
+  for (int i=0; i<count; ++i)
+  {
+    if (!segment(i, p1, p2))
+      continue;
+    segmentCells(p1, p2, cells);
+    for (int k=0; k<cells.size(); ++k)
+      ++mCellStart[cells.at(k)+1];
+  }
+  for (int cell=0; cell<mColumns*mRows; ++cell)
+    mCellStart[cell+1] += mCellStart.at(cell);
+  mCellSegments.resize(mCellStart.last());
+  QVector<int> cellFill = mCellStart;
+  for (int i=0; i<count; ++i)
+  {
+    if (!segment(i, p1, p2))
+      continue;
+    segmentCells(p1, p2, cells);
+    for (int k=0; k<cells.size(); ++k)
+      mCellSegments[cellFill[cells.at(k)]++] = i;
+  }
+}
+
+/*!
+  Clears the index, so \ref isValid returns false for any signature.
+*/
+void QCPSegmentIndex::clear()
+{
+  mPoints.clear();
+  mSignature.clear();
+  mBuilt = false;
+  mColumns = 0;
+  mRows = 0;
+  mCellStart.clear();
+  mCellSegments.clear();
+}
+
+/*!
+  Returns the shortest distance of \a pixelPoint to the indexed segments, or -1 if the index holds
+  no valid segments. If \a pointIndex is provided, it is set to the index of the first point of the
+  closest segment (for \ref smPoints, the closest point), or -1.
+
+  The cells are searched in rings of growing size around the cell of \a pixelPoint, until no
+  unsearched cell can contain a closer segment. So the result is exact, while only the segments
+  close to \a pixelPoint are tested.
+*/
+double QCPSegmentIndex::nearest(const QPointF &pixelPoint, int *pointIndex) const
+{
+  if (pointIndex)
+    *pointIndex = -1;
+  if (mColumns == 0)
+    return -1;
+  
+  const QCPVector2D p(pixelPoint);
+  const int centerColumn = cellColumn(pixelPoint.x());
+  const int centerRow = cellRow(pixelPoint.y());
+  const double minCellSize = qMin(mCellWidth, mCellHeight);
+  const int maxRing = qMax(mColumns, mRows);
+  double minDistSqr = (std::numeric_limits<double>::max)();
+  int closestSegment = -1;
+  for (int ring=0; ring<=maxRing; ++ring)
+  {
+    // visit the cells whose row or column is exactly ring cells away from the center cell:
+    const int rowBegin = qMax(0, centerRow-ring);
+    const int rowEnd = qMin(mRows-1, centerRow+ring);
+    for (int row=rowBegin; row<=rowEnd; ++row)
+    {
+      if (row == centerRow-ring || row == centerRow+ring)
+      {
+        for (int column=qMax(0, centerColumn-ring); column<=qMin(mColumns-1, centerColumn+ring); ++column)
+          searchCell(row*mColumns+column, p, minDistSqr, closestSegment);
+      } else
+      {
+        if (centerColumn-ring >= 0)
+          searchCell(row*mColumns+centerColumn-ring, p, minDistSqr, closestSegment);
+        if (centerColumn+ring < mColumns)
+          searchCell(row*mColumns+centerColumn+ring, p, minDistSqr, closestSegment);
+      }
+    }
+    // cells in further rings are at least ring cell sizes away:
+    if (closestSegment >= 0 && minDistSqr <= (ring*minCellSize)*(ring*minCellSize))
+      break;
+  }
+  
+  if (pointIndex && closestSegment >= 0)
+    *pointIndex = mMode == smPairs ? 2*closestSegment : closestSegment;
+  return closestSegment >= 0 ? qSqrt(minDistSqr) : -1;
+}
+
+/*! \internal
+  
+  Tests the segments of the grid \a cell against the point \a p, and updates \a minDistSqr and
+  \a closestSegment if a closer segment is found. Segments with equal distance are resolved in
+  favor of the lower index, like a linear search would.
+*/
+void QCPSegmentIndex::searchCell(int cell, const QCPVector2D &p, double &minDistSqr, int &closestSegment) const
+{
+  QPointF p1, p2;
+  for (int k=mCellStart.at(cell); k<mCellStart.at(cell+1); ++k)
+  {
+    const int segmentIndex = mCellSegments.at(k);
+    segment(segmentIndex, p1, p2);
+    const double distSqr = mMode == smPoints ? (p-QCPVector2D(p1)).lengthSquared() : p.distanceSquaredToLine(QCPVector2D(p1), QCPVector2D(p2));
+    if (distSqr < minDistSqr || (distSqr == minDistSqr && segmentIndex < closestSegment))
+    {
+      minDistSqr = distSqr;
+      closestSegment = segmentIndex;
+    }
+  }
+}
+
+/*! \internal
+  
+  Returns the number of segments formed by the points, depending on the segment mode.
+*/
+int QCPSegmentIndex::segmentCount() const
+{
+  switch (mMode)
+  {
+    case smPolyline: return qMax(0, mPoints.size()-1);
+    case smPairs: return mPoints.size()/2;
+    case smPoints: return mPoints.size();
+  }
+  return 0;
+}
+
+/*! \internal
+  
+  Sets \a p1 and \a p2 to the end points of the segment with \a index (for \ref smPoints, both are
+  the point). Returns false if the segment has NaN or infinite coordinates.
+*/
+bool QCPSegmentIndex::segment(int index, QPointF &p1, QPointF &p2) const
+{
+  switch (mMode)
+  {
+    case smPolyline: p1 = mPoints.at(index); p2 = mPoints.at(index+1); break;
+    case smPairs: p1 = mPoints.at(2*index); p2 = mPoints.at(2*index+1); break;
+    case smPoints: p1 = mPoints.at(index); p2 = p1; break;
+  }
+  return qIsFinite(p1.x()) && qIsFinite(p1.y()) && qIsFinite(p2.x()) && qIsFinite(p2.y());
+}
+
+/*! \internal
+  
+  Sets \a cells to the grid cells crossed by the segment from \a p1 to \a p2, in the order they
+  are passed from \a p1 to \a p2. Parts of the segment outside the grid are clamped to the border
+  cells, like \ref cellColumn and \ref cellRow do for single points.
+
+  The cells are traversed like a digital differential analyzer: the segment parameters where the
+  next column and row boundaries are crossed decide whether to step to the next column or row. If
+  the segment passes exactly through a cell corner, the two cells touching that corner are added
+  as well (supercover), so every point of the segment lies in one of the returned cells.
+*/
+void QCPSegmentIndex::segmentCells(const QPointF &p1, const QPointF &p2, QVector<int> &cells) const
+{
+  cells.clear();
+  int column = cellColumn(p1.x());
+  int row = cellRow(p1.y());
+  const int endColumn = cellColumn(p2.x());
+  const int endRow = cellRow(p2.y());
+  const int columnStep = endColumn > column ? 1 : -1;
+  const int rowStep = endRow > row ? 1 : -1;
+  // segment parameters (0 at p1, 1 at p2) of the next column/row boundary, and their increments:
+  const double u1 = (p1.x()-mGridOrigin.x())/mCellWidth;
+  const double v1 = (p1.y()-mGridOrigin.y())/mCellHeight;
+  const double du = (p2.x()-mGridOrigin.x())/mCellWidth-u1;
+  const double dv = (p2.y()-mGridOrigin.y())/mCellHeight-v1;
+  double tColumn = 0, tColumnDelta = 0, tRow = 0, tRowDelta = 0;
+  if (column != endColumn)
+  {
+    tColumn = ((columnStep > 0 ? column+1 : column)-u1)/du;
+    tColumnDelta = columnStep/du;
+  }
+  if (row != endRow)
+  {
+    tRow = ((rowStep > 0 ? row+1 : row)-v1)/dv;
+    tRowDelta = rowStep/dv;
+  }
+  
+  cells.append(row*mColumns+column);
+  while (column != endColumn || row != endRow)
+  {
+    const bool nextColumn = column != endColumn && (row == endRow || tColumn <= tRow);
+    const bool nextRow = row != endRow && (column == endColumn || tRow <= tColumn);
+    if (nextColumn && nextRow) // passes through a cell corner
+    {
+      cells.append(row*mColumns+column+columnStep);
+      cells.append((row+rowStep)*mColumns+column);
+    }
+    if (nextColumn)
+    {
+      column += columnStep;
+      tColumn += tColumnDelta;
+    }
+    if (nextRow)
+    {
+      row += rowStep;
+      tRow += tRowDelta;
+    }
+    cells.append(row*mColumns+column);
+  }
+}
+
+/*! \internal
+  
+  Returns the grid column containing the pixel coordinate \a x, clamped to the grid.
+*/
+int QCPSegmentIndex::cellColumn(double x) const
+{
+  return int(qBound(0.0, (x-mGridOrigin.x())/mCellWidth, double(mColumns-1)));
+}
+
+/*! \internal
+  
+  Returns the grid row containing the pixel coordinate \a y, clamped to the grid.
+*/
+int QCPSegmentIndex::cellRow(double y) const
+{
+  return int(qBound(0.0, (y-mGridOrigin.y())/mCellHeight, double(mRows-1)));
+}
 /* end of 'src/vector2d.cpp' */
 
 
@@ -657,7 +984,9 @@ void QCPAbstractPaintBuffer::setDevicePixelRatio(double ratio)
   \brief A paint buffer based on QPixmap, using software raster rendering
 
   This paint buffer is the default and fall-back paint buffer which uses software rendering and
-  QPixmap as internal buffer. It is used if \ref QCustomPlot::setOpenGl is false.
+  QPixmap as internal buffer. It is used if \ref QCustomPlot::setOpenGl and \ref
+  QCustomPlot::setSoftwareRasterizer are false and the plotting hint \ref QCP::phParallelLayers
+  isn't set.
 */
 
 /*!
@@ -720,6 +1049,120 @@ void QCPPaintBufferPixmap::reallocateBuffer()
 }
 
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPPaintBufferImage
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPPaintBufferImage
+  \brief A paint buffer based on QImage, using software raster rendering
+
+  This paint buffer uses software rendering and QImage as internal buffer. Unlike QPixmap, a QImage
+  may be painted on outside the GUI thread, so this paint buffer is used instead of \ref
+  QCPPaintBufferPixmap if the plotting hint \ref QCP::phParallelLayers is set and \ref
+  QCustomPlot::setOpenGl is false. \ref QCustomPlot::replot then draws the layers of different
+  image paint buffers concurrently, and \ref QCustomPlot::paintEvent composites the buffers on the
+  widget surface as usual.
+*/
+
+/*!
+  Creates an image paint buffer instance with the specified \a size and \a devicePixelRatio, if
+  applicable.
+*/
+QCPPaintBufferImage::QCPPaintBufferImage(const QSize &size, double devicePixelRatio) :
+  QCPAbstractPaintBuffer(size, devicePixelRatio)
+{
+  QCPPaintBufferImage::reallocateBuffer();
+}
+
+QCPPaintBufferImage::~QCPPaintBufferImage()
+{
+}
+
+/* inherits documentation from base class */
+QCPPainter *QCPPaintBufferImage::startPainting()
+{
+  QCPPainter *result = new QCPPainter(&mBuffer);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+  result->setRenderHint(QPainter::HighQualityAntialiasing);
+#endif
+  return result;
+}
+
+/* inherits documentation from base class */
+void QCPPaintBufferImage::draw(QCPPainter *painter) const
+{
+  if (painter && painter->isActive())
+    painter->drawImage(0, 0, mBuffer);
+  else
+    qDebug() << Q_FUNC_INFO << "invalid or inactive painter passed";
+}
+
+/* inherits documentation from base class */
+void QCPPaintBufferImage::clear(const QColor &color)
+{
+  mBuffer.fill(color);
+}
+
+/* inherits documentation from base class */
+void QCPPaintBufferImage::reallocateBuffer()
+{
+  setInvalidated();
+  if (!qFuzzyCompare(1.0, mDevicePixelRatio))
+  {
+#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
+    mBuffer = QImage(mSize*mDevicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    mBuffer.setDevicePixelRatio(mDevicePixelRatio);
+#else
+    qDebug() << Q_FUNC_INFO << "Device pixel ratios not supported for Qt versions before 5.4";
+    mDevicePixelRatio = 1.0;
+    mBuffer = QImage(mSize, QImage::Format_ARGB32_Premultiplied);
+#endif
+  } else
+  {
+    mBuffer = QImage(mSize, QImage::Format_ARGB32_Premultiplied);
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPPaintBufferRasterizer
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPPaintBufferRasterizer
+  \brief An image paint buffer whose antialiased lines and fills are drawn by QCPRasterizer
+
+  This paint buffer is used instead of \ref QCPPaintBufferPixmap and \ref QCPPaintBufferImage if
+  \ref QCustomPlot::setSoftwareRasterizer is enabled and \ref QCustomPlot::setOpenGl is false.
+
+  It is a \ref QCPPaintBufferImage whose painters have the mode \ref
+  QCPPainter::pmSoftwareRasterizer set, so plottables pass their polylines and fills to \ref
+  QCPRasterizer, which writes them into the image directly. All other drawing goes through
+  QPainter as usual. Since the buffer is a QImage, layers may also be drawn in parallel (\ref
+  QCP::phParallelLayers).
+*/
+
+/*!
+  Creates a rasterizer paint buffer instance with the specified \a size and \a devicePixelRatio, if
+  applicable.
+*/
+QCPPaintBufferRasterizer::QCPPaintBufferRasterizer(const QSize &size, double devicePixelRatio) :
+  QCPPaintBufferImage(size, devicePixelRatio)
+{
+}
+
+QCPPaintBufferRasterizer::~QCPPaintBufferRasterizer()
+{
+}
+
+/* inherits documentation from base class */
+QCPPainter *QCPPaintBufferRasterizer::startPainting()
+{
+  QCPPainter *result = QCPPaintBufferImage::startPainting();
+  result->setMode(QCPPainter::pmSoftwareRasterizer);
+  return result;
+}
+
+
 #ifdef QCP_OPENGL_PBUFFER
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////// QCPPaintBufferGlPbuffer
@@ -972,6 +1415,867 @@ void QCPPaintBufferGlFbo::reallocateBuffer()
 #endif
 }
 #endif // QCP_OPENGL_FBO
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPTiledRenderer
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPTiledRenderer
+  \brief The abstract base class for rasterizing a single expensive drawing operation in tiles on
+  multiple threads
+
+  A single plottable with a huge amount of visible data, like a graph with millions of line
+  segments or a color map image scaled to a large area, is drawn by a single chain of QPainter
+  calls, so only one core does the rasterization. If the plotting hint \ref QCP::phTiledRendering
+  is set, such drawing operations are instead split into tiles: The clip area of the painter is
+  divided into strips lined up in the given orientation, each strip is rasterized into its own
+  QImage on the global QThreadPool (with the calling thread taking part), and finally the tiles
+  are blitted with the original painter.
+
+  Subclasses implement \ref drawTile, which is called concurrently for different tiles with a
+  painter that has the same transformation, render hints, pen and brush as the original painter,
+  clipped to the tile. It should only draw the parts of its content that intersect the tile, which
+  is where the speedup comes from. See \ref QCPPolylineTileRenderer and \ref QCPImageTileRenderer.
+
+  Tiled rendering is only possible for raster paint devices, see \ref canRender. This includes the
+  default paint buffers as well as the pixmaps created by \ref QCustomPlot::toPixmap and \ref
+  QCustomPlot::saveRastered, so large raster exports benefit as well.
+*/
+
+/* start documentation of pure virtual functions */
+
+/*! \fn virtual void QCPTiledRenderer::drawTile(QCPPainter *painter, const QRectF &tileRect) const = 0
+  
+  Draws the part of the content that intersects \a tileRect (in the logical coordinates of the
+  original painter) with \a painter. This method is called concurrently from multiple threads, so
+  it must not modify shared state.
+*/
+
+/* end documentation of pure virtual functions */
+
+/*! \internal
+  \class QCPTileRenderTask
+  
+  A runnable used by \ref QCPTiledRenderer::render to draw tiles on a thread pool. The task draws
+  tiles until all are claimed (see \ref QCPTiledRenderer::drawTiles), then releases the semaphore
+  passed to the constructor.
+*/
+class QCPTileRenderTask : public QRunnable
+{
+public:
+  QCPTileRenderTask(QCPTiledRenderer *renderer, QSemaphore *finished) :
+    mRenderer(renderer),
+    mFinished(finished)
+  {
+    setAutoDelete(false);
+  }
+  
+  virtual void run() Q_DECL_OVERRIDE
+  {
+    mRenderer->drawTiles();
+    mFinished->release();
+  }
+  
+private:
+  QCPTiledRenderer *mRenderer;
+  QSemaphore *mFinished;
+};
+
+/*!
+  Creates a tiled renderer that draws with \a painter, splitting its clip area into tiles that are
+  lined up in the given \a orientation. The tiles are drawn with \ref render.
+*/
+QCPTiledRenderer::QCPTiledRenderer(QCPPainter *painter, Qt::Orientation orientation) :
+  mPainter(painter),
+  mOrientation(orientation),
+  mDevicePixelRatio(1.0),
+  mNextTile(0)
+{
+}
+
+QCPTiledRenderer::~QCPTiledRenderer()
+{
+}
+
+/*!
+  Returns whether the content drawn with \a painter can be rendered in tiles. This is the case if
+  the painter is active on a raster paint device, isn't vectorized (see \ref
+  QCPPainter::pmVectorized) and more than one core is available.
+*/
+bool QCPTiledRenderer::canRender(QCPPainter *painter)
+{
+  return painter && painter->isActive() && painter->paintEngine() &&
+      painter->paintEngine()->type() == QPaintEngine::Raster &&
+      !painter->modes().testFlag(QCPPainter::pmVectorized) &&
+      QThread::idealThreadCount() > 1;
+}
+
+/*!
+  Divides the clip area of the painter into tiles, draws them concurrently with \ref drawTile and
+  blits the results with the painter. This method returns after all tiles are drawn.
+
+  Only threads that are currently idle in the global QThreadPool are used, so tiled rendering also
+  works when called from a pool thread, e.g. with \ref QCP::phParallelLayers.
+*/
+void QCPTiledRenderer::render()
+{
+  // determine the area to draw in logical and device coordinates:
+#ifdef QCP_DEVICEPIXELRATIO_FLOAT
+  mDevicePixelRatio = mPainter->device()->devicePixelRatioF();
+#elif defined(QCP_DEVICEPIXELRATIO_SUPPORTED)
+  mDevicePixelRatio = mPainter->device()->devicePixelRatio();
+#endif
+  const QRectF deviceRect(0, 0, mPainter->device()->width()/mDevicePixelRatio, mPainter->device()->height()/mDevicePixelRatio);
+  mTransform = mPainter->transform();
+  mArea = mPainter->hasClipping() ? mPainter->clipBoundingRect() : mTransform.inverted().mapRect(deviceRect);
+  const QRect deviceArea = mTransform.mapRect(mArea).toAlignedRect() & deviceRect.toAlignedRect();
+  if (deviceArea.isEmpty())
+    return;
+  
+  // split the area into strips, using twice as many tiles as threads for load balancing, but keep
+  // tiles at least a few pixels wide:
+  const int minimumTileSize = 16;
+  const int areaLength = mOrientation == Qt::Horizontal ? deviceArea.width() : deviceArea.height();
+  const int tileCount = qBound(1, areaLength/minimumTileSize, 2*QThread::idealThreadCount());
+  mTileRects.clear();
+  for (int i=0; i<tileCount; ++i)
+  {
+    const int begin = areaLength*i/tileCount;
+    const int end = areaLength*(i+1)/tileCount;
+    if (mOrientation == Qt::Horizontal)
+      mTileRects.append(QRect(deviceArea.left()+begin, deviceArea.top(), end-begin, deviceArea.height()));
+    else
+      mTileRects.append(QRect(deviceArea.left(), deviceArea.top()+begin, deviceArea.width(), end-begin));
+  }
+  mTileImages = QVector<QImage>(tileCount);
+  mNextTile.storeRelease(0);
+  
+  // start a task for each additional tile, as long as the pool has idle threads:
+  QThreadPool *pool = QThreadPool::globalInstance();
+  QSemaphore finished;
+  QList<QCPTileRenderTask*> tasks;
+  for (int i=1; i<tileCount; ++i)
+  {
+    QCPTileRenderTask *task = new QCPTileRenderTask(this, &finished);
+    if (!pool->tryStart(task))
+    {
+      delete task;
+      break;
+    }
+    tasks.append(task);
+  }
+  drawTiles();
+  finished.acquire(tasks.size());
+  qDeleteAll(tasks);
+  
+  // blit the tiles in device coordinates:
+  mPainter->save();
+  mPainter->resetTransform();
+  for (int i=0; i<tileCount; ++i)
+    mPainter->drawImage(mTileRects.at(i).topLeft(), mTileImages.at(i));
+  mPainter->restore();
+  mTileImages.clear();
+}
+
+/*! \internal
+  
+  Draws tiles until all tiles are claimed. This is called by the calling thread of \ref render and
+  by the pool threads at the same time, each tile is claimed by exactly one of them.
+*/
+void QCPTiledRenderer::drawTiles()
+{
+  const QTransform inverseTransform = mTransform.inverted();
+  QImage *tileImages = mTileImages.data(); // each thread only writes the images of the tiles it claimed
+  int index;
+  while ((index = mNextTile.fetchAndAddOrdered(1)) < mTileRects.size())
+  {
+    const QRect tileRect = mTileRects.at(index);
+    QImage image(tileRect.size()*mDevicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
+    image.setDevicePixelRatio(mDevicePixelRatio);
+#endif
+    image.fill(Qt::transparent);
+    QCPPainter tilePainter(&image);
+    tilePainter.setRenderHints(mPainter->renderHints());
+    tilePainter.setModes(mPainter->modes());
+    tilePainter.setTransform(mTransform*QTransform::fromTranslate(-tileRect.left(), -tileRect.top()));
+    tilePainter.setClipRect(mArea);
+    tilePainter.setPen(mPainter->pen());
+    tilePainter.setBrush(mPainter->brush());
+    drawTile(&tilePainter, inverseTransform.mapRect(QRectF(tileRect)) & mArea);
+    tilePainter.end();
+    tileImages[index] = image;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPPolylineTileRenderer
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPPolylineTileRenderer
+  \brief Rasterizes a long polyline in tiles on multiple threads
+
+  This tiled renderer is used by \ref QCPAbstractPlottable1D::drawPolyline for graphs and curves
+  with many visible line segments, if the plotting hint \ref QCP::phTiledRendering is set. Each tile
+  only draws the runs of consecutive segments whose bounding boxes intersect the tile. Like \ref
+  QCPAbstractPlottable1D::drawPolyline, NaN points create gaps in the line.
+*/
+
+/*!
+  Creates a polyline tile renderer that draws \a lineData with the pen of \a painter. The tiles
+  are lined up in the given \a orientation, which should be the orientation of the key axis.
+
+  If \a fastPolylines is true, the segments are drawn as individual lines, see \ref
+  QCP::phFastPolylines.
+
+  The renderer keeps a reference to \a lineData, so it must stay valid until \ref render returns.
+*/
+QCPPolylineTileRenderer::QCPPolylineTileRenderer(QCPPainter *painter, Qt::Orientation orientation, const QVector<QPointF> &lineData, bool fastPolylines) :
+  QCPTiledRenderer(painter, orientation),
+  mLineData(lineData),
+  mFastPolylines(fastPolylines)
+{
+}
+
+/* inherits documentation from base class */
+void QCPPolylineTileRenderer::drawTile(QCPPainter *painter, const QRectF &tileRect) const
+{
+  // include segments that touch the tile with their line width or joins:
+  const double margin = 2*qMax(1.0, painter->pen().widthF())+2;
+  const QRectF rect = tileRect.adjusted(-margin, -margin, margin, margin);
+  const QPointF *points = mLineData.constData();
+  const int size = mLineData.size();
+  int runStart = -1; // index of the first point of the current run of segments that intersect the tile
+  for (int i=1; i<size; ++i)
+  {
+    const QPointF &p1 = points[i-1];
+    const QPointF &p2 = points[i];
+    const bool valid = !qIsNaN(p1.x()) && !qIsNaN(p1.y()) && !qIsInf(p1.y()) &&
+                       !qIsNaN(p2.x()) && !qIsNaN(p2.y()) && !qIsInf(p2.y()); // NaNs create a gap in the line, Infs are filtered like in drawPolyline
+    if (valid &&
+        qMin(p1.x(), p2.x()) <= rect.right() && qMax(p1.x(), p2.x()) >= rect.left() &&
+        qMin(p1.y(), p2.y()) <= rect.bottom() && qMax(p1.y(), p2.y()) >= rect.top())
+    {
+      if (mFastPolylines)
+        painter->drawLine(p1, p2);
+      else if (runStart < 0)
+        runStart = i-1;
+    } else if (runStart >= 0)
+    {
+      painter->drawPolyline(points+runStart, i-runStart);
+      runStart = -1;
+    }
+  }
+  if (runStart >= 0)
+    painter->drawPolyline(points+runStart, size-runStart);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPImageTileRenderer
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPImageTileRenderer
+  \brief Draws a scaled image in tiles on multiple threads
+
+  This tiled renderer is used by \ref QCPColorMap to draw its map image into a large area, if the
+  plotting hint \ref QCP::phTiledRendering is set. The transformation of the image, e.g. smooth
+  scaling (see \ref QCPColorMap::setInterpolate), is thus distributed over multiple threads. The
+  tiles are horizontal bands, which keeps the scan lines of each tile contiguous.
+*/
+
+/*!
+  Creates an image tile renderer that draws \a image into \a targetRect with \a painter.
+
+  The renderer keeps a reference to \a image, so it must stay valid until \ref render returns.
+*/
+QCPImageTileRenderer::QCPImageTileRenderer(QCPPainter *painter, const QRectF &targetRect, const QImage &image) :
+  QCPTiledRenderer(painter, Qt::Vertical),
+  mTargetRect(targetRect),
+  mImage(image)
+{
+}
+
+/* inherits documentation from base class */
+void QCPImageTileRenderer::drawTile(QCPPainter *painter, const QRectF &tileRect) const
+{
+  if (tileRect.intersects(mTargetRect))
+    painter->drawImage(mTargetRect, mImage); // the painter is clipped to the tile, so only the tile's part is rasterized
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPRasterizer
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPRasterizer
+  \brief Draws antialiased polylines and polygon fills directly into an image paint buffer
+
+  QCPRasterizer is a scanline rasterizer for the two primitives that take most of the drawing time
+  of dense plots. These are antialiased solid polylines (the lines of graphs, curves and polar
+  graphs) and solid fills without outline (graph, channel and curve fills). It writes into the
+  pixels of the image the painter draws on, instead of going through the path stroker and span
+  functions of QPainter. It is used if \ref QCustomPlot::setSoftwareRasterizer is enabled, which
+  gives the painters of the paint buffers the mode \ref QCPPainter::pmSoftwareRasterizer.
+
+  The edges of a shape are accumulated as signed area per pixel. A running sum along each scanline
+  turns them into the coverage of each pixel, which is composited with source-over onto the image.
+  Only the pixel span touched by edges is visited on each scanline. With SSE2, the running sum and
+  the compositing process four pixels at once. Other architectures use the equivalent scalar code.
+
+  A stroke is made of one quad per line segment plus a bevel triangle on the outer side of each
+  join, and square caps extend the ends by half the pen width. The parts of a stroke are combined
+  with the nonzero rule, so dense lines that cross themselves don't accumulate alpha. Fills use the
+  odd-even rule like QPainter::drawPolygon.
+
+  \ref drawPolyline and \ref drawPolygon return false if the painter state isn't supported. This
+  is the case e.g. for dashed or gradient pens, wide pens with miter or round joins, rotated
+  painters, non-rectangular clips, composition modes other than source-over, or disabled
+  antialiasing. The caller then draws the primitive with QPainter as usual.
+*/
+
+/*! \internal
+
+  Creates a rasterizer that draws into the image of \a painter, limited to the clip rect of the
+  painter. Use \ref canRasterize to check the painter state before.
+*/
+QCPRasterizer::QCPRasterizer(QCPPainter *painter) :
+  mImage(static_cast<QImage*>(painter->device())),
+  mStride(0),
+  mCoverage(nullptr)
+{
+  mClipRect = mImage->rect();
+  if (painter->hasClipping())
+  {
+    const QRectF clip = painter->deviceTransform().mapRect(painter->clipBoundingRect());
+    mClipRect &= QRect(QPoint(qRound(clip.left()), qRound(clip.top())), QPoint(qRound(clip.right())-1, qRound(clip.bottom())-1));
+  }
+}
+
+/*!
+  Returns whether the rasterizer supports the current state of \a painter.
+
+  This requires that the painter has the mode \ref QCPPainter::pmSoftwareRasterizer and draws
+  antialiased with source-over composition on a QImage with format
+  QImage::Format_ARGB32_Premultiplied, without rotation or shear and with at most a rectangular
+  clip.
+*/
+bool QCPRasterizer::canRasterize(QCPPainter *painter)
+{
+  if (!painter || !painter->isActive() || !painter->modes().testFlag(QCPPainter::pmSoftwareRasterizer))
+    return false;
+  if (!painter->device() || painter->device()->devType() != QInternal::Image ||
+      static_cast<QImage*>(painter->device())->format() != QImage::Format_ARGB32_Premultiplied)
+    return false;
+  if (!painter->antialiasing() || painter->compositionMode() != QPainter::CompositionMode_SourceOver ||
+      painter->deviceTransform().type() > QTransform::TxScale)
+    return false;
+  return !painter->hasClipping() || painter->clipRegion().rectCount() <= 1;
+}
+
+/*!
+  Draws the polyline given by \a points and \a pointCount with the pen of \a painter. Points with
+  NaN or infinite coordinates create a gap in the line.
+
+  Returns false without drawing anything if the painter state (see \ref canRasterize) or the pen
+  isn't supported, in which case the caller should draw the polyline with QPainter. Solid pens of
+  any width are supported. Pens wider than three device pixels additionally need a bevel join and
+  a flat or square cap, since round and miter joins only look different from bevel joins on wide
+  lines.
+*/
+bool QCPRasterizer::drawPolyline(QCPPainter *painter, const QPointF *points, int pointCount)
+{
+  if (!canRasterize(painter))
+    return false;
+  const QPen pen = painter->pen();
+  if (pen.style() == Qt::NoPen)
+    return true;
+  if (pen.style() != Qt::SolidLine || pen.brush().style() != Qt::SolidPattern)
+    return false;
+  
+  // determine the pen width in device pixels:
+  const QTransform transform = painter->deviceTransform();
+  double width;
+  if (pen.isCosmetic())
+  {
+    double devicePixelRatio = 1.0;
+#ifdef QCP_DEVICEPIXELRATIO_FLOAT
+    devicePixelRatio = painter->device()->devicePixelRatioF();
+#elif defined(QCP_DEVICEPIXELRATIO_SUPPORTED)
+    devicePixelRatio = painter->device()->devicePixelRatio();
+#endif
+    width = qMax(1.0, pen.widthF())*devicePixelRatio;
+  } else if (qFuzzyCompare(qAbs(transform.m11()), qAbs(transform.m22())))
+    width = pen.widthF()*qAbs(transform.m11());
+  else
+    return false; // a non-uniformly scaled pen would need an elliptic pen shape
+  if (width > 3 && (pen.joinStyle() != Qt::BevelJoin || pen.capStyle() == Qt::RoundCap))
+    return false;
+  
+  const quint32 color = premultipliedColor(pen.color(), painter->opacity());
+  if (color == 0 || pointCount < 2)
+    return true;
+  
+  QVector<QPointF> devicePoints;
+  QRectF bounds;
+  mapToDevice(transform, points, pointCount, &devicePoints, &bounds);
+  if (bounds.isNull())
+    return true;
+  
+  // square caps at the corners of segments reach up to a pen width away from the points:
+  QCPRasterizer rasterizer(painter);
+  if (rasterizer.beginArea(bounds.adjusted(-width-1, -width-1, width+1, width+1)))
+  {
+    rasterizer.addStroke(devicePoints.constData(), devicePoints.size(), 0.5*width, pen.capStyle() != Qt::FlatCap);
+    rasterizer.composite(color, false);
+  }
+  return true;
+}
+
+/*!
+  Fills \a polygon with the brush of \a painter, using the odd-even fill rule.
+
+  Returns false without drawing anything if the painter state (see \ref canRasterize) isn't
+  supported, if the brush isn't a solid color, if the painter has a pen (outlines are left to
+  QPainter), or if the polygon contains NaN or infinite coordinates. In that case the caller should
+  draw the polygon with QPainter.
+*/
+bool QCPRasterizer::drawPolygon(QCPPainter *painter, const QPolygonF &polygon)
+{
+  if (!canRasterize(painter) || painter->pen().style() != Qt::NoPen)
+    return false;
+  const QBrush brush = painter->brush();
+  if (brush.style() == Qt::NoBrush)
+    return true;
+  if (brush.style() != Qt::SolidPattern)
+    return false;
+  
+  QVector<QPointF> devicePoints;
+  QRectF bounds;
+  if (!mapToDevice(painter->deviceTransform(), polygon.constData(), polygon.size(), &devicePoints, &bounds))
+    return false;
+  const quint32 color = premultipliedColor(brush.color(), painter->opacity());
+  if (color == 0 || devicePoints.size() < 3)
+    return true;
+  
+  QCPRasterizer rasterizer(painter);
+  if (rasterizer.beginArea(bounds.adjusted(-1, -1, 1, 1)))
+  {
+    for (int i=0; i<devicePoints.size(); ++i)
+      rasterizer.addLine(devicePoints.at(i), devicePoints.at((i+1) % devicePoints.size()));
+    rasterizer.composite(color, true);
+  }
+  return true;
+}
+
+/*! \internal
+
+  Prepares drawing a shape with the device pixel \a bounds. The drawing area is \a bounds
+  intersected with the clip rect. Returns false if the area is empty, so nothing needs to be drawn.
+
+  The coverage accumulation buffer is kept per thread. \ref composite sets the cells it visited back
+  to zero, so the buffer doesn't need to be cleared for every shape. The buffer grows with the
+  largest area, and once many consecutive areas needed less than a quarter of it, it is reallocated
+  with a smaller size, so a single large fill doesn't hold on to its memory.
+*/
+bool QCPRasterizer::beginArea(const QRectF &bounds)
+{
+  mArea = (bounds & QRectF(mClipRect)).toAlignedRect() & mClipRect;
+  if (mArea.isEmpty())
+    return false;
+  mStride = mArea.width()+2; // edges on the right border of the area touch two cells beyond it
+  
+  static QThreadStorage<CoverageBuffer> coverageBuffers;
+  CoverageBuffer &buffer = coverageBuffers.localData();
+  const int bufferSize = mStride*mArea.height();
+  if (buffer.cells.size() < bufferSize)
+  {
+    buffer.cells.resize(bufferSize);
+    buffer.smallAreaCount = 0;
+  } else if (buffer.cells.size() > 4*bufferSize && buffer.cells.size() > 65536) // buffer is much larger than needed, shrink it if this persists
+  {
+    if (++buffer.smallAreaCount >= 256)
+    {
+      buffer.cells = QVector<float>(2*bufferSize); // new cells are zero, as composite expects
+      buffer.smallAreaCount = 0;
+    }
+  } else
+    buffer.smallAreaCount = 0;
+  mCoverage = buffer.cells.data();
+  mRowBegin.fill(mStride, mArea.height());
+  mRowEnd.fill(0, mArea.height());
+  return true;
+}
+
+/*! \internal
+
+  Adds the edge from \a p1 to \a p2, given in device pixels, to the shape.
+
+  The edge is clipped to the vertical extent of the area. Parts left or right of the area are
+  projected onto the respective border, so that the edge still covers the pixels to its right
+  correctly, and the coverage of a shape reaching beyond the right border ends there.
+*/
+void QCPRasterizer::addLine(const QPointF &p1, const QPointF &p2)
+{
+  const double w = mArea.width();
+  const double h = mArea.height();
+  double x1 = p1.x()-mArea.left();
+  double y1 = p1.y()-mArea.top();
+  double x2 = p2.x()-mArea.left();
+  double y2 = p2.y()-mArea.top();
+  if (y1 == y2 || (y1 <= 0 && y2 <= 0) || (y1 >= h && y2 >= h))
+    return; // horizontal edges and edges above or below the area don't contribute
+  
+  // clip to the vertical extent of the area:
+  const double dxdy = (x2-x1)/(y2-y1);
+  if (y1 < 0)
+  {
+    x1 -= y1*dxdy;
+    y1 = 0;
+  } else if (y1 > h)
+  {
+    x1 += (h-y1)*dxdy;
+    y1 = h;
+  }
+  if (y2 < 0)
+  {
+    x2 -= y2*dxdy;
+    y2 = 0;
+  } else if (y2 > h)
+  {
+    x2 += (h-y2)*dxdy;
+    y2 = h;
+  }
+  
+  // split at the left and right border and project the outer parts onto the borders:
+  double crossings[2];
+  int crossingCount = 0;
+  if ((x1 < 0) != (x2 < 0))
+    crossings[crossingCount++] = -x1/(x2-x1);
+  if ((x1 > w) != (x2 > w))
+    crossings[crossingCount++] = (w-x1)/(x2-x1);
+  if (crossingCount == 2 && crossings[0] > crossings[1])
+    qSwap(crossings[0], crossings[1]);
+  double xStart = x1;
+  double yStart = y1;
+  for (int i=0; i<=crossingCount; ++i)
+  {
+    const double xEnd = i < crossingCount ? x1+(x2-x1)*crossings[i] : x2;
+    const double yEnd = i < crossingCount ? y1+(y2-y1)*crossings[i] : y2;
+    if (yStart != yEnd)
+      accumulateLine(qBound(0.0, xStart, w), yStart, qBound(0.0, xEnd, w), yEnd);
+    xStart = xEnd;
+    yStart = yEnd;
+  }
+}
+
+/*! \internal
+
+  Adds the triangle \a p1, \a p2, \a p3 to the shape, oriented like the quads of \ref addQuad so
+  they don't cancel each other where they overlap.
+*/
+void QCPRasterizer::addTriangle(const QPointF &p1, QPointF p2, QPointF p3)
+{
+  if ((p2.x()-p1.x())*(p3.y()-p1.y())-(p2.y()-p1.y())*(p3.x()-p1.x()) > 0)
+    qSwap(p2, p3);
+  addLine(p1, p2);
+  addLine(p2, p3);
+  addLine(p3, p1);
+}
+
+/*! \internal
+
+  Adds the rectangle around the line from \a start to \a end to the shape, which reaches \a normal
+  to both sides of the line. \a normal must be the direction of the line rotated by 90 degrees
+  counterclockwise (in pixel coordinates), so all quads have the same orientation.
+*/
+void QCPRasterizer::addQuad(const QPointF &start, const QPointF &end, const QPointF &normal)
+{
+  addLine(start+normal, end+normal);
+  addLine(end+normal, end-normal);
+  addLine(end-normal, start-normal);
+  addLine(start-normal, start+normal);
+}
+
+/*! \internal
+
+  Adds the stroke of the polyline \a points with \a pointCount points and the pen half width \a
+  halfWidth to the shape. Points with NaN or infinite coordinates create gaps. If \a extendEnds is
+  true, the ends of each part are extended by \a halfWidth like a square cap.
+*/
+void QCPRasterizer::addStroke(const QPointF *points, int pointCount, double halfWidth, bool extendEnds)
+{
+  int begin = 0;
+  while (begin < pointCount)
+  {
+    // find the next run of finite points:
+    while (begin < pointCount && !(qIsFinite(points[begin].x()) && qIsFinite(points[begin].y())))
+      ++begin;
+    int end = begin;
+    while (end < pointCount && qIsFinite(points[end].x()) && qIsFinite(points[end].y()))
+      ++end;
+    
+    bool first = true;
+    QPointF direction, normal, previousNormal;
+    for (int i=begin; i<end-1; ++i)
+    {
+      const QPointF delta = points[i+1]-points[i];
+      const double length = qSqrt(delta.x()*delta.x()+delta.y()*delta.y());
+      if (length < 1e-9)
+        continue;
+      direction = delta/length;
+      normal = QPointF(-direction.y(), direction.x())*halfWidth;
+      if (first)
+      {
+        if (extendEnds)
+          addQuad(points[i]-direction*halfWidth, points[i], normal);
+        first = false;
+      } else if (halfWidth > 0.5) // the joins of thin lines are smaller than the antialiasing
+      {
+        // bevel the outer side of the join, the inner side is covered by both quads:
+        const double side = previousNormal.x()*normal.y()-previousNormal.y()*normal.x() > 0 ? -1 : 1;
+        addTriangle(points[i], points[i]+previousNormal*side, points[i]+normal*side);
+      }
+      addQuad(points[i], points[i+1], normal);
+      previousNormal = normal;
+    }
+    if (!first && extendEnds)
+      addQuad(points[end-1], points[end-1]+direction*halfWidth, normal);
+    begin = end;
+  }
+}
+
+/*! \internal
+
+  Accumulates the signed area that the edge from (\a x1, \a y1) to (\a x2, \a y2) covers in each
+  pixel. The coordinates are relative to the area and already clipped to it.
+
+  Each scanline the edge passes adds its height in that scanline, distributed over the pixels
+  according to how much of each pixel lies to the right of the edge. The running sum over a scanline
+  (see \ref compositeSpan) then yields the coverage of each pixel.
+*/
+void QCPRasterizer::accumulateLine(double x1, double y1, double x2, double y2)
+{
+  const double w = mArea.width();
+  double direction = 1.0;
+  if (y1 > y2)
+  {
+    qSwap(x1, x2);
+    qSwap(y1, y2);
+    direction = -1.0;
+  }
+  const double dxdy = (x2-x1)/(y2-y1);
+  double x = x1;
+  const int rowEnd = qMin(mArea.height(), qCeil(y2));
+  for (int y=int(y1); y<rowEnd; ++y)
+  {
+    float *row = mCoverage+y*mStride;
+    const double dy = qMin(double(y+1), y2)-qMax(double(y), y1);
+    const double xNext = qBound(0.0, x+dxdy*dy, w);
+    const double d = dy*direction;
+    const double xa = qMin(x, xNext);
+    const double xb = qMax(x, xNext);
+    const int xaIndex = qFloor(xa);
+    const int xbIndex = qCeil(xb);
+    if (xbIndex <= xaIndex+1)
+    {
+      // the edge stays within one pixel column on this scanline:
+      const double xm = 0.5*(x+xNext)-xaIndex;
+      row[xaIndex] += float(d*(1.0-xm));
+      row[xaIndex+1] += float(d*xm);
+      mRowEnd[y] = qMax(mRowEnd.at(y), xaIndex+2);
+    } else
+    {
+      // the edge passes several pixel columns, the pixels in between get equal shares:
+      const double s = 1.0/(xb-xa);
+      const double xaFraction = xa-xaIndex;
+      const double a0 = 0.5*s*(1.0-xaFraction)*(1.0-xaFraction);
+      const double xbFraction = xb-xbIndex+1.0;
+      const double am = 0.5*s*xbFraction*xbFraction;
+      row[xaIndex] += float(d*a0);
+      if (xbIndex == xaIndex+2)
+      {
+        row[xaIndex+1] += float(d*(1.0-a0-am));
+      } else
+      {
+        const double a1 = s*(1.5-xaFraction);
+        row[xaIndex+1] += float(d*(a1-a0));
+        for (int xi=xaIndex+2; xi<xbIndex-1; ++xi)
+          row[xi] += float(d*s);
+        const double a2 = a1+(xbIndex-xaIndex-3)*s;
+        row[xbIndex-1] += float(d*(1.0-a2-am));
+      }
+      row[xbIndex] += float(d*am);
+      mRowEnd[y] = qMax(mRowEnd.at(y), xbIndex+1);
+    }
+    mRowBegin[y] = qMin(mRowBegin.at(y), xaIndex);
+    x = xNext;
+  }
+}
+
+/*! \internal
+
+  Composites the accumulated shape with the premultiplied \a color onto the image and resets the
+  visited cells of the coverage buffer to zero. If \a oddEven is true, the coverage is folded with
+  the odd-even fill rule, otherwise with the nonzero rule.
+*/
+void QCPRasterizer::composite(quint32 color, bool oddEven)
+{
+  for (int y=0; y<mArea.height(); ++y)
+  {
+    const int begin = mRowBegin.at(y);
+    const int end = mRowEnd.at(y);
+    if (begin >= end)
+      continue;
+    float *row = mCoverage+y*mStride;
+    // past the last visited cell the running sum is zero again, since the edges of a shape are closed:
+    if (begin < mArea.width())
+    {
+      quint32 *pixels = reinterpret_cast<quint32*>(mImage->scanLine(mArea.top()+y))+mArea.left();
+      compositeSpan(row+begin, pixels+begin, qMin(end, mArea.width())-begin, color, oddEven);
+    }
+    memset(row+begin, 0, (end-begin)*sizeof(float));
+  }
+}
+
+/*! \internal
+
+  Maps \a pointCount \a points with \a transform to device pixels and stores them in \a
+  devicePoints. \a bounds is set to the bounding rect of all finite points, or a null rect if there
+  are none. Returns false if any point has NaN or infinite coordinates.
+
+  \a transform must not rotate or shear (see \ref canRasterize).
+*/
+bool QCPRasterizer::mapToDevice(const QTransform &transform, const QPointF *points, int pointCount, QVector<QPointF> *devicePoints, QRectF *bounds)
+{
+  devicePoints->resize(pointCount);
+  QPointF *result = devicePoints->data();
+  double left = (std::numeric_limits<double>::max)();
+  double top = (std::numeric_limits<double>::max)();
+  double right = -(std::numeric_limits<double>::max)();
+  double bottom = -(std::numeric_limits<double>::max)();
+  bool allFinite = true;
+  for (int i=0; i<pointCount; ++i)
+  {
+    const double x = transform.m11()*points[i].x()+transform.dx();
+    const double y = transform.m22()*points[i].y()+transform.dy();
+    result[i] = QPointF(x, y);
+    if (qIsFinite(x) && qIsFinite(y))
+    {
+      left = qMin(left, x);
+      right = qMax(right, x);
+      top = qMin(top, y);
+      bottom = qMax(bottom, y);
+    } else
+      allFinite = false;
+  }
+  *bounds = left <= right ? QRectF(QPointF(left, top), QPointF(right, bottom)) : QRectF();
+  return allFinite;
+}
+
+/*! \internal
+
+  Returns \a color with its alpha multiplied by \a opacity as premultiplied ARGB32 pixel.
+*/
+quint32 QCPRasterizer::premultipliedColor(QColor color, double opacity)
+{
+  color.setAlphaF(color.alphaF()*opacity);
+  return multiplyPixel(color.rgba() | 0xff000000, quint32(color.alpha()));
+}
+
+/*! \internal
+
+  Returns the four channels of \a pixel multiplied by \a alpha/255, rounded to nearest like the
+  SSE2 path of \ref compositeSpan.
+*/
+quint32 QCPRasterizer::multiplyPixel(quint32 pixel, quint32 alpha)
+{
+  quint32 redBlue = (pixel & 0xff00ff)*alpha+0x800080;
+  redBlue = ((redBlue+((redBlue >> 8) & 0xff00ff)) >> 8) & 0xff00ff;
+  quint32 alphaGreen = ((pixel >> 8) & 0xff00ff)*alpha+0x800080;
+  alphaGreen = (alphaGreen+((alphaGreen >> 8) & 0xff00ff)) & 0xff00ff00;
+  return alphaGreen | redBlue;
+}
+
+/*! \internal
+
+  Turns the \a count accumulated area values \a coverage into the coverage of each pixel with a
+  running sum, and composites \a color with source-over onto \a pixels accordingly. \a color is a
+  premultiplied ARGB32 pixel. The running sum starts at zero.
+*/
+void QCPRasterizer::compositeSpan(const float *coverage, quint32 *pixels, int count, quint32 color, bool oddEven)
+{
+  int i = 0;
+  float sum = 0.0f;
+#ifdef QCP_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i rounding = _mm_set1_epi16(128);
+  const __m128i opaque = _mm_set1_epi16(255);
+  const __m128i source = _mm_unpacklo_epi8(_mm_set1_epi32(int(color)), zero);
+  const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 two = _mm_set1_ps(2.0f);
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 scale = _mm_set1_ps(255.0f);
+  __m128 carry = _mm_setzero_ps();
+  for (; i+4 <= count; i += 4)
+  {
+    // running sum of four cells, the last sum is carried over to the next four:
+    __m128 sums = _mm_loadu_ps(coverage+i);
+    sums = _mm_add_ps(sums, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(sums), 4)));
+    sums = _mm_add_ps(sums, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(sums), 8)));
+    sums = _mm_add_ps(sums, carry);
+    carry = _mm_shuffle_ps(sums, sums, _MM_SHUFFLE(3, 3, 3, 3));
+    __m128 alpha = _mm_and_ps(sums, absMask);
+    if (oddEven)
+    {
+      alpha = _mm_sub_ps(alpha, _mm_mul_ps(two, _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(alpha, half)))));
+      alpha = _mm_min_ps(alpha, _mm_sub_ps(two, alpha));
+    } else
+      alpha = _mm_min_ps(alpha, one);
+    const __m128i alpha32 = _mm_cvtps_epi32(_mm_mul_ps(alpha, scale));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha32, zero)) == 0xffff)
+      continue;
+    
+    // source-over of the four pixels, two pixels per register with 16 bits per channel:
+    const __m128i alpha16 = _mm_packs_epi32(alpha32, alpha32);
+    const __m128i alphaPairs = _mm_unpacklo_epi16(alpha16, alpha16);
+    const __m128i alphas[2] = {_mm_unpacklo_epi32(alphaPairs, alphaPairs), _mm_unpackhi_epi32(alphaPairs, alphaPairs)};
+    const __m128i destination = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels+i));
+    __m128i results[2] = {_mm_unpacklo_epi8(destination, zero), _mm_unpackhi_epi8(destination, zero)};
+    for (int k=0; k<2; ++k)
+    {
+      __m128i s = _mm_add_epi16(_mm_mullo_epi16(source, alphas[k]), rounding);
+      s = _mm_srli_epi16(_mm_add_epi16(s, _mm_srli_epi16(s, 8)), 8);
+      const __m128i sourceAlpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+      __m128i d = _mm_add_epi16(_mm_mullo_epi16(results[k], _mm_sub_epi16(opaque, sourceAlpha)), rounding);
+      d = _mm_srli_epi16(_mm_add_epi16(d, _mm_srli_epi16(d, 8)), 8);
+      results[k] = _mm_add_epi16(s, d);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels+i), _mm_packus_epi16(results[0], results[1]));
+  }
+  sum = _mm_cvtss_f32(carry);
+#endif
+  for (; i<count; ++i)
+  {
+    sum += coverage[i];
+    float alpha = qAbs(sum);
+    if (oddEven)
+    {
+      alpha -= 2.0f*int(alpha*0.5f);
+      alpha = qMin(alpha, 2.0f-alpha);
+    } else
+      alpha = qMin(alpha, 1.0f);
+    const quint32 alpha8 = quint32(alpha*255.0f+0.5f);
+    if (alpha8 == 0)
+      continue;
+    const quint32 source = multiplyPixel(color, alpha8);
+    pixels[i] = source+multiplyPixel(pixels[i], 255-(source >> 24));
+  }
+}
+
 /* end of 'src/paintbuffer.cpp' */
 
 
@@ -1100,7 +2404,11 @@ QCPLayer::~QCPLayer()
 */
 void QCPLayer::setVisible(bool visible)
 {
-  mVisible = visible;
+  if (mVisible != visible)
+  {
+    mVisible = visible;
+    markDirty();
+  }
 }
 
 /*!
@@ -1142,6 +2450,8 @@ void QCPLayer::setMode(QCPLayer::LayerMode mode)
 */
 void QCPLayer::draw(QCPPainter *painter)
 {
+  QCPReplotProfiler *profiler = mParentPlot->profiler();
+  QElapsedTimer drawTimer;
   foreach (QCPLayerable *child, mChildren)
   {
     if (child->realVisibility())
@@ -1149,7 +2459,11 @@ void QCPLayer::draw(QCPPainter *painter)
       painter->save();
       painter->setClipRect(child->clipRect().translated(0, -1));
       child->applyDefaultAntialiasingHint(painter);
+      if (profiler)
+        drawTimer.start();
       child->draw(painter);
+      if (profiler)
+        profiler->addDrawTime(child, this, drawTimer.nsecsElapsed()*1e-6);
       painter->restore();
     }
   }
@@ -1197,7 +2511,7 @@ void QCPLayer::drawToPaintBuffer()
 */
 void QCPLayer::replot()
 {
-  if (mMode == lmBuffered && !mParentPlot->hasInvalidatedPaintBuffers())
+  if (mMode == lmBuffered && !mParentPlot->hasInvalidatedPaintBuffers(mPaintBuffer.toStrongRef()))
   {
     if (QSharedPointer<QCPAbstractPaintBuffer> pb = mPaintBuffer.toStrongRef())
     {
@@ -1208,16 +2522,35 @@ void QCPLayer::replot()
     } else
       qDebug() << Q_FUNC_INFO << "no valid paint buffer associated with this layer";
   } else
+  {
+    markDirty(); // with QCP::phIncrementalReplot, the full replot only redraws invalidated paint buffers
     mParentPlot->replot();
+  }
 }
 
-/*! \internal
+/*!
+  Marks the contents of this layer as changed, by invalidating the paint buffer it is drawn into.
   
-  Adds the \a layerable to the list of this layer. If \a prepend is set to true, the layerable will
-  be prepended to the list, i.e. be drawn beneath the other layerables already in the list.
+  If the plotting hint \ref QCP::phIncrementalReplot is set, \ref QCustomPlot::replot only redraws
+  paint buffers that are invalidated, and keeps the contents of all others. Usually, layerables
+  mark their layer themselves (see \ref QCPLayerable::markDirty), so calling this method is only
+  necessary after changes that aren't tracked automatically.
   
-  This function does not change the \a mLayer member of \a layerable to this layer. (Use
-  QCPLayerable::setLayer to change the layer of an object, not this function.)
+  \see QCPAbstractPaintBuffer::setInvalidated
+*/
+void QCPLayer::markDirty()
+{
+  if (QSharedPointer<QCPAbstractPaintBuffer> pb = mPaintBuffer.toStrongRef())
+    pb->setInvalidated();
+}
+
+/*! \internal
+  
+  Adds the \a layerable to the list of this layer. If \a prepend is set to true, the layerable will
+  be prepended to the list, i.e. be drawn beneath the other layerables already in the list.
+  
+  This function does not change the \a mLayer member of \a layerable to this layer. (Use
+  QCPLayerable::setLayer to change the layer of an object, not this function.)
   
   \see removeChild
 */
@@ -1396,7 +2729,11 @@ QCPLayerable::~QCPLayerable()
 */
 void QCPLayerable::setVisible(bool on)
 {
-  mVisible = on;
+  if (mVisible != on)
+  {
+    mVisible = on;
+    markDirty();
+  }
 }
 
 /*!
@@ -1443,7 +2780,11 @@ bool QCPLayerable::setLayer(const QString &layerName)
 */
 void QCPLayerable::setAntialiased(bool enabled)
 {
-  mAntialiased = enabled;
+  if (mAntialiased != enabled)
+  {
+    mAntialiased = enabled;
+    markDirty();
+  }
 }
 
 /*!
@@ -1461,6 +2802,23 @@ bool QCPLayerable::realVisibility() const
   return mVisible && (!mLayer || mLayer->visible()) && (!mParentLayerable || mParentLayerable.data()->realVisibility());
 }
 
+/*!
+  Marks the layer of this layerable as changed, so the next \ref QCustomPlot::replot redraws it when
+  the plotting hint \ref QCP::phIncrementalReplot is set.
+  
+  The layerables call this method themselves for the changes that the incremental replot tracks:
+  visibility and antialiasing, the pen, brush, selection and data of plottables, the line and
+  scatter style of graphs, the positions and selection of items, and the selection of axes.
+  Changes of the layout, the viewport and the axis ranges cause a redraw of all layers. After any
+  other change, e.g. of a font or a tick label format, call this method (or \ref
+  QCPLayer::markDirty) before replotting.
+*/
+void QCPLayerable::markDirty()
+{
+  if (mLayer)
+    mLayer->markDirty();
+}
+
 /*!
   This function is used to decide whether a click hits a layerable object or not.
 
@@ -5458,6 +6816,117 @@ void QCPLineEnding::draw(QCPPainter *painter, const QCPVector2D &pos, double ang
 /* modified 2022-11-06T12:45:56, size 27519   */
 
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPLabelCache
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPLabelCache
+  \brief Process-wide cache of rendered tick labels
+
+  The axis painters render tick labels once into images and then only blit the images, as long as
+  \ref QCP::phCacheLabels is set. This cache holds those images for all axes of all QCustomPlot
+  instances, so a label with the same text and appearance is rendered only once, no matter how
+  many plots show it.
+
+  The cache key of a label contains everything its image depends on: the text, font, color,
+  rotation, device pixel ratio and the number format settings of the axis. Changing the font or
+  color of an axis therefore doesn't invalidate any cached labels, it just uses other ones.
+
+  Access is serialized with a mutex, and the labels are QImages, so the cache can be used from the
+  worker threads of \ref QCP::phParallelLayers. The least recently used labels are discarded when
+  the total size of the cached images exceeds \ref setMaximumSize.
+*/
+
+/*! \internal
+  
+  Creates the cache with a maximum size of 8 MB. Use \ref instance to access the process-wide
+  cache.
+*/
+QCPLabelCache::QCPLabelCache() :
+  mLabels(8192)
+{
+}
+
+/*!
+  Returns the process-wide label cache.
+*/
+QCPLabelCache *QCPLabelCache::instance()
+{
+  static QCPLabelCache cache;
+  return &cache;
+}
+
+/*!
+  Returns the maximum total size of all cached label images in kilobytes.
+  
+  \see setMaximumSize
+*/
+int QCPLabelCache::maximumSize() const
+{
+  QMutexLocker locker(&mMutex);
+  return mLabels.maxCost();
+}
+
+/*!
+  Sets the maximum total size of all cached label images in \a kilobytes. If a new label doesn't
+  fit, the least recently used labels are discarded.
+*/
+void QCPLabelCache::setMaximumSize(int kilobytes)
+{
+  QMutexLocker locker(&mMutex);
+  mLabels.setMaxCost(qMax(1, kilobytes));
+}
+
+/*!
+  Looks up the label with the specified \a key. If it is cached, copies it to \a label and
+  returns true. Otherwise returns false and leaves \a label unchanged.
+*/
+bool QCPLabelCache::find(const QByteArray &key, Label *label)
+{
+  QMutexLocker locker(&mMutex);
+  if (const Label *cached = mLabels.object(key))
+  {
+    *label = *cached;
+    return true;
+  }
+  return false;
+}
+
+/*!
+  Inserts the \a label under \a key, replacing a label that was cached with the same key.
+*/
+void QCPLabelCache::insert(const QByteArray &key, const Label &label)
+{
+  const int cost = qMax(1, label.image.bytesPerLine()*label.image.height()/1024);
+  QMutexLocker locker(&mMutex);
+  mLabels.insert(key, new Label(label), cost);
+}
+
+/*!
+  Discards all cached labels.
+*/
+void QCPLabelCache::clear()
+{
+  QMutexLocker locker(&mMutex);
+  mLabels.clear();
+}
+
+/*!
+  Returns a transparent image suitable for rendering a label of the logical \a size, i.e. with
+  \a size multiplied by \a devicePixelRatio pixels and the corresponding device pixel ratio set.
+*/
+QImage QCPLabelCache::createImage(const QSize &size, double devicePixelRatio)
+{
+  QImage result(size*devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
+  result.setDevicePixelRatio(devicePixelRatio);
+#endif
+  result.fill(Qt::transparent);
+  return result;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////// QCPLabelPainterPrivate
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -5491,8 +6960,7 @@ QCPLabelPainterPrivate::QCPLabelPainterPrivate(QCustomPlot *parentPlot) :
   mSubstituteExponent(true),
   mMultiplicationSymbol(QChar(215)),
   mAbbreviateDecimalPowers(false),
-  mParentPlot(parentPlot),
-  mLabelCache(16)
+  mParentPlot(parentPlot)
 {
   analyzeFontMetrics();
 }
@@ -5560,16 +7028,6 @@ void QCPLabelPainterPrivate::setAbbreviateDecimalPowers(bool enabled)
   mAbbreviateDecimalPowers = enabled;
 }
 
-void QCPLabelPainterPrivate::setCacheSize(int labelCount)
-{
-  mLabelCache.setMaxCost(labelCount);
-}
-
-int QCPLabelPainterPrivate::cacheSize() const
-{
-  return mLabelCache.maxCost();
-}
-
 void QCPLabelPainterPrivate::drawTickLabel(QCPPainter *painter, const QPointF &tickPos, const QString &text)
 {
   double realRotation = mRotation;
@@ -5632,38 +7090,7 @@ int QCPLabelPainterPrivate::size() const
 
 /*! \internal
   
-  Clears the internal label cache. Upon the next \ref draw, all labels will be created new. This
-  method is called automatically if any parameters have changed that invalidate the cached labels,
-  such as font, color, etc. Usually you won't need to call this method manually.
-*/
-void QCPLabelPainterPrivate::clearCache()
-{
-  mLabelCache.clear();
-}
-
-/*! \internal
-  
-  Returns a hash that allows uniquely identifying whether the label parameters have changed such
-  that the cached labels must be refreshed (\ref clearCache). It is used in \ref draw. If the
-  return value of this method hasn't changed since the last redraw, the respective label parameters
-  haven't changed and cached labels may be used.
-*/
-QByteArray QCPLabelPainterPrivate::generateLabelParameterHash() const
-{
-  QByteArray result;
-  result.append(QByteArray::number(mParentPlot->bufferDevicePixelRatio()));
-  result.append(QByteArray::number(mRotation));
-  //result.append(QByteArray::number(int(tickLabelSide))); TODO: check whether this is really a cache-invalidating property
-  result.append(QByteArray::number(int(mSubstituteExponent)));
-  result.append(QString(mMultiplicationSymbol).toUtf8());
-  result.append(mColor.name().toLatin1()+QByteArray::number(mColor.alpha(), 16));
-  result.append(mFont.toString().toLatin1());
-  return result;
-}
-
-/*! \internal
-  
-  Draws a single tick label with the provided \a painter, utilizing the internal label cache to
+  Draws a single tick label with the provided \a painter, utilizing the shared \ref QCPLabelCache to
   significantly speed up drawing of labels that were drawn in previous calls. The tick label is
   always bound to an axis, the distance to the axis is controllable via \a distanceToAxis in
   pixels. The pixel position in the axis direction is passed in the \a position parameter. Hence
@@ -5688,12 +7115,16 @@ void QCPLabelPainterPrivate::drawLabelMaybeCached(QCPPainter *painter, const QFo
 
   if (mParentPlot->plottingHints().testFlag(QCP::phCacheLabels) && !painter->modes().testFlag(QCPPainter::pmNoCaching)) // label caching enabled
   {
-    QByteArray key = cacheKey(text, color, rotation, side);
-    CachedLabel *cachedLabel = mLabelCache.take(QString::fromUtf8(key)); // attempt to take label from cache (don't use object() because we want ownership/prevent deletion during our operations, we re-insert it afterwards)
-    if (!cachedLabel)  // no cached label existed, create it
+    const QByteArray key = cacheKey(font, text, color, rotation, side);
+    QCPLabelCache::Label cachedLabel;
+    const bool cached = QCPLabelCache::instance()->find(key, &cachedLabel);
+    if (QCPReplotProfiler *profiler = mParentPlot->profiler())
+      profiler->addLabelCacheLookup(cached);
+    if (!cached)  // no cached label existed, create it
     {
       LabelData labelData = getTickLabelData(font, color, rotation, side, text);
       cachedLabel = createCachedLabel(labelData);
+      QCPLabelCache::instance()->insert(key, cachedLabel);
     }
     // if label would be partly clipped by widget border on sides, don't draw it (only for outside tick labels):
     bool labelClippedByBorder = false;
@@ -5708,10 +7139,9 @@ void QCPLabelPainterPrivate::drawLabelMaybeCached(QCPPainter *painter, const QFo
     */
     if (!labelClippedByBorder)
     {
-      painter->drawPixmap(pos+cachedLabel->offset, cachedLabel->pixmap);
-      finalSize = cachedLabel->pixmap.size()/mParentPlot->bufferDevicePixelRatio(); // TODO: collect this in a member rect list?
+      painter->drawImage(pos+cachedLabel.offset, cachedLabel.image);
+      finalSize = cachedLabel.image.size()/mParentPlot->bufferDevicePixelRatio(); // TODO: collect this in a member rect list?
     }
-    mLabelCache.insert(QString::fromUtf8(key), cachedLabel);
   } else // label caching disabled, draw text directly on surface:
   {
     LabelData labelData = getTickLabelData(font, color, rotation, side, text);
@@ -5957,40 +7387,41 @@ void QCPLabelPainterPrivate::getMaxTickLabelSize(const QFont &font, const QStrin
 }
 */
 
-QCPLabelPainterPrivate::CachedLabel *QCPLabelPainterPrivate::createCachedLabel(const LabelData &labelData) const
+QCPLabelCache::Label QCPLabelPainterPrivate::createCachedLabel(const LabelData &labelData) const
 {
-  CachedLabel *result = new CachedLabel;
+  QCPLabelCache::Label result;
   
-  // allocate pixmap with the correct size and pixel ratio:
-  if (!qFuzzyCompare(1.0, mParentPlot->bufferDevicePixelRatio()))
-  {
-    result->pixmap = QPixmap(labelData.rotatedTotalBounds.size()*mParentPlot->bufferDevicePixelRatio());
-#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
-#  ifdef QCP_DEVICEPIXELRATIO_FLOAT
-    result->pixmap.setDevicePixelRatio(mParentPlot->devicePixelRatioF());
-#  else
-    result->pixmap.setDevicePixelRatio(mParentPlot->devicePixelRatio());
-#  endif
-#endif
-  } else
-    result->pixmap = QPixmap(labelData.rotatedTotalBounds.size());
-  result->pixmap.fill(Qt::transparent);
+  // allocate image with the correct size and pixel ratio:
+  result.image = QCPLabelCache::createImage(labelData.rotatedTotalBounds.size(), mParentPlot->bufferDevicePixelRatio());
   
-  // draw the label into the pixmap
-  // offset is between label anchor and topleft of cache pixmap, so pixmap can be drawn at pos+offset to make the label anchor appear at pos.
+  // draw the label into the image
+  // offset is between label anchor and topleft of cache image, so image can be drawn at pos+offset to make the label anchor appear at pos.
   // We use rotatedTotalBounds.topLeft() because rotatedTotalBounds is in a coordinate system where the label anchor is at (0, 0)
-  result->offset = labelData.rotatedTotalBounds.topLeft();
-  QCPPainter cachePainter(&result->pixmap);
-  drawText(&cachePainter, -result->offset, labelData);
+  result.offset = labelData.rotatedTotalBounds.topLeft();
+  QCPPainter cachePainter(&result.image);
+  drawText(&cachePainter, -result.offset, labelData);
   return result;
 }
 
-QByteArray QCPLabelPainterPrivate::cacheKey(const QString &text, const QColor &color, double rotation, AnchorSide side) const
+/*! \internal
+  
+  Returns the key of the label with \a text in the shared \ref QCPLabelCache. Besides the
+  arguments, it contains the device pixel ratio and the properties of this label painter that
+  change the label image, so labels of different label painters are only shared if they look the
+  same.
+*/
+QByteArray QCPLabelPainterPrivate::cacheKey(const QFont &font, const QString &text, const QColor &color, double rotation, AnchorSide side) const
 {
-  return text.toUtf8()+
-      QByteArray::number(color.red()+256*color.green()+65536*color.blue(), 36)+
-      QByteArray::number(color.alpha()+256*int(side), 36)+
-      QByteArray::number(int(rotation*100), 36);
+  QByteArray result = "labelpainter";
+  result.append(QByteArray::number(mParentPlot->bufferDevicePixelRatio())+' ');
+  result.append(QByteArray::number(color.rgba(), 36)+' ');
+  result.append(QByteArray::number(int(side))+' ');
+  result.append(QByteArray::number(int(rotation*100), 36)+' ');
+  result.append(QByteArray::number(int(mSubstituteExponent))+QByteArray::number(int(mAbbreviateDecimalPowers)));
+  result.append(QString(mMultiplicationSymbol).toUtf8());
+  result.append(font.toString().toUtf8()+'\n');
+  result.append(text.toUtf8());
+  return result;
 }
 
 QCPLabelPainterPrivate::AnchorSide QCPLabelPainterPrivate::skewedAnchorSide(const QPointF &tickPos, double sideExpandHorz, double sideExpandVert) const
@@ -7719,6 +9150,11 @@ QString QCPAxisTickerPi::unicodeSubscript(int number) const
   new ticks would appear, leading to very sparse or even no axis ticks on the axis. To prevent this
   situation, this ticker falls back to regular tick generation if the axis range would be covered
   by too few logarithmically placed ticks.
+  
+  Axes call \ref generate on every replot. As long as the axis range only shifts or zooms such
+  that the first tick power and the power step stay the same, the ticker reuses the tick and sub
+  tick vectors and the formatted tick labels of the previous call and only trims them to the new
+  range.
 */
 
 /*!
@@ -7728,7 +9164,13 @@ QString QCPAxisTickerPi::unicodeSubscript(int number) const
 QCPAxisTickerLog::QCPAxisTickerLog() :
   mLogBase(10.0),
   mSubTickCount(8), // generates 10 intervals
-  mLogBaseLnInv(1.0/qLn(mLogBase))
+  mLogBaseLnInv(1.0/qLn(mLogBase)),
+  mTicksCached(false),
+  mLabelsCached(false),
+  mCachedPositive(true),
+  mCachedPowerStep(0),
+  mCachedFirstPower(0),
+  mCachedPrecision(0)
 {
 }
 
@@ -7742,6 +9184,7 @@ void QCPAxisTickerLog::setLogBase(double base)
   {
     mLogBase = base;
     mLogBaseLnInv = 1.0/qLn(mLogBase);
+    mTicksCached = false;
   } else
     qDebug() << Q_FUNC_INFO << "log base has to be greater than zero:" << base;
 }
@@ -7759,11 +9202,89 @@ void QCPAxisTickerLog::setLogBase(double base)
 void QCPAxisTickerLog::setSubTickCount(int subTicks)
 {
   if (subTicks >= 0)
+  {
     mSubTickCount = subTicks;
-  else
+    mTicksCached = false;
+  } else
     qDebug() << Q_FUNC_INFO << "sub tick count can't be negative:" << subTicks;
 }
 
+/*!
+  Generates the ticks, sub ticks and tick labels like \ref QCPAxisTicker::generate, but reuses the
+  results of the previous call if possible.
+  
+  The untrimmed tick vector of \ref createTickVector only depends on the power step, the power of
+  the first tick and the tick at which the generation stops, i.e. the first tick beyond \a
+  range.upper. Those are determined with a few logarithms, and if they match the cached tick
+  vector, the cached ticks, sub ticks and labels (for the same \a locale, \a formatChar and \a
+  precision) are only trimmed to \a range. This makes panning and zooming within the same decades
+  cheap, since neither the powers nor the sub ticks have to be recalculated, and no label has to be
+  formatted again.
+  
+  If the range is covered by too few logarithmically placed ticks, the regular tick generation of
+  the base class is used, without caching.
+  
+  \seebaseclassmethod
+*/
+void QCPAxisTickerLog::generate(const QCPRange &range, const QLocale &locale, QChar formatChar, int precision, QVector<double> &ticks, QVector<double> *subTicks, QVector<QString> *tickLabels)
+{
+  // determine the power step and the power of the first tick like createTickVector does:
+  const bool positive = range.lower > 0 && range.upper > 0;
+  double baseTickCount = 0;
+  if (positive)
+    baseTickCount = qLn(range.upper/range.lower)*mLogBaseLnInv;
+  else if (range.lower < 0 && range.upper < 0)
+    baseTickCount = qLn(range.lower/range.upper)*mLogBaseLnInv;
+  if (baseTickCount < 1.6) // regular tick generation or invalid range, nothing to reuse
+  {
+    mTicksCached = false;
+    QCPAxisTicker::generate(range, locale, formatChar, precision, ticks, subTicks, tickLabels);
+    return;
+  }
+  const int powerStep = qMax(int(cleanMantissa(baseTickCount/double(mTickCount+1e-10))), 1);
+  const double newLogBaseLn = qLn(qPow(mLogBase, powerStep));
+  const int firstPower = positive ? qFloor(qLn(range.lower)/newLogBaseLn) : qCeil(qLn(-range.lower)/newLogBaseLn);
+  
+  // the cached ticks are valid, if createTickVector would have stopped at the same last tick:
+  const int cachedCount = mCachedTicks.size();
+  const bool reuseTicks = mTicksCached && positive == mCachedPositive && powerStep == mCachedPowerStep && firstPower == mCachedFirstPower &&
+      cachedCount > 1 && mCachedTicks.at(cachedCount-1) >= range.upper && mCachedTicks.at(cachedCount-2) < range.upper;
+  if (!reuseTicks)
+  {
+    const double tickStep = getTickStep(range);
+    mCachedTicks = createTickVector(tickStep, range);
+    mCachedSubTicks = createSubTickVector(getSubTickCount(tickStep), mCachedTicks);
+    mCachedPositive = positive;
+    mCachedPowerStep = powerStep;
+    mCachedFirstPower = firstPower;
+    mTicksCached = true;
+    mLabelsCached = false;
+  }
+  
+  // trim the cached vectors to the range. Sub ticks between ticks outside the range are also
+  // outside, so this is equivalent to creating the sub ticks from the trimmed ticks:
+  ticks = mCachedTicks;
+  trimTicks(range, ticks, false);
+  if (subTicks)
+  {
+    *subTicks = mCachedSubTicks;
+    trimTicks(range, *subTicks, false);
+  }
+  if (tickLabels)
+  {
+    if (!mLabelsCached || locale != mCachedLocale || formatChar != mCachedFormatChar || precision != mCachedPrecision)
+    {
+      mCachedLabels = createLabelVector(mCachedTicks, locale, formatChar, precision);
+      mCachedLocale = locale;
+      mCachedFormatChar = formatChar;
+      mCachedPrecision = precision;
+      mLabelsCached = true;
+    }
+    const int firstVisible = int(std::lower_bound(mCachedTicks.constBegin(), mCachedTicks.constEnd(), range.lower)-mCachedTicks.constBegin());
+    *tickLabels = mCachedLabels.mid(firstVisible, ticks.size());
+  }
+}
+
 /*! \internal
   
   Returns the sub tick count specified in \ref setSubTickCount. For QCPAxisTickerLog, there is no
@@ -8443,6 +9964,7 @@ void QCPAxis::setSelectedParts(const SelectableParts &selected)
   if (mSelectedParts != selected)
   {
     mSelectedParts = selected;
+    markDirty();
     emit selectionChanged(mSelectedParts);
   }
 }
@@ -9349,6 +10871,161 @@ double QCPAxis::coordToPixel(double value) const
   }
 }
 
+/*!
+  Transforms the \a count values in \a coords, in coordinates of the axis, to pixel coordinates of
+  the QCustomPlot widget and writes them to \a pixels. The result is the same as calling \ref
+  coordToPixel for each value.
+
+  Use this method when many coordinates need to be transformed, e.g. when converting the data of a
+  plottable to pixels. The distinction between orientation, scale type and range reversal is made
+  only once, and the transform is reduced to a multiply-add per value. For linear axes, two values
+  are transformed per SSE2 instruction where available (\c QCP_SSE2). For logarithmic axes, the
+  logarithms are computed two at a time by \ref logPd, too. Only values that aren't positive,
+  normal and finite (including NaN) are transformed individually like in \ref coordToPixel.
+*/
+void QCPAxis::coordsToPixels(const double *coords, double *pixels, int count) const
+{
+  double offset, scale, logSign, invalidPixel;
+  getPixelTransform(offset, scale, logSign, invalidPixel);
+  if (mScaleType == stLinear)
+  {
+    int i = 0;
+#ifdef QCP_SSE2
+    const __m128d offsetPd = _mm_set1_pd(offset);
+    const __m128d scalePd = _mm_set1_pd(scale);
+    for (; i+2<=count; i+=2)
+      _mm_storeu_pd(pixels+i, _mm_add_pd(offsetPd, _mm_mul_pd(scalePd, _mm_loadu_pd(coords+i))));
+#endif
+    for (; i<count; ++i)
+      pixels[i] = offset+scale*coords[i];
+  } else // mScaleType == stLogarithmic
+  {
+    int i = 0;
+#ifdef QCP_SSE2
+    const __m128d offsetPd = _mm_set1_pd(offset);
+    const __m128d scalePd = _mm_set1_pd(scale);
+    const __m128d logSignPd = _mm_set1_pd(logSign);
+    const __m128d minNormal = _mm_set1_pd((std::numeric_limits<double>::min)());
+    const __m128d maxFinite = _mm_set1_pd((std::numeric_limits<double>::max)());
+    for (; i+2<=count; i+=2)
+    {
+      const __m128d values = _mm_mul_pd(logSignPd, _mm_loadu_pd(coords+i));
+      _mm_storeu_pd(pixels+i, _mm_add_pd(offsetPd, _mm_mul_pd(scalePd, logPd(values))));
+      // values logPd can't handle (non-positive, denormal, infinite or NaN) are redone individually:
+      const int special = _mm_movemask_pd(_mm_or_pd(_mm_cmpnge_pd(values, minNormal), _mm_cmpgt_pd(values, maxFinite)));
+      for (int k=0; k<2; ++k)
+      {
+        if (special & (1<<k))
+        {
+          const double value = logSign*coords[i+k];
+          pixels[i+k] = value <= 0.0 ? invalidPixel : offset+scale*qLn(value); // NaN values stay NaN
+        }
+      }
+    }
+#endif
+    for (; i<count; ++i)
+    {
+      const double value = logSign*coords[i];
+      pixels[i] = value <= 0.0 ? invalidPixel : offset+scale*qLn(value); // NaN values stay NaN
+    }
+  }
+}
+
+/*! \overload
+
+  Transforms \a count coordinates to pixels and writes them to the points in \a pixels. The
+  coordinates are read from \a coords with a distance of \a coordStride doubles, so they may be
+  members of data point structures, e.g. the keys of an array of \ref QCPGraphData with a stride of
+  2.
+
+  Only the pixel coordinate that corresponds to the orientation of this axis is written, i.e. the x
+  coordinate for horizontal axes and the y coordinate for vertical axes. A plottable can thus fill
+  its pixel points by calling this method once on its key axis and once on its value axis.
+
+  As with the contiguous overload, two values are transformed per SSE2 instruction where available,
+  on logarithmic axes including the logarithm. The strided coordinates are gathered into and the
+  results scattered from SSE2 registers, so this is slower than the contiguous overload, but avoids
+  copying the coordinates.
+*/
+void QCPAxis::coordsToPixels(const double *coords, int coordStride, QPointF *pixels, int count) const
+{
+  double offset, scale, logSign, invalidPixel;
+  getPixelTransform(offset, scale, logSign, invalidPixel);
+  if (mScaleType == stLinear)
+  {
+    int i = 0;
+#ifdef QCP_SSE2
+    if (sizeof(qreal) == sizeof(double) && count >= 2)
+    {
+      const __m128d offsetPd = _mm_set1_pd(offset);
+      const __m128d scalePd = _mm_set1_pd(scale);
+      double *target = reinterpret_cast<double*>(orientation() == Qt::Horizontal ? &pixels->rx() : &pixels->ry()); // QPointF holds x and y as consecutive qreals
+      for (; i+2<=count; i+=2)
+      {
+        const __m128d result = _mm_add_pd(offsetPd, _mm_mul_pd(scalePd, _mm_set_pd(coords[(i+1)*coordStride], coords[i*coordStride])));
+        _mm_storel_pd(target+2*i, result);
+        _mm_storeh_pd(target+2*i+2, result);
+      }
+    }
+#endif
+    if (orientation() == Qt::Horizontal)
+    {
+      for (; i<count; ++i)
+        pixels[i].rx() = offset+scale*coords[i*coordStride];
+    } else
+    {
+      for (; i<count; ++i)
+        pixels[i].ry() = offset+scale*coords[i*coordStride];
+    }
+  } else // mScaleType == stLogarithmic
+  {
+    int i = 0;
+#ifdef QCP_SSE2
+    if (sizeof(qreal) == sizeof(double) && count >= 2)
+    {
+      const __m128d offsetPd = _mm_set1_pd(offset);
+      const __m128d scalePd = _mm_set1_pd(scale);
+      const __m128d logSignPd = _mm_set1_pd(logSign);
+      const __m128d minNormal = _mm_set1_pd((std::numeric_limits<double>::min)());
+      const __m128d maxFinite = _mm_set1_pd((std::numeric_limits<double>::max)());
+      double *target = reinterpret_cast<double*>(orientation() == Qt::Horizontal ? &pixels->rx() : &pixels->ry()); // QPointF holds x and y as consecutive qreals
+      for (; i+2<=count; i+=2)
+      {
+        const __m128d values = _mm_mul_pd(logSignPd, _mm_set_pd(coords[(i+1)*coordStride], coords[i*coordStride]));
+        const __m128d result = _mm_add_pd(offsetPd, _mm_mul_pd(scalePd, logPd(values)));
+        _mm_storel_pd(target+2*i, result);
+        _mm_storeh_pd(target+2*i+2, result);
+        // values logPd can't handle (non-positive, denormal, infinite or NaN) are redone individually:
+        const int special = _mm_movemask_pd(_mm_or_pd(_mm_cmpnge_pd(values, minNormal), _mm_cmpgt_pd(values, maxFinite)));
+        for (int k=0; k<2; ++k)
+        {
+          if (special & (1<<k))
+          {
+            const double value = logSign*coords[(i+k)*coordStride];
+            target[2*(i+k)] = value <= 0.0 ? invalidPixel : offset+scale*qLn(value);
+          }
+        }
+      }
+    }
+#endif
+    if (orientation() == Qt::Horizontal)
+    {
+      for (; i<count; ++i)
+      {
+        const double value = logSign*coords[i*coordStride];
+        pixels[i].rx() = value <= 0.0 ? invalidPixel : offset+scale*qLn(value);
+      }
+    } else
+    {
+      for (; i<count; ++i)
+      {
+        const double value = logSign*coords[i*coordStride];
+        pixels[i].ry() = value <= 0.0 ? invalidPixel : offset+scale*qLn(value);
+      }
+    }
+  }
+}
+
 /*!
   Returns the part of the axis that is hit by \a pos (in pixels). The return value of this function
   is independent of the user-selectable parts defined with \ref setSelectableParts. Further, this
@@ -9741,6 +11418,85 @@ void QCPAxis::setupTickVectors()
   mCachedMarginValid &= mTickVectorLabels == oldLabels; // if labels have changed, margin might have changed, too
 }
 
+/*! \internal
+
+  Returns the constants of the transform used by \ref coordsToPixels. For linear axes, the pixel
+  coordinate of a value \a x is <tt>offset+scale*x</tt>. For logarithmic axes, it is
+  <tt>offset+scale*ln(logSign*x)</tt>, where \a logSign is -1 for negative ranges. Values that
+  can't be displayed on the logarithmic axis are mapped to \a invalidPixel outside the axis rect,
+  like \ref coordToPixel does.
+*/
+void QCPAxis::getPixelTransform(double &offset, double &scale, double &logSign, double &invalidPixel) const
+{
+  // the pixel coordinate is origin+length*t, where t is the normalized position in the range:
+  double origin, length;
+  if (orientation() == Qt::Horizontal)
+  {
+    origin = !mRangeReversed ? mAxisRect->left() : mAxisRect->left()+mAxisRect->width();
+    length = !mRangeReversed ? mAxisRect->width() : -mAxisRect->width();
+  } else
+  {
+    origin = !mRangeReversed ? mAxisRect->bottom() : mAxisRect->bottom()-mAxisRect->height();
+    length = !mRangeReversed ? -mAxisRect->height() : mAxisRect->height();
+  }
+  
+  if (mScaleType == stLinear)
+  {
+    scale = length/mRange.size();
+    offset = origin-scale*mRange.lower;
+    logSign = 1;
+    invalidPixel = 0;
+  } else // mScaleType == stLogarithmic
+  {
+    logSign = mRange.upper < 0.0 ? -1 : 1;
+    scale = length/qLn(mRange.upper/mRange.lower);
+    offset = origin-scale*qLn(logSign*mRange.lower);
+    // values with the wrong sign are drawn outside the visible range, see coordToPixel:
+    const bool towardsLower = (logSign > 0) != mRangeReversed;
+    if (orientation() == Qt::Horizontal)
+      invalidPixel = towardsLower ? mAxisRect->left()-200 : mAxisRect->right()+200;
+    else
+      invalidPixel = towardsLower ? mAxisRect->bottom()+200 : mAxisRect->top()-200;
+  }
+}
+
+#ifdef QCP_SSE2
+/*! \internal
+
+  Returns the natural logarithms of the two values in \a x, which must be positive, normal and
+  finite. This is the logarithm kernel of \ref coordsToPixels for logarithmic axes.
+
+  The binary exponent \a e is taken from the bits of the values, so ln(x) = e*ln(2)+ln(m) with the
+  mantissa \a m normalized to [sqrt(1/2), sqrt(2)). The logarithm of the mantissa is evaluated as
+  2*atanh(s) with s = (m-1)/(m+1), whose series is truncated after the s^13 term. The absolute
+  error is below 1e-12, far below a pixel even for strongly zoomed axes.
+*/
+__m128d QCPAxis::logPd(__m128d x)
+{
+  const __m128d one = _mm_set1_pd(1.0);
+  // mantissa bits combined with the exponent of 1.0 give m in [1, 2):
+  __m128d mantissa = _mm_or_pd(_mm_and_pd(x, _mm_castsi128_pd(_mm_set_epi32(0x000FFFFF, -1, 0x000FFFFF, -1))), one);
+  // biased exponents moved to the lower two 32 bit lanes for conversion (the sign bits are zero):
+  const __m128i biasedExponent = _mm_shuffle_epi32(_mm_srli_epi64(_mm_castpd_si128(x), 52), _MM_SHUFFLE(3, 1, 2, 0));
+  __m128d exponent = _mm_sub_pd(_mm_cvtepi32_pd(biasedExponent), _mm_set1_pd(1023.0));
+  // move m from [sqrt(2), 2) to [sqrt(1/2), 1) to keep |s| small:
+  const __m128d large = _mm_cmpgt_pd(mantissa, _mm_set1_pd(1.4142135623730951));
+  mantissa = _mm_mul_pd(mantissa, _mm_or_pd(_mm_and_pd(large, _mm_set1_pd(0.5)), _mm_andnot_pd(large, one)));
+  exponent = _mm_add_pd(exponent, _mm_and_pd(large, one));
+  
+  const __m128d s = _mm_div_pd(_mm_sub_pd(mantissa, one), _mm_add_pd(mantissa, one));
+  const __m128d z = _mm_mul_pd(s, s);
+  __m128d series = _mm_set1_pd(1.0/13.0);
+  series = _mm_add_pd(_mm_mul_pd(series, z), _mm_set1_pd(1.0/11.0));
+  series = _mm_add_pd(_mm_mul_pd(series, z), _mm_set1_pd(1.0/9.0));
+  series = _mm_add_pd(_mm_mul_pd(series, z), _mm_set1_pd(1.0/7.0));
+  series = _mm_add_pd(_mm_mul_pd(series, z), _mm_set1_pd(1.0/5.0));
+  series = _mm_add_pd(_mm_mul_pd(series, z), _mm_set1_pd(1.0/3.0));
+  series = _mm_add_pd(_mm_mul_pd(series, z), one);
+  return _mm_add_pd(_mm_mul_pd(exponent, _mm_set1_pd(0.69314718055994531)), _mm_mul_pd(_mm_add_pd(s, s), series));
+}
+#endif
+
 /*! \internal
   
   Returns the pen that is used to draw the axis base line. Depending on the selection state, this
@@ -9915,8 +11671,7 @@ QCPAxisPainterPrivate::QCPAxisPainterPrivate(QCustomPlot *parentPlot) :
   offset(0),
   abbreviateDecimalPowers(false),
   reversedEndings(false),
-  mParentPlot(parentPlot),
-  mLabelCache(16) // cache at most 16 (tick) labels
+  mParentPlot(parentPlot)
 {
 }
 
@@ -9933,12 +11688,7 @@ QCPAxisPainterPrivate::~QCPAxisPainterPrivate()
 */
 void QCPAxisPainterPrivate::draw(QCPPainter *painter)
 {
-  QByteArray newHash = generateLabelParameterHash();
-  if (newHash != mLabelParameterHash)
-  {
-    mLabelCache.clear();
-    mLabelParameterHash = newHash;
-  }
+  mLabelParameterHash = generateLabelParameterHash();
   
   QPoint origin;
   switch (type)
@@ -10128,12 +11878,7 @@ int QCPAxisPainterPrivate::size()
 {
   int result = 0;
 
-  QByteArray newHash = generateLabelParameterHash();
-  if (newHash != mLabelParameterHash)
-  {
-    mLabelCache.clear();
-    mLabelParameterHash = newHash;
-  }
+  mLabelParameterHash = generateLabelParameterHash();
   
   // get length of tick marks pointing outwards:
   if (!tickPositions.isEmpty())
@@ -10166,38 +11911,29 @@ int QCPAxisPainterPrivate::size()
 
 /*! \internal
   
-  Clears the internal label cache. Upon the next \ref draw, all labels will be created new. This
-  method is called automatically in \ref draw, if any parameters have changed that invalidate the
-  cached labels, such as font, color, etc.
-*/
-void QCPAxisPainterPrivate::clearCache()
-{
-  mLabelCache.clear();
-}
-
-/*! \internal
-  
-  Returns a hash that allows uniquely identifying whether the label parameters have changed such
-  that the cached labels must be refreshed (\ref clearCache). It is used in \ref draw. If the
-  return value of this method hasn't changed since the last redraw, the respective label parameters
-  haven't changed and cached labels may be used.
+  Returns the part of the keys in the shared \ref QCPLabelCache that is common to all tick labels
+  of this axis, i.e. all parameters the label images depend on except their text. It is updated in
+  \ref draw and \ref size. The label text is appended to get the key of a single label, so axes
+  of other plots with the same label parameters share the cached labels.
 */
 QByteArray QCPAxisPainterPrivate::generateLabelParameterHash() const
 {
-  QByteArray result;
-  result.append(QByteArray::number(mParentPlot->bufferDevicePixelRatio()));
-  result.append(QByteArray::number(tickLabelRotation));
+  QByteArray result = "axispainter";
+  result.append(QByteArray::number(mParentPlot->bufferDevicePixelRatio())+' ');
+  result.append(QByteArray::number(tickLabelRotation)+' ');
+  result.append(QByteArray::number(int(type)));
   result.append(QByteArray::number(int(tickLabelSide)));
   result.append(QByteArray::number(int(substituteExponent)));
   result.append(QByteArray::number(int(numberMultiplyCross)));
-  result.append(tickLabelColor.name().toLatin1()+QByteArray::number(tickLabelColor.alpha(), 16));
-  result.append(tickLabelFont.toString().toLatin1());
+  result.append(QByteArray::number(int(abbreviateDecimalPowers))+' ');
+  result.append(QByteArray::number(tickLabelColor.rgba(), 36)+' ');
+  result.append(tickLabelFont.toString().toUtf8()+'\n');
   return result;
 }
 
 /*! \internal
   
-  Draws a single tick label with the provided \a painter, utilizing the internal label cache to
+  Draws a single tick label with the provided \a painter, utilizing the shared \ref QCPLabelCache to
   significantly speed up drawing of labels that were drawn in previous calls. The tick label is
   always bound to an axis, the distance to the axis is controllable via \a distanceToAxis in
   pixels. The pixel position in the axis direction is passed in the \a position parameter. Hence
@@ -10229,44 +11965,36 @@ void QCPAxisPainterPrivate::placeTickLabel(QCPPainter *painter, double position,
   }
   if (mParentPlot->plottingHints().testFlag(QCP::phCacheLabels) && !painter->modes().testFlag(QCPPainter::pmNoCaching)) // label caching enabled
   {
-    CachedLabel *cachedLabel = mLabelCache.take(text); // attempt to get label from cache
-    if (!cachedLabel)  // no cached label existed, create it
+    const QByteArray key = mLabelParameterHash+text.toUtf8();
+    QCPLabelCache::Label cachedLabel;
+    const bool cached = QCPLabelCache::instance()->find(key, &cachedLabel); // attempt to get label from cache
+    if (QCPReplotProfiler *profiler = mParentPlot->profiler())
+      profiler->addLabelCacheLookup(cached);
+    if (!cached)  // no cached label existed, create it
     {
-      cachedLabel = new CachedLabel;
       TickLabelData labelData = getTickLabelData(painter->font(), text);
-      cachedLabel->offset = getTickLabelDrawOffset(labelData)+labelData.rotatedTotalBounds.topLeft();
-      if (!qFuzzyCompare(1.0, mParentPlot->bufferDevicePixelRatio()))
-      {
-        cachedLabel->pixmap = QPixmap(labelData.rotatedTotalBounds.size()*mParentPlot->bufferDevicePixelRatio());
-#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
-#  ifdef QCP_DEVICEPIXELRATIO_FLOAT
-        cachedLabel->pixmap.setDevicePixelRatio(mParentPlot->devicePixelRatioF());
-#  else
-        cachedLabel->pixmap.setDevicePixelRatio(mParentPlot->devicePixelRatio());
-#  endif
-#endif
-      } else
-        cachedLabel->pixmap = QPixmap(labelData.rotatedTotalBounds.size());
-      cachedLabel->pixmap.fill(Qt::transparent);
-      QCPPainter cachePainter(&cachedLabel->pixmap);
+      cachedLabel.offset = getTickLabelDrawOffset(labelData)+labelData.rotatedTotalBounds.topLeft();
+      cachedLabel.image = QCPLabelCache::createImage(labelData.rotatedTotalBounds.size(), mParentPlot->bufferDevicePixelRatio());
+      QCPPainter cachePainter(&cachedLabel.image);
       cachePainter.setPen(painter->pen());
       drawTickLabel(&cachePainter, -labelData.rotatedTotalBounds.topLeft().x(), -labelData.rotatedTotalBounds.topLeft().y(), labelData);
+      cachePainter.end();
+      QCPLabelCache::instance()->insert(key, cachedLabel);
     }
     // if label would be partly clipped by widget border on sides, don't draw it (only for outside tick labels):
     bool labelClippedByBorder = false;
     if (tickLabelSide == QCPAxis::lsOutside)
     {
       if (QCPAxis::orientation(type) == Qt::Horizontal)
-        labelClippedByBorder = labelAnchor.x()+cachedLabel->offset.x()+cachedLabel->pixmap.width()/mParentPlot->bufferDevicePixelRatio() > viewportRect.right() || labelAnchor.x()+cachedLabel->offset.x() < viewportRect.left();
+        labelClippedByBorder = labelAnchor.x()+cachedLabel.offset.x()+cachedLabel.image.width()/mParentPlot->bufferDevicePixelRatio() > viewportRect.right() || labelAnchor.x()+cachedLabel.offset.x() < viewportRect.left();
       else
-        labelClippedByBorder = labelAnchor.y()+cachedLabel->offset.y()+cachedLabel->pixmap.height()/mParentPlot->bufferDevicePixelRatio() > viewportRect.bottom() || labelAnchor.y()+cachedLabel->offset.y() < viewportRect.top();
+        labelClippedByBorder = labelAnchor.y()+cachedLabel.offset.y()+cachedLabel.image.height()/mParentPlot->bufferDevicePixelRatio() > viewportRect.bottom() || labelAnchor.y()+cachedLabel.offset.y() < viewportRect.top();
     }
     if (!labelClippedByBorder)
     {
-      painter->drawPixmap(labelAnchor+cachedLabel->offset, cachedLabel->pixmap);
-      finalSize = cachedLabel->pixmap.size()/mParentPlot->bufferDevicePixelRatio();
+      painter->drawImage(labelAnchor+cachedLabel.offset, cachedLabel.image);
+      finalSize = cachedLabel.image.size()/mParentPlot->bufferDevicePixelRatio();
     }
-    mLabelCache.insert(text, cachedLabel); // return label to cache or insert for the first time if newly created
   } else // label caching disabled, draw text directly on surface:
   {
     TickLabelData labelData = getTickLabelData(painter->font(), text);
@@ -10529,10 +12257,10 @@ void QCPAxisPainterPrivate::getMaxTickLabelSize(const QFont &font, const QString
 {
   // note: this function must return the same tick label sizes as the placeTickLabel function.
   QSize finalSize;
-  if (mParentPlot->plottingHints().testFlag(QCP::phCacheLabels) && mLabelCache.contains(text)) // label caching enabled and have cached label
+  QCPLabelCache::Label cachedLabel;
+  if (mParentPlot->plottingHints().testFlag(QCP::phCacheLabels) && QCPLabelCache::instance()->find(mLabelParameterHash+text.toUtf8(), &cachedLabel)) // label caching enabled and have cached label
   {
-    const CachedLabel *cachedLabel = mLabelCache.object(text);
-    finalSize = cachedLabel->pixmap.size()/mParentPlot->bufferDevicePixelRatio();
+    finalSize = cachedLabel.image.size()/mParentPlot->bufferDevicePixelRatio();
   } else // label caching disabled or no label with this text cached:
   {
     TickLabelData labelData = getTickLabelData(font, text);
@@ -11018,9 +12746,220 @@ void QCPScatterStyle::drawShape(QCPPainter *painter, double x, double y) const
     }
   }
 }
+
+/*!
+  Draws the scatter shape with \a painter at all \a positions. Positions with NaN coordinates are
+  skipped. Like \ref drawShape, this function uses the pen and brush that were set on the painter
+  with \ref applyTo.
+
+  If possible, the shape isn't drawn at every position. Instead, it is rendered once into a small
+  set of images (sprites) by the process-wide \ref QCPScatterSpriteCache, which are then blitted
+  at the positions rounded to a quarter of a device pixel. For thousands of scatters this is much
+  faster than rasterizing the shape outlines each time. Sprites are used if the painter is an
+  active raster painter that is neither vectorized nor has caching disabled (\ref
+  QCPPainter::pmVectorized, \ref QCPPainter::pmNoCaching), its transform is a pure translation,
+  pen and brush are solid or empty, and the shape is neither \ref ssPixmap nor \ref ssCustom. In
+  all other cases, and for very large shapes, the shape is drawn with \ref drawShape at every
+  position.
+
+  Plottables call this function instead of \ref drawShape if \ref QCP::phCacheScatters is set.
+*/
+void QCPScatterStyle::drawShapes(QCPPainter *painter, const QVector<QPointF> &positions) const
+{
+  const QPen pen = painter->pen();
+  const QBrush brush = painter->brush();
+  bool useSprites = positions.size() > 1 && mShape != ssNone && mShape != ssPixmap && mShape != ssCustom &&
+      painter->isActive() && painter->paintEngine() && painter->paintEngine()->type() == QPaintEngine::Raster &&
+      !painter->modes().testFlag(QCPPainter::pmVectorized) && !painter->modes().testFlag(QCPPainter::pmNoCaching) &&
+      painter->transform().type() <= QTransform::TxTranslate &&
+      (pen.style() == Qt::NoPen || pen.brush().style() == Qt::SolidPattern) &&
+      (brush.style() == Qt::NoBrush || brush.style() == Qt::SolidPattern);
+  
+  // the sprites must hold the shape including the pen width and miter joins at the corners:
+  double devicePixelRatio = 1.0;
+#ifdef QCP_DEVICEPIXELRATIO_FLOAT
+  devicePixelRatio = painter->device()->devicePixelRatioF();
+#elif defined(QCP_DEVICEPIXELRATIO_SUPPORTED)
+  devicePixelRatio = painter->device()->devicePixelRatio();
+#endif
+  const double penWidth = pen.style() == Qt::NoPen ? 0.0 : qMax(1.0, pen.widthF());
+  const int halfExtent = qCeil((mSize/2.0+penWidth*qMax(1.0, pen.miterLimit())+1.0)*devicePixelRatio);
+  if (halfExtent > 64)
+    useSprites = false;
+  
+  if (!useSprites)
+  {
+    foreach (const QPointF &pos, positions)
+    {
+      if (!qIsNaN(pos.x()) && !qIsNaN(pos.y()))
+        drawShape(painter, pos.x(), pos.y());
+    }
+    return;
+  }
+  
+  const QVector<QImage> sprites = QCPScatterSpriteCache::instance()->sprites(*this, pen, brush, painter->antialiasing(), devicePixelRatio, halfExtent);
+  const int phaseCount = QCPScatterSpriteCache::phaseCount;
+  
+  // blit the sprites without transform, at positions aligned to the device pixels, so the raster
+  // engine can use its fast untransformed image blending:
+  const QTransform oldTransform = painter->transform();
+  QRectF visibleRect = painter->hasClipping() ? oldTransform.mapRect(painter->clipBoundingRect()) :
+                                                QRectF(0, 0, painter->device()->width()/devicePixelRatio, painter->device()->height()/devicePixelRatio);
+  const double margin = (halfExtent+1)/devicePixelRatio;
+  visibleRect.adjust(-margin, -margin, margin, margin);
+  painter->setTransform(QTransform());
+  foreach (const QPointF &pos, positions)
+  {
+    const QPointF mapped = oldTransform.map(pos);
+    if (!visibleRect.contains(mapped)) // also skips NaN positions
+      continue;
+    double deviceX = qFloor(mapped.x()*devicePixelRatio);
+    double deviceY = qFloor(mapped.y()*devicePixelRatio);
+    int phaseX = qRound((mapped.x()*devicePixelRatio-deviceX)*phaseCount);
+    int phaseY = qRound((mapped.y()*devicePixelRatio-deviceY)*phaseCount);
+    if (phaseX == phaseCount)
+    {
+      deviceX += 1;
+      phaseX = 0;
+    }
+    if (phaseY == phaseCount)
+    {
+      deviceY += 1;
+      phaseY = 0;
+    }
+    painter->drawImage(QPointF((deviceX-halfExtent)/devicePixelRatio, (deviceY-halfExtent)/devicePixelRatio), sprites.at(phaseY*phaseCount+phaseX));
+  }
+  painter->setTransform(oldTransform);
+}
 /* end of 'src/scatterstyle.cpp' */
 
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPScatterSpriteCache
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPScatterSpriteCache
+  \brief Process-wide cache of pre-rendered scatter symbols
+
+  \ref QCPScatterStyle::drawShapes uses this cache to draw many scatters of the same style by
+  blitting images instead of rasterizing the shape at each position. For every combination of
+  scatter shape, size, pen, brush, antialiasing and device pixel ratio, the cache holds \ref
+  phaseCount x \ref phaseCount images (sprites) of the shape, each shifted by a different fraction
+  of a device pixel, so the symbols keep their sub-pixel position when they are blitted at whole
+  device pixels.
+
+  There is one instance for the whole process (\ref instance), so all plottables of all QCustomPlot
+  instances share the sprites. Access is serialized with a mutex, and the sprites are QImages, so
+  the cache can be used from the worker threads of \ref QCP::phParallelLayers. The least recently
+  used sprites are discarded when the total size of the sprites exceeds \ref setMaximumSize.
+*/
+
+/*! \internal
+  
+  Creates the cache with a maximum size of 4 MB. Use \ref instance to access the process-wide
+  cache.
+*/
+QCPScatterSpriteCache::QCPScatterSpriteCache() :
+  mSprites(4096)
+{
+}
+
+/*!
+  Returns the process-wide sprite cache.
+*/
+QCPScatterSpriteCache *QCPScatterSpriteCache::instance()
+{
+  static QCPScatterSpriteCache cache;
+  return &cache;
+}
+
+/*!
+  Returns the maximum total size of all cached sprites in kilobytes.
+  
+  \see setMaximumSize
+*/
+int QCPScatterSpriteCache::maximumSize() const
+{
+  QMutexLocker locker(&mMutex);
+  return mSprites.maxCost();
+}
+
+/*!
+  Sets the maximum total size of all cached sprites in \a kilobytes. If the sprites of a new
+  scatter style don't fit, the least recently used sprites are discarded.
+*/
+void QCPScatterSpriteCache::setMaximumSize(int kilobytes)
+{
+  QMutexLocker locker(&mMutex);
+  mSprites.setMaxCost(qMax(1, kilobytes));
+}
+
+/*!
+  Returns the sprites of \a style drawn with \a pen and \a brush, rendering them if they aren't
+  cached yet. The sprite with the shape shifted by (\e i, \e j)/\ref phaseCount device pixels is
+  at index \e j*\ref phaseCount+\e i. Each sprite is 2*\a halfExtent+2 device pixels wide and
+  high, and the unshifted shape is centered at \a halfExtent device pixels.
+*/
+QVector<QImage> QCPScatterSpriteCache::sprites(const QCPScatterStyle &style, const QPen &pen, const QBrush &brush, bool antialiased, double devicePixelRatio, int halfExtent)
+{
+  QByteArray key;
+  QDataStream stream(&key, QIODevice::WriteOnly);
+  stream << qint32(style.shape()) << style.size() << pen << brush << antialiased << devicePixelRatio << qint32(halfExtent);
+  
+  QMutexLocker locker(&mMutex);
+  if (QVector<QImage> *cached = mSprites.object(key))
+    return *cached;
+  
+  QVector<QImage> *result = new QVector<QImage>(renderSprites(style, pen, brush, antialiased, devicePixelRatio, halfExtent));
+  const int side = 2*halfExtent+2;
+  const int cost = qMax(1, side*side*4*phaseCount*phaseCount/1024);
+  const QVector<QImage> sprites = *result;
+  mSprites.insert(key, result, cost);
+  return sprites;
+}
+
+/*!
+  Discards all cached sprites.
+*/
+void QCPScatterSpriteCache::clear()
+{
+  QMutexLocker locker(&mMutex);
+  mSprites.clear();
+}
+
+/*! \internal
+  
+  Renders the sprites returned by \ref sprites with the \ref QCPScatterStyle::drawShape method of
+  \a style, so sprites look like shapes drawn directly.
+*/
+QVector<QImage> QCPScatterSpriteCache::renderSprites(const QCPScatterStyle &style, const QPen &pen, const QBrush &brush, bool antialiased, double devicePixelRatio, int halfExtent) const
+{
+  const int side = 2*halfExtent+2;
+  QVector<QImage> result;
+  result.reserve(phaseCount*phaseCount);
+  for (int phaseY=0; phaseY<phaseCount; ++phaseY)
+  {
+    for (int phaseX=0; phaseX<phaseCount; ++phaseX)
+    {
+      QImage sprite(side, side, QImage::Format_ARGB32_Premultiplied);
+#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
+      sprite.setDevicePixelRatio(devicePixelRatio);
+#endif
+      sprite.fill(Qt::transparent);
+      QCPPainter spritePainter(&sprite);
+      spritePainter.setAntialiasing(antialiased);
+      spritePainter.resetTransform(); // the half-pixel shift of antialiased painters is part of the blit position
+      spritePainter.setPen(pen);
+      spritePainter.setBrush(brush);
+      style.drawShape(&spritePainter, (halfExtent+phaseX/double(phaseCount))/devicePixelRatio, (halfExtent+phaseY/double(phaseCount))/devicePixelRatio);
+      spritePainter.end();
+      result.append(sprite);
+    }
+  }
+  return result;
+}
+
+
 /* including file 'src/plottable.cpp'       */
 /* modified 2022-11-06T12:45:56, size 38818 */
 
@@ -11425,7 +13364,8 @@ QCPAbstractPlottable::QCPAbstractPlottable(QCPAxis *keyAxis, QCPAxis *valueAxis)
   mKeyAxis(keyAxis),
   mValueAxis(valueAxis),
   mSelectable(QCP::stWhole),
-  mSelectionDecorator(nullptr)
+  mSelectionDecorator(nullptr),
+  mDrawnDataRevision(0)
 {
   if (keyAxis->parentPlot() != valueAxis->parentPlot())
     qDebug() << Q_FUNC_INFO << "Parent plot of keyAxis is not the same as that of valueAxis.";
@@ -11452,6 +13392,7 @@ QCPAbstractPlottable::~QCPAbstractPlottable()
 void QCPAbstractPlottable::setName(const QString &name)
 {
   mName = name;
+  markStyleDirty();
 }
 
 /*!
@@ -11487,6 +13428,7 @@ void QCPAbstractPlottable::setAntialiasedScatters(bool enabled)
 void QCPAbstractPlottable::setPen(const QPen &pen)
 {
   mPen = pen;
+  markStyleDirty();
 }
 
 /*!
@@ -11501,6 +13443,7 @@ void QCPAbstractPlottable::setPen(const QPen &pen)
 void QCPAbstractPlottable::setBrush(const QBrush &brush)
 {
   mBrush = brush;
+  markStyleDirty();
 }
 
 /*!
@@ -11560,6 +13503,7 @@ void QCPAbstractPlottable::setSelection(QCPDataSelection selection)
   if (mSelection != selection)
   {
     mSelection = selection;
+    markDirty();
     emit selectionChanged(selected());
     emit selectionChanged(mSelection);
   }
@@ -11947,6 +13891,59 @@ void QCPAbstractPlottable::applyScattersAntialiasingHint(QCPPainter *painter) co
   applyAntialiasingHint(painter, mAntialiasedScatters, QCP::aeScatters);
 }
 
+/*! \internal
+  
+  Returns a number that changes whenever the data of this plottable is modified. When the plotting
+  hint \ref QCP::phIncrementalReplot is set, \ref QCustomPlot::replot compares it to the revision of
+  the last replot, to find out whether the layer of this plottable needs to be redrawn.
+  
+  The default implementation returns 0, so plottables with other data storage must call \ref
+  markDirty themselves when their data changes.
+*/
+quint32 QCPAbstractPlottable::dataRevision() const
+{
+  return 0;
+}
+
+/*! \internal
+  
+  Marks the layer of this plottable and of its item in the default legend as changed, since the
+  legend icon shows the pen and brush, and the legend item shows the name.
+*/
+void QCPAbstractPlottable::markStyleDirty()
+{
+  markDirty();
+  if (mParentPlot && mParentPlot->legend)
+  {
+    if (QCPPlottableLegendItem *item = mParentPlot->legend->itemWithPlottable(this))
+      item->markDirty();
+  }
+}
+
+/*! \internal
+  
+  Returns the values the pixel positions of this plottable's data depend on: the \ref dataRevision,
+  the ranges and scale types of the key and value axes, and the geometry of their axis rect.
+  
+  Plottables use it as the signature of their \ref QCPSegmentIndex, so the index is rebuilt on the
+  first hit-test after the data, the axis ranges or the layout changed. Subclasses append their own
+  properties that affect the pixel positions, e.g. the line style.
+*/
+QVector<double> QCPAbstractPlottable::hitTestSignature() const
+{
+  QVector<double> signature;
+  signature << dataRevision();
+  QCPAxis *keyAxis = mKeyAxis.data();
+  QCPAxis *valueAxis = mValueAxis.data();
+  if (!keyAxis || !valueAxis)
+    return signature;
+  signature << quintptr(keyAxis) << keyAxis->range().lower << keyAxis->range().upper << keyAxis->scaleType() << keyAxis->rangeReversed()
+            << quintptr(valueAxis) << valueAxis->range().lower << valueAxis->range().upper << valueAxis->scaleType() << valueAxis->rangeReversed();
+  const QRect axisRect = keyAxis->axisRect()->rect();
+  signature << axisRect.x() << axisRect.y() << axisRect.width() << axisRect.height();
+  return signature;
+}
+
 /* inherits documentation from base class */
 void QCPAbstractPlottable::selectEvent(QMouseEvent *event, bool additive, const QVariant &details, bool *selectionStateChanged)
 {
@@ -12519,6 +14516,8 @@ void QCPItemPosition::setCoords(double key, double value)
 {
   mKey = key;
   mValue = value;
+  if (mParentItem)
+    mParentItem->markDirty();
 }
 
 /*! \overload
@@ -13019,6 +15018,7 @@ void QCPAbstractItem::setSelected(bool selected)
   if (mSelected != selected)
   {
     mSelected = selected;
+    markDirty();
     emit selectionChanged(mSelected);
   }
 }
@@ -13267,6 +15267,319 @@ QCP::Interaction QCPAbstractItem::selectionCategory() const
 /* including file 'src/core.cpp'             */
 /* modified 2022-11-06T12:45:56, size 127625 */
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPReplotProfiler
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPReplotProfiler
+  \brief Measures where the time of a replot is spent
+
+  While \ref QCustomPlot::replotTime only tells how long a replot took in total, the replot profiler
+  breaks it down. It is created with \ref QCustomPlot::setProfiling and then records for each
+  replot:
+  
+  \li the time of each phase of the replot (see \ref Phase and \ref phaseTime), with exponential
+  moving averages like \ref QCustomPlot::replotTime,
+  \li the time each layer took to draw (\ref layerTimes),
+  \li the time each layerable took to draw, and for plottables the part of it spent preparing the
+  data, e.g. extracting and reducing the line points of a graph (\ref layerableTimings),
+  \li the hits and misses of the tick label caches (\ref labelCacheHits, \ref labelCacheMisses),
+  if \ref QCP::phCacheLabels is set.
+  
+  Apart from the phase time averages, the values describe the last replot. A formatted overview is
+  returned by \ref summary, which can also be drawn on top of the plot with \ref
+  setOverlayVisible.
+  
+  Only full replots (\ref QCustomPlot::replot) are profiled. Partial replots of a single layer
+  (\ref QCPLayer::replot) and exports aren't recorded.
+  
+  The built-in plottables with expensive data preparation (\ref QCPGraph, \ref QCPCurve and \ref
+  QCPColorMap) report it with \ref addDataTime. Custom plottables may do the same.
+*/
+
+/*!
+  Creates a replot profiler for \a parentPlot. Usually, the profiler is created by \ref
+  QCustomPlot::setProfiling instead of directly.
+*/
+QCPReplotProfiler::QCPReplotProfiler(QCustomPlot *parentPlot) :
+  mOverlayVisible(false),
+  mParentPlot(parentPlot),
+  mRecording(false),
+  mLabelCacheHits(0),
+  mLabelCacheMisses(0)
+{
+  for (int i=0; i<=ppRefresh; ++i)
+  {
+    mPhaseTimes[i] = 0;
+    mPhaseTimeAverages[i] = 0;
+  }
+}
+
+/*!
+  Sets whether the \ref summary of the last replot is shown in the top left corner of the plot. The
+  overlay is drawn directly on the widget surface, so it doesn't affect the plot itself, its paint
+  buffers or exports.
+*/
+void QCPReplotProfiler::setOverlayVisible(bool visible)
+{
+  if (mOverlayVisible != visible)
+  {
+    mOverlayVisible = visible;
+    mParentPlot->update();
+  }
+}
+
+/*!
+  Returns the time in milliseconds that the specified \a phase of the last replot took. If \a
+  average is set to true, an exponential moving average over the last couple of replots is
+  returned.
+*/
+double QCPReplotProfiler::phaseTime(Phase phase, bool average) const
+{
+  if (phase < 0 || phase > ppRefresh)
+    return 0;
+  return average ? mPhaseTimeAverages[phase] : mPhaseTimes[phase];
+}
+
+/*!
+  Returns the sum of all phase times of the last replot in milliseconds. If \a average is set to
+  true, the sum of the averaged phase times is returned.
+  
+  \see phaseTime
+*/
+double QCPReplotProfiler::totalTime(bool average) const
+{
+  double result = 0;
+  for (int i=0; i<=ppRefresh; ++i)
+    result += average ? mPhaseTimeAverages[i] : mPhaseTimes[i];
+  return result;
+}
+
+/*!
+  Returns the time in milliseconds each layer took to draw during the last replot, by layer name.
+  Layers that weren't drawn, e.g. because their paint buffer was still valid (\ref
+  QCP::phIncrementalReplot), aren't included.
+*/
+QMap<QString, double> QCPReplotProfiler::layerTimes() const
+{
+  QMutexLocker locker(&mMutex);
+  return mLayerTimes;
+}
+
+/*!
+  Returns the timings of all layerables that were drawn during the last replot, in the order they
+  were drawn.
+*/
+QList<QCPReplotProfiler::LayerableTiming> QCPReplotProfiler::layerableTimings() const
+{
+  QMutexLocker locker(&mMutex);
+  return mLayerableTimings;
+}
+
+/*!
+  Returns a multi-line text describing the last replot: the total and phase times, the time of each
+  drawn layer, the \a maxLayerables layerables that took the longest to draw and the label cache
+  statistics.
+*/
+QString QCPReplotProfiler::summary(int maxLayerables) const
+{
+  static const char *phaseNames[] = {"merge", "layout", "buffers", "layers", "refresh"};
+  QStringList lines;
+  lines << QString(QLatin1String("replot %1 ms (avg %2 ms)")).arg(totalTime(), 0, 'f', 2).arg(totalTime(true), 0, 'f', 2);
+  QStringList phases;
+  for (int i=0; i<=ppRefresh; ++i)
+    phases << QString(QLatin1String("%1 %2")).arg(QLatin1String(phaseNames[i])).arg(mPhaseTimes[i], 0, 'f', 2);
+  lines << phases.join(QLatin1String(" | "));
+  
+  QMutexLocker locker(&mMutex);
+  for (int i=0; i<mParentPlot->layerCount(); ++i) // list layers in their order instead of by name
+  {
+    const QString layerName = mParentPlot->layer(i)->name();
+    if (mLayerTimes.contains(layerName))
+      lines << QString(QLatin1String("layer %1: %2 ms")).arg(layerName).arg(mLayerTimes.value(layerName), 0, 'f', 2);
+  }
+  
+  QList<LayerableTiming> timings = mLayerableTimings;
+  std::sort(timings.begin(), timings.end(), greaterDrawTime);
+  for (int i=0; i<timings.size() && i<maxLayerables; ++i)
+  {
+    const LayerableTiming &timing = timings.at(i);
+    QString description = QLatin1String("(deleted)");
+    if (QCPLayerable *layerable = timing.layerable.data())
+    {
+      description = QLatin1String(layerable->metaObject()->className());
+      if (QCPAbstractPlottable *plottable = qobject_cast<QCPAbstractPlottable*>(layerable))
+        description += QString(QLatin1String(" \"%1\"")).arg(plottable->name());
+    }
+    QString line = QString(QLatin1String("%1: %2 ms")).arg(description).arg(timing.drawTime, 0, 'f', 2);
+    if (timing.dataTime > 0)
+      line += QString(QLatin1String(" (data %1 ms)")).arg(timing.dataTime, 0, 'f', 2);
+    lines << line;
+  }
+  
+  if (mLabelCacheHits.loadAcquire() > 0 || mLabelCacheMisses.loadAcquire() > 0)
+    lines << QString(QLatin1String("label cache: %1 hits, %2 misses")).arg(mLabelCacheHits.loadAcquire()).arg(mLabelCacheMisses.loadAcquire());
+  return lines.join(QLatin1String("\n"));
+}
+
+/*!
+  Adds \a milliseconds to the data preparation time of \a layerable in the current replot. This is
+  called by plottables in their draw method, around the code that extracts, transforms or reduces
+  their data before painting it. The data preparation time is part of the draw time, see \ref
+  LayerableTiming.
+  
+  This method is thread-safe, since layers may be drawn concurrently (\ref QCP::phParallelLayers).
+  Outside of a replot, it does nothing.
+*/
+void QCPReplotProfiler::addDataTime(const QCPLayerable *layerable, double milliseconds)
+{
+  if (!mRecording)
+    return;
+  QMutexLocker locker(&mMutex);
+  mLayerableTimings[layerableIndex(layerable)].dataTime += milliseconds;
+}
+
+/*!
+  Counts a lookup in a tick label cache, either as hit or as miss depending on \a hit. This is
+  called by the axis painters when \ref QCP::phCacheLabels is set. Outside of a replot, it does
+  nothing.
+*/
+void QCPReplotProfiler::addLabelCacheLookup(bool hit)
+{
+  if (!mRecording)
+    return;
+  if (hit)
+    mLabelCacheHits.ref();
+  else
+    mLabelCacheMisses.ref();
+}
+
+/*! \internal
+  
+  Starts the recording of a replot and discards the recordings of the previous one. Called by \ref
+  QCustomPlot::replot.
+*/
+void QCPReplotProfiler::beginReplot()
+{
+  QMutexLocker locker(&mMutex);
+  for (int i=0; i<=ppRefresh; ++i)
+    mPhaseTimes[i] = 0;
+  mLayerTimes.clear();
+  mLayerableTimings.clear();
+  mLayerableIndices.clear();
+  mLabelCacheHits.storeRelease(0);
+  mLabelCacheMisses.storeRelease(0);
+  mRecording = true;
+  mPhaseTimer.start();
+}
+
+/*! \internal
+  
+  Restarts the phase timer, so the time since the end of the last phase isn't counted for the next
+  one.
+*/
+void QCPReplotProfiler::startPhase()
+{
+  mPhaseTimer.start();
+}
+
+/*! \internal
+  
+  Records the time since the end of the previous phase (or \ref startPhase) as the time of \a
+  phase, and starts timing the next phase.
+*/
+void QCPReplotProfiler::endPhase(Phase phase)
+{
+  mPhaseTimes[phase] += mPhaseTimer.nsecsElapsed()*1e-6;
+  mPhaseTimer.start();
+}
+
+/*! \internal
+  
+  Ends the recording of a replot and updates the averages of the phase times.
+*/
+void QCPReplotProfiler::endReplot()
+{
+  mRecording = false;
+  const bool firstReplot = qFuzzyIsNull(totalTime(true));
+  for (int i=0; i<=ppRefresh; ++i)
+  {
+    if (!firstReplot)
+      mPhaseTimeAverages[i] = mPhaseTimeAverages[i]*0.9 + mPhaseTimes[i]*0.1; // exponential moving average with a time constant of 10 last replots
+    else
+      mPhaseTimeAverages[i] = mPhaseTimes[i]; // no previous replots to average with, so initialize with phase time
+  }
+  if (mOverlayVisible)
+    mParentPlot->update();
+}
+
+/*! \internal
+  
+  Records that \a layerable took \a milliseconds to draw on \a layer. Called by \ref
+  QCPLayer::draw, possibly from multiple threads at the same time.
+*/
+void QCPReplotProfiler::addDrawTime(QCPLayerable *layerable, const QCPLayer *layer, double milliseconds)
+{
+  if (!mRecording)
+    return;
+  QMutexLocker locker(&mMutex);
+  LayerableTiming &timing = mLayerableTimings[layerableIndex(layerable)];
+  timing.layerable = layerable;
+  timing.layer = layer->name();
+  timing.drawTime += milliseconds;
+  mLayerTimes[layer->name()] += milliseconds;
+}
+
+/*! \internal
+  
+  Returns the index of \a layerable in the layerable timings, appending an empty timing if the
+  layerable has none yet. The mutex must be locked by the caller.
+*/
+int QCPReplotProfiler::layerableIndex(const QCPLayerable *layerable)
+{
+  QHash<const QCPLayerable*, int>::const_iterator it = mLayerableIndices.constFind(layerable);
+  if (it != mLayerableIndices.constEnd())
+    return it.value();
+  LayerableTiming timing;
+  timing.drawTime = 0;
+  timing.dataTime = 0;
+  mLayerableTimings.append(timing);
+  mLayerableIndices.insert(layerable, mLayerableTimings.size()-1);
+  return mLayerableTimings.size()-1;
+}
+
+/*! \internal
+  
+  Draws the \ref summary of the last replot on a translucent background into the top left corner
+  of the viewport. Called by \ref QCustomPlot::paintEvent if the overlay is visible.
+*/
+void QCPReplotProfiler::drawOverlay(QCPPainter *painter) const
+{
+  const QString text = summary();
+  QFont font = mParentPlot->font();
+  font.setStyleHint(QFont::Monospace);
+  font.setFamily(QLatin1String("monospace"));
+  painter->save();
+  painter->setFont(font);
+  const QRect textRect = painter->fontMetrics().boundingRect(QRect(), Qt::AlignLeft|Qt::AlignTop, text)
+      .translated(mParentPlot->viewport().topLeft()+QPoint(8, 8));
+  painter->setPen(Qt::NoPen);
+  painter->setBrush(QColor(255, 255, 255, 210));
+  painter->drawRect(textRect.adjusted(-4, -4, 4, 4));
+  painter->setPen(Qt::black);
+  painter->drawText(textRect, Qt::AlignLeft|Qt::AlignTop, text);
+  painter->restore();
+}
+
+/*! \internal
+  
+  Comparator for sorting layerable timings by descending draw time, used by \ref summary.
+*/
+bool QCPReplotProfiler::greaterDrawTime(const LayerableTiming &a, const LayerableTiming &b)
+{
+  return a.drawTime > b.drawTime;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////// QCustomPlot
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -13618,6 +15931,7 @@ QCustomPlot::QCustomPlot(QWidget *parent) :
   mSelectionRectMode(QCP::srmNone),
   mSelectionRect(nullptr),
   mOpenGl(false),
+  mSoftwareRasterizer(false),
   mMouseHasMoved(false),
   mMouseEventLayerable(nullptr),
   mMouseSignalLayerable(nullptr),
@@ -13625,9 +15939,9 @@ QCustomPlot::QCustomPlot(QWidget *parent) :
   mReplotQueued(false),
   mReplotTime(0),
   mReplotTimeAverage(0),
+  mProfiler(nullptr),
   mOpenGlMultisamples(16),
-  mOpenGlAntialiasedElementsBackup(QCP::aeNone),
-  mOpenGlCacheLabelsBackup(true)
+  mOpenGlAntialiasedElementsBackup(QCP::aeNone)
 {
   setAttribute(Qt::WA_NoMousePropagation);
   setFocusPolicy(Qt::ClickFocus);
@@ -13644,7 +15958,6 @@ QCustomPlot::QCustomPlot(QWidget *parent) :
 #endif
   
   mOpenGlAntialiasedElementsBackup = mAntialiasedElements;
-  mOpenGlCacheLabelsBackup = mPlottingHints.testFlag(QCP::phCacheLabels);
   // create initial layers:
   mLayers.append(new QCPLayer(this, QLatin1String("background")));
   mLayers.append(new QCPLayer(this, QLatin1String("grid")));
@@ -13706,6 +16019,9 @@ QCustomPlot::~QCustomPlot()
   mCurrentLayer = nullptr;
   qDeleteAll(mLayers); // don't use removeLayer, because it would prevent the last layer to be removed
   mLayers.clear();
+  
+  delete mProfiler;
+  mProfiler = nullptr;
 }
 
 /*!
@@ -13919,11 +16235,22 @@ void QCustomPlot::setNoAntialiasingOnDrag(bool enabled)
 /*!
   Sets the plotting hints for this QCustomPlot instance as an \a or combination of QCP::PlottingHint.
   
+  Switching \ref QCP::phParallelLayers recreates the paint buffers, since parallel drawing requires
+  \ref QCPPaintBufferImage instances instead of \ref QCPPaintBufferPixmap. The buffers of the
+  software rasterizer (\ref setSoftwareRasterizer) are image buffers already and are kept.
+  
   \see setPlottingHint
 */
 void QCustomPlot::setPlottingHints(const QCP::PlottingHints &hints)
 {
+  const bool bufferTypeChanged = (hints.testFlag(QCP::phParallelLayers) != mPlottingHints.testFlag(QCP::phParallelLayers));
   mPlottingHints = hints;
+  if (bufferTypeChanged && !mOpenGl && !mSoftwareRasterizer)
+  {
+    // recreate the paint buffers with the type that fits the new hints (see createPaintBuffer):
+    mPaintBuffers.clear();
+    setupPaintBuffers();
+  }
 }
 
 /*!
@@ -14046,14 +16373,15 @@ void QCustomPlot::setSelectionRect(QCPSelectionRect *selectionRect)
   rendering continues with the regular software rasterizer, and an according qDebug output is
   generated.
 
-  If switching to OpenGL was successful, this method disables label caching (\ref setPlottingHint
-  "setPlottingHint(QCP::phCacheLabels, false)") and turns on QCustomPlot's antialiasing override
+  If switching to OpenGL was successful, this method turns on QCustomPlot's antialiasing override
   for all elements (\ref setAntialiasedElements "setAntialiasedElements(QCP::aeAll)"), leading to a
   higher quality output. The antialiasing override allows for pixel-grid aligned drawing in the
   OpenGL paint device. As stated before, in OpenGL rendering the actual antialiasing of the plot is
-  controlled with \a multisampling. If \a enabled is set to false, the antialiasing/label caching
-  settings are restored to what they were before OpenGL was enabled, if they weren't altered in the
-  meantime.
+  controlled with \a multisampling. If \a enabled is set to false, the antialiasing settings are
+  restored to what they were before OpenGL was enabled, if they weren't altered in the meantime.
+  
+  Label caching (\ref QCP::phCacheLabels) stays enabled with OpenGL. The cached labels are images
+  shared by all plots (\ref QCPLabelCache), which the OpenGL paint engine uploads once as textures.
 
   \note OpenGL support is only enabled if QCustomPlot is compiled with the macro \c QCUSTOMPLOT_USE_OPENGL
   defined. This define must be set before including the QCustomPlot header both during compilation
@@ -14072,12 +16400,10 @@ void QCustomPlot::setOpenGl(bool enabled, int multisampling)
   {
     if (setupOpenGl())
     {
-      // backup antialiasing override and labelcaching setting so we can restore upon disabling OpenGL
+      // backup antialiasing override so we can restore upon disabling OpenGL
       mOpenGlAntialiasedElementsBackup = mAntialiasedElements;
-      mOpenGlCacheLabelsBackup = mPlottingHints.testFlag(QCP::phCacheLabels);
-      // set antialiasing override to antialias all (aligns gl pixel grid properly), and disable label caching (would use software rasterizer for pixmap caches):
+      // set antialiasing override to antialias all (aligns gl pixel grid properly):
       setAntialiasedElements(QCP::aeAll);
-      setPlottingHint(QCP::phCacheLabels, false);
     } else
     {
       qDebug() << Q_FUNC_INFO << "Failed to enable OpenGL, continuing plotting without hardware acceleration.";
@@ -14085,11 +16411,9 @@ void QCustomPlot::setOpenGl(bool enabled, int multisampling)
     }
   } else
   {
-    // restore antialiasing override and labelcaching to what it was before enabling OpenGL, if nobody changed it in the meantime:
+    // restore antialiasing override to what it was before enabling OpenGL, if nobody changed it in the meantime:
     if (mAntialiasedElements == QCP::aeAll)
       setAntialiasedElements(mOpenGlAntialiasedElementsBackup);
-    if (!mPlottingHints.testFlag(QCP::phCacheLabels))
-      setPlottingHint(QCP::phCacheLabels, mOpenGlCacheLabelsBackup);
     freeOpenGl();
   }
   // recreate all paint buffers:
@@ -14101,6 +16425,57 @@ void QCustomPlot::setOpenGl(bool enabled, int multisampling)
 #endif
 }
 
+/*!
+  Sets whether this QCustomPlot draws antialiased lines and fills with its own software rasterizer
+  (\ref QCPRasterizer) instead of QPainter.
+
+  The rasterizer covers the most frequent and most expensive primitives of dense plots. These are
+  the antialiased solid lines of graphs, curves and polar graphs, and solid fills without outline.
+  It writes them directly into image paint buffers (\ref QCPPaintBufferRasterizer). Everything
+  else, as well as any pen or brush the rasterizer doesn't support, is still drawn with QPainter
+  into the same buffers. With SSE2, the rasterizer processes four pixels at once.
+
+  This is meant for systems without GPU, where \ref setOpenGl isn't an option, e.g. render servers
+  or virtual machines. If OpenGL is enabled as well, it takes precedence. Exports like \ref savePng
+  or \ref toPixmap are always drawn with QPainter.
+
+  Changing this setting recreates all paint buffers.
+*/
+void QCustomPlot::setSoftwareRasterizer(bool enabled)
+{
+  if (mSoftwareRasterizer == enabled)
+    return;
+  mSoftwareRasterizer = enabled;
+  // recreate all paint buffers:
+  mPaintBuffers.clear();
+  setupPaintBuffers();
+}
+
+/*!
+  Sets whether the replots of this QCustomPlot are profiled. If \a enabled is true, a \ref
+  QCPReplotProfiler is created, which is accessible with \ref profiler. It records the time of
+  each phase of \ref replot, of each layer and layerable, the time plottables spend preparing their
+  data, and the hits and misses of the tick label cache (\ref QCP::phCacheLabels). The profiler
+  can also show this information on top of the plot, see \ref QCPReplotProfiler::setOverlayVisible.
+
+  If \a enabled is false, the profiler is deleted and \ref profiler returns \c nullptr. Since all
+  measurements are skipped in this case, profiling has no noticeable cost when it is disabled.
+*/
+void QCustomPlot::setProfiling(bool enabled)
+{
+  if (enabled && !mProfiler)
+  {
+    mProfiler = new QCPReplotProfiler(this);
+  } else if (!enabled && mProfiler)
+  {
+    const bool overlayVisible = mProfiler->overlayVisible();
+    delete mProfiler;
+    mProfiler = nullptr;
+    if (overlayVisible)
+      update();
+  }
+}
+
 /*!
   Sets the viewport of this QCustomPlot. Usually users of QCustomPlot don't need to change the
   viewport manually.
@@ -15104,10 +17479,12 @@ void QCustomPlot::deselectAll()
   Under a few circumstances, QCustomPlot causes a replot by itself. Those are resize events of the
   QCustomPlot widget and user interactions (object selection and range dragging/zooming).
 
-  Before the replot happens, the signal \ref beforeReplot is emitted. After the replot, \ref
-  afterReplot is emitted. It is safe to mutually connect the replot slot with any of those two
-  signals on two QCustomPlots to make them replot synchronously, it won't cause an infinite
-  recursion.
+  At the beginning of the replot, graphs merge the data that other threads pushed into their data
+  queues (see \ref QCPGraph::setDataQueue). Then, the signal \ref beforeReplot is emitted. After the
+  replot, \ref afterReplot is emitted. It is safe to mutually connect the replot slot with any of
+  those two signals on two QCustomPlots to make them replot synchronously, it won't cause an
+  infinite recursion. To find out which parts of the replot take the most time, enable the replot
+  profiler with \ref setProfiling.
 
   If a layer is in mode \ref QCPLayer::lmBuffered (\ref QCPLayer::setMode), it is also possible to
   replot only that specific layer via \ref QCPLayer::replot. See the documentation there for
@@ -15131,7 +17508,16 @@ void QCustomPlot::replot(QCustomPlot::RefreshPriority refreshPriority)
     return;
   mReplotting = true;
   mReplotQueued = false;
+  if (mProfiler)
+    mProfiler->beginReplot();
+  // merge data that producer threads pushed into the data queues of graphs:
+  foreach (QCPGraph *graph, mGraphs)
+    graph->mergeDataQueue();
+  if (mProfiler)
+    mProfiler->endPhase(QCPReplotProfiler::ppMergeDataQueues);
   emit beforeReplot();
+  if (mProfiler)
+    mProfiler->startPhase(); // the slots connected to beforeReplot aren't part of any phase
   
 # if QT_VERSION < QT_VERSION_CHECK(4, 8, 0)
   QTime replotTimer;
@@ -15142,17 +17528,31 @@ void QCustomPlot::replot(QCustomPlot::RefreshPriority refreshPriority)
 # endif
   
   updateLayout();
+  if (mPlottingHints.testFlag(QCP::phIncrementalReplot))
+    invalidateChangedPaintBuffers();
+  else
+    mDrawnGeometry.clear(); // enabling incremental replots later starts with a full redraw
+  if (mProfiler)
+    mProfiler->endPhase(QCPReplotProfiler::ppUpdateLayout);
   // draw all layered objects (grid, axes, plottables, items, legend,...) into their buffers:
   setupPaintBuffers();
-  foreach (QCPLayer *layer, mLayers)
-    layer->drawToPaintBuffer();
+  if (mProfiler)
+    mProfiler->endPhase(QCPReplotProfiler::ppSetupPaintBuffers);
+  drawToPaintBuffers();
   foreach (QSharedPointer<QCPAbstractPaintBuffer> buffer, mPaintBuffers)
     buffer->setInvalidated(false);
+  if (mProfiler)
+    mProfiler->endPhase(QCPReplotProfiler::ppDrawLayers);
   
   if ((refreshPriority == rpRefreshHint && mPlottingHints.testFlag(QCP::phImmediateRefresh)) || refreshPriority==rpImmediateRefresh)
     repaint();
   else
     update();
+  if (mProfiler)
+  {
+    mProfiler->endPhase(QCPReplotProfiler::ppRefresh);
+    mProfiler->endReplot();
+  }
   
 # if QT_VERSION < QT_VERSION_CHECK(4, 8, 0)
   mReplotTime = replotTimer.elapsed();
@@ -15496,6 +17896,8 @@ void QCustomPlot::paintEvent(QPaintEvent *event)
     drawBackground(&painter);
     foreach (QSharedPointer<QCPAbstractPaintBuffer> buffer, mPaintBuffers)
       buffer->draw(&painter);
+    if (mProfiler && mProfiler->overlayVisible())
+      mProfiler->drawOverlay(&painter);
   }
 }
 
@@ -15830,7 +18232,10 @@ void QCustomPlot::drawBackground(QCPPainter *painter)
   This method uses \ref createPaintBuffer to create new paint buffers.
 
   After this method, the paint buffers are empty (filled with \c Qt::transparent) and invalidated
-  (so an attempt to replot only a single buffered layer causes a full replot).
+  (so an attempt to replot only a single buffered layer causes a full replot). If the plotting hint
+  \ref QCP::phIncrementalReplot is set, only the buffers that are already invalidated are cleared,
+  e.g. because a layer drawn into them changed (\ref QCPLayer::markDirty) or because the association
+  of layers to buffers changed. The other buffers keep their contents and aren't redrawn.
 
   This method is called in every \ref replot call, prior to actually drawing the layers (into their
   associated paint buffer). If the paint buffers don't need changing/reallocating, this method
@@ -15847,12 +18252,16 @@ void QCustomPlot::setupPaintBuffers()
     QCPLayer *layer = mLayers.at(layerIndex);
     if (layer->mode() == QCPLayer::lmLogical)
     {
+      if (layer->mPaintBuffer.toStrongRef() != mPaintBuffers.at(bufferIndex)) // layer moved to another buffer, so that one must be redrawn
+        mPaintBuffers.at(bufferIndex)->setInvalidated();
       layer->mPaintBuffer = mPaintBuffers.at(bufferIndex).toWeakRef();
     } else if (layer->mode() == QCPLayer::lmBuffered)
     {
       ++bufferIndex;
       if (bufferIndex >= mPaintBuffers.size())
         mPaintBuffers.append(QSharedPointer<QCPAbstractPaintBuffer>(createPaintBuffer()));
+      if (layer->mPaintBuffer.toStrongRef() != mPaintBuffers.at(bufferIndex))
+        mPaintBuffers.at(bufferIndex)->setInvalidated();
       layer->mPaintBuffer = mPaintBuffers.at(bufferIndex).toWeakRef();
       if (layerIndex < mLayers.size()-1 && mLayers.at(layerIndex+1)->mode() == QCPLayer::lmLogical) // not last layer, and next one is logical, so prepare another buffer for next layerables
       {
@@ -15866,21 +18275,194 @@ void QCustomPlot::setupPaintBuffers()
   while (mPaintBuffers.size()-1 > bufferIndex)
     mPaintBuffers.removeLast();
   // resize buffers to viewport size and clear contents:
+  const bool incremental = mPlottingHints.testFlag(QCP::phIncrementalReplot);
   foreach (QSharedPointer<QCPAbstractPaintBuffer> buffer, mPaintBuffers)
   {
     buffer->setSize(viewport().size()); // won't do anything if already correct size
-    buffer->clear(Qt::transparent);
-    buffer->setInvalidated();
+    if (!incremental || buffer->invalidated())
+    {
+      buffer->clear(Qt::transparent);
+      buffer->setInvalidated();
+    }
+  }
+}
+
+/*! \internal
+
+  Invalidates the paint buffers whose contents changed since the last replot, so \ref replot
+  redraws them when the plotting hint \ref QCP::phIncrementalReplot is set.
+
+  All paint buffers are invalidated if the viewport, the device pixel ratio, the rect of any layout
+  element or the range of any axis changed, since nearly every layer depends on them. Further, the
+  layers of plottables whose data was modified (detected by the data revision of the plottable)
+  are invalidated. Changes of other properties mark their layers themselves, see \ref
+  QCPLayerable::markDirty.
+
+  This method only compares a few numbers per layout element, axis and plottable, so it is cheap
+  compared to redrawing the layers.
+*/
+void QCustomPlot::invalidateChangedPaintBuffers()
+{
+  // collect everything all layers depend on, and invalidate all buffers if it changed:
+  QVector<double> geometry;
+  geometry << mViewport.x() << mViewport.y() << mViewport.width() << mViewport.height() << mBufferDevicePixelRatio;
+  foreach (QCPLayoutElement *element, mPlotLayout->elements(true))
+  {
+    if (!element)
+      continue;
+    const QRect outerRect = element->outerRect();
+    const QRect rect = element->rect();
+    geometry << outerRect.x() << outerRect.y() << outerRect.width() << outerRect.height()
+             << rect.x() << rect.y() << rect.width() << rect.height();
+    if (QCPAxisRect *axisRect = qobject_cast<QCPAxisRect*>(element))
+    {
+      foreach (QCPAxis *axis, axisRect->axes())
+        geometry << axis->range().lower << axis->range().upper << axis->scaleType() << axis->rangeReversed();
+    } else if (QCPPolarAxisAngular *angularAxis = qobject_cast<QCPPolarAxisAngular*>(element))
+    {
+      geometry << angularAxis->range().lower << angularAxis->range().upper;
+      foreach (QCPPolarAxisRadial *radialAxis, angularAxis->radialAxes())
+        geometry << radialAxis->range().lower << radialAxis->range().upper;
+    }
+  }
+  if (geometry != mDrawnGeometry)
+  {
+    foreach (QSharedPointer<QCPAbstractPaintBuffer> buffer, mPaintBuffers)
+      buffer->setInvalidated();
+    mDrawnGeometry = geometry;
+  }
+  
+  // invalidate the layers of plottables whose data changed:
+  foreach (QCPAbstractPlottable *plottable, mPlottables)
+  {
+    const quint32 revision = plottable->dataRevision();
+    if (revision != plottable->mDrawnDataRevision)
+    {
+      plottable->markDirty();
+      plottable->mDrawnDataRevision = revision;
+    }
+  }
+}
+
+/*! \internal
+  \class QCPPaintBufferRenderTask
+  
+  A runnable used by \ref QCustomPlot::drawToPaintBuffers to draw layers on a thread pool. The
+  layers are given in groups, one group per paint buffer, in the order they are drawn. Each task
+  and the GUI thread repeatedly take the next group that isn't claimed yet from a shared counter,
+  until all groups are drawn. Then the task releases the semaphore passed to the constructor.
+  
+  Since different groups draw into different paint buffers and the layerables only read the state
+  of the plot while drawing, the groups can be drawn concurrently.
+*/
+class QCPPaintBufferRenderTask : public QRunnable
+{
+public:
+  QCPPaintBufferRenderTask(const QList<QList<QCPLayer*> > &groups, QAtomicInt *nextGroup, QSemaphore *finished) :
+    mGroups(groups),
+    mNextGroup(nextGroup),
+    mFinished(finished)
+  {
+    setAutoDelete(false);
+  }
+  
+  virtual void run() Q_DECL_OVERRIDE
+  {
+    drawGroups(mGroups, *mNextGroup);
+    mFinished->release();
+  }
+  
+  static void drawGroups(const QList<QList<QCPLayer*> > &groups, QAtomicInt &nextGroup)
+  {
+    int index;
+    while ((index = nextGroup.fetchAndAddOrdered(1)) < groups.size())
+    {
+      foreach (QCPLayer *layer, groups.at(index))
+        layer->drawToPaintBuffer();
+    }
   }
+  
+private:
+  const QList<QList<QCPLayer*> > &mGroups;
+  QAtomicInt *mNextGroup;
+  QSemaphore *mFinished;
+};
+
+/*! \internal
+
+  Draws the layers into their paint buffers, skipping buffers that are still valid (only possible
+  with the plotting hint \ref QCP::phIncrementalReplot, see \ref setupPaintBuffers). This is
+  called by \ref replot after the paint buffers were set up.
+
+  If the plotting hint \ref QCP::phParallelLayers is set and the paint buffers are \ref
+  QCPPaintBufferImage instances, the layers of different paint buffers are drawn concurrently on
+  the global QThreadPool, with the GUI thread taking part. Layers sharing a buffer are drawn in
+  order by the same thread. Only threads that are currently idle in the pool are used, so a busy
+  pool never delays the replot, it just draws with fewer threads. This method returns after all
+  layers are drawn.
+
+  For this to be safe, the \ref QCPLayerable::draw implementations must only read shared state.
+  This holds for all layerables of QCustomPlot, as long as their data isn't modified from other
+  threads during the replot (use \ref QCPGraph::setDataQueue for that). Note that pixmap items
+  and \ref QCPScatterStyle::ssPixmap scatters are QPixmaps, which some Qt platform plugins don't
+  allow to use outside the GUI thread. Cached tick labels (\ref QCPLabelCache) are QImages and
+  safe on all platforms.
+*/
+void QCustomPlot::drawToPaintBuffers()
+{
+  // group the layers that need redrawing by paint buffer, keeping the layer order within each group:
+  QList<QCPAbstractPaintBuffer*> groupBuffers;
+  QList<QList<QCPLayer*> > groups;
+  foreach (QCPLayer *layer, mLayers)
+  {
+    QSharedPointer<QCPAbstractPaintBuffer> pb = layer->mPaintBuffer.toStrongRef();
+    if (!pb)
+    {
+      layer->drawToPaintBuffer(); // outputs the debug message about the missing buffer
+      continue;
+    }
+    if (!pb->invalidated())
+      continue;
+    if (groupBuffers.isEmpty() || groupBuffers.last() != pb.data()) // layers of a buffer are consecutive, see setupPaintBuffers
+    {
+      groupBuffers.append(pb.data());
+      groups.append(QList<QCPLayer*>());
+    }
+    groups.last().append(layer);
+  }
+  
+  QAtomicInt nextGroup(0);
+  if (mPlottingHints.testFlag(QCP::phParallelLayers) && !mOpenGl && groups.size() > 1)
+  {
+    // start a task for each additional group, as long as the pool has idle threads:
+    QThreadPool *pool = QThreadPool::globalInstance();
+    QSemaphore finished;
+    QList<QCPPaintBufferRenderTask*> tasks;
+    for (int i=1; i<groups.size(); ++i)
+    {
+      QCPPaintBufferRenderTask *task = new QCPPaintBufferRenderTask(groups, &nextGroup, &finished);
+      if (!pool->tryStart(task))
+      {
+        delete task;
+        break;
+      }
+      tasks.append(task);
+    }
+    QCPPaintBufferRenderTask::drawGroups(groups, nextGroup);
+    finished.acquire(tasks.size());
+    qDeleteAll(tasks);
+  } else
+    QCPPaintBufferRenderTask::drawGroups(groups, nextGroup);
 }
 
 /*! \internal
 
   This method is used by \ref setupPaintBuffers when it needs to create new paint buffers.
 
-  Depending on the current setting of \ref setOpenGl, and the current Qt version, different
-  backends (subclasses of \ref QCPAbstractPaintBuffer) are created, initialized with the proper
-  size and device pixel ratio, and returned.
+  Depending on the current setting of \ref setOpenGl, the plotting hint \ref
+  QCP::phParallelLayers, and the current Qt version, different backends (subclasses of \ref
+  QCPAbstractPaintBuffer) are created, initialized with the proper size and device pixel ratio, and
+  returned.
 */
 QCPAbstractPaintBuffer *QCustomPlot::createPaintBuffer()
 {
@@ -15894,7 +18476,11 @@ QCPAbstractPaintBuffer *QCustomPlot::createPaintBuffer()
     qDebug() << Q_FUNC_INFO << "OpenGL enabled even though no support for it compiled in, this shouldn't have happened. Falling back to pixmap paint buffer.";
     return new QCPPaintBufferPixmap(viewport().size(), mBufferDevicePixelRatio);
 #endif
-  } else
+  } else if (mSoftwareRasterizer)
+    return new QCPPaintBufferRasterizer(viewport().size(), mBufferDevicePixelRatio);
+  else if (mPlottingHints.testFlag(QCP::phParallelLayers))
+    return new QCPPaintBufferImage(viewport().size(), mBufferDevicePixelRatio);
+  else
     return new QCPPaintBufferPixmap(viewport().size(), mBufferDevicePixelRatio);
 }
 
@@ -15906,14 +18492,18 @@ QCPAbstractPaintBuffer *QCustomPlot::createPaintBuffer()
   causes a full replot (\ref QCustomPlot::replot) of all layers. This is the case when for example
   the layer order has changed, new layers were added or removed, layer modes were changed (\ref
   QCPLayer::setMode), or layerables were added or removed.
+  
+  If \a ignoredBuffer is given, it is left out of the check. \ref QCPLayer::replot uses this for the
+  buffer of its own layer, because changing the layerables on the layer (see \ref
+  QCPLayerable::markDirty) invalidates it, but doesn't require redrawing any other layer.
 
   \see QCPAbstractPaintBuffer::setInvalidated
 */
-bool QCustomPlot::hasInvalidatedPaintBuffers()
+bool QCustomPlot::hasInvalidatedPaintBuffers(const QSharedPointer<QCPAbstractPaintBuffer> &ignoredBuffer)
 {
   foreach (QSharedPointer<QCPAbstractPaintBuffer> buffer, mPaintBuffers)
   {
-    if (buffer->invalidated())
+    if (buffer != ignoredBuffer && buffer->invalidated())
       return true;
   }
   return false;
@@ -16548,7 +19138,10 @@ QCPColorGradient::QCPColorGradient() :
   mNanHandling(nhNone),
   mNanColor(Qt::black),
   mPeriodic(false),
-  mColorBufferInvalidated(true)
+  mColorBufferInvalidated(true),
+  mLogLookupLevelCount(0),
+  mLogLookupShift(0),
+  mLogLookupBase(0)
 {
   mColorBuffer.fill(qRgb(0, 0, 0), mLevelCount);
 }
@@ -16565,7 +19158,10 @@ QCPColorGradient::QCPColorGradient(GradientPreset preset) :
   mNanHandling(nhNone),
   mNanColor(Qt::black),
   mPeriodic(false),
-  mColorBufferInvalidated(true)
+  mColorBufferInvalidated(true),
+  mLogLookupLevelCount(0),
+  mLogLookupShift(0),
+  mLogLookupBase(0)
 {
   mColorBuffer.fill(qRgb(0, 0, 0), mLevelCount);
   loadPreset(preset);
@@ -16721,6 +19317,8 @@ void QCPColorGradient::colorize(const double *data, const QCPRange &range, QRgb
   }
   if (mColorBufferInvalidated)
     updateColorBuffer();
+  if (!mPeriodic && colorizeClamped(data, range, scanLine, n, dataIndexFactor, logarithmic))
+    return;
   
   const bool skipNanCheck = mNanHandling == nhNone;
   const double posToIndexFactor = !logarithmic ? (mLevelCount-1)/range.size() : (mLevelCount-1)/qLn(range.upper/range.lower);
@@ -16744,8 +19342,8 @@ void QCPColorGradient::colorize(const double *data, const QCPRange &range, QRgb
     {
       switch(mNanHandling)
       {
-      case nhLowestColor: scanLine[i] = mColorBuffer.first(); break;
-      case nhHighestColor: scanLine[i] = mColorBuffer.last(); break;
+      case nhLowestColor: scanLine[i] = mColorBuffer.at(0); break;
+      case nhHighestColor: scanLine[i] = mColorBuffer.at(mLevelCount-1); break;
       case nhTransparent: scanLine[i] = qRgba(0, 0, 0, 0); break;
       case nhNanColor: scanLine[i] = mNanColor.rgba(); break;
       case nhNone: break; // shouldn't happen
@@ -16784,6 +19382,21 @@ void QCPColorGradient::colorize(const double *data, const unsigned char *alpha,
     updateColorBuffer();
   
   const bool skipNanCheck = mNanHandling == nhNone;
+  if (!mPeriodic && colorizeClamped(data, range, scanLine, n, dataIndexFactor, logarithmic))
+  {
+    // apply the alpha of the data points, except to NaN colors, like below:
+    for (int i=0; i<n; ++i)
+    {
+      if (alpha[dataIndexFactor*i] != 255 && (skipNanCheck || !std::isnan(data[dataIndexFactor*i])))
+      {
+        const QRgb rgb = scanLine[i];
+        const float alphaF = alpha[dataIndexFactor*i]/255.0f;
+        scanLine[i] = qRgba(int(qRed(rgb)*alphaF), int(qGreen(rgb)*alphaF), int(qBlue(rgb)*alphaF), int(qAlpha(rgb)*alphaF)); // also multiply r,g,b with alpha, to conform to Format_ARGB32_Premultiplied
+      }
+    }
+    return;
+  }
+  
   const double posToIndexFactor = !logarithmic ? (mLevelCount-1)/range.size() : (mLevelCount-1)/qLn(range.upper/range.lower);
   for (int i=0; i<n; ++i)
   {
@@ -16813,8 +19426,8 @@ void QCPColorGradient::colorize(const double *data, const unsigned char *alpha,
     {
       switch(mNanHandling)
       {
-      case nhLowestColor: scanLine[i] = mColorBuffer.first(); break;
-      case nhHighestColor: scanLine[i] = mColorBuffer.last(); break;
+      case nhLowestColor: scanLine[i] = mColorBuffer.at(0); break;
+      case nhHighestColor: scanLine[i] = mColorBuffer.at(mLevelCount-1); break;
       case nhTransparent: scanLine[i] = qRgba(0, 0, 0, 0); break;
       case nhNanColor: scanLine[i] = mNanColor.rgba(); break;
       case nhNone: break; // shouldn't happen
@@ -16823,6 +19436,126 @@ void QCPColorGradient::colorize(const double *data, const unsigned char *alpha,
   }
 }
 
+/*! \internal
+
+  Colorizes the data like \ref colorize, for gradients that aren't periodic, so the color indices
+  can be clamped instead of wrapped around. The NaN handling is resolved to a single color before
+  the loop.
+
+  For a linear data range, the indices are calculated two values at a time with SSE2 where
+  available. For a logarithmic data range, no logarithm is evaluated per value. Instead, the level
+  is looked up in a table indexed by the exponent and the leading mantissa bits of the value, see
+  \ref updateLogLookup.
+
+  Returns false without touching \a scanLine if the logarithmic \a range can't be handled this way
+  (e.g. if it isn't positive), then the caller colorizes with the generic loop.
+
+  When this method is called concurrently on the same gradient, the lookup table of the
+  logarithmic range must already be up to date, i.e. the method must have been called once with
+  the same \a range before.
+*/
+bool QCPColorGradient::colorizeClamped(const double *data, const QCPRange &range, QRgb *scanLine, int n, int dataIndexFactor, bool logarithmic)
+{
+  if (logarithmic && (mLogLookupRange != range || mLogLookupLevelCount != mLevelCount))
+    updateLogLookup(range);
+  if (logarithmic && mLogLookupLevels.isEmpty())
+    return false;
+  
+  const QRgb *colors = mColorBuffer.constData();
+  const int maxIndex = mLevelCount-1;
+  QRgb nanColor = colors[0]; // nhNone: NaN values shouldn't occur, map them to the lowest level like the generic loop does
+  switch (mNanHandling)
+  {
+    case nhNone:
+    case nhLowestColor: break;
+    case nhHighestColor: nanColor = colors[maxIndex]; break;
+    case nhTransparent: nanColor = qRgba(0, 0, 0, 0); break;
+    case nhNanColor: nanColor = mNanColor.rgba(); break;
+  }
+  
+  int i = 0;
+  if (!logarithmic)
+  {
+    const double lower = range.lower;
+    const double posToIndexFactor = maxIndex/range.size();
+#ifdef QCP_SSE2
+    const __m128d lowerPd = _mm_set1_pd(lower);
+    const __m128d factorPd = _mm_set1_pd(posToIndexFactor);
+    const __m128d zeroPd = _mm_setzero_pd();
+    const __m128d maxIndexPd = _mm_set1_pd(maxIndex);
+    for (; i+2<=n; i+=2)
+    {
+      const __m128d values = _mm_set_pd(data[dataIndexFactor*(i+1)], data[dataIndexFactor*i]);
+      // max returns its second operand if the first is NaN, so NaN positions become index 0:
+      const __m128d positions = _mm_min_pd(_mm_max_pd(_mm_mul_pd(_mm_sub_pd(values, lowerPd), factorPd), zeroPd), maxIndexPd);
+      const __m128i indices = _mm_cvttpd_epi32(positions);
+      scanLine[i] = colors[_mm_cvtsi128_si32(indices)];
+      scanLine[i+1] = colors[_mm_cvtsi128_si32(_mm_srli_si128(indices, 4))];
+      if (const int nanMask = _mm_movemask_pd(_mm_cmpunord_pd(values, values)))
+      {
+        if (nanMask & 1) scanLine[i] = nanColor;
+        if (nanMask & 2) scanLine[i+1] = nanColor;
+      }
+    }
+#endif
+    for (; i<n; ++i)
+    {
+      const double value = data[dataIndexFactor*i];
+      if (std::isnan(value))
+        scanLine[i] = nanColor;
+      else
+        scanLine[i] = colors[int(qBound(0.0, (value-lower)*posToIndexFactor, double(maxIndex)))];
+    }
+  } else
+  {
+    const int *levels = mLogLookupLevels.constData();
+    const double *thresholds = mLogLookupThresholds.constData();
+    const double lower = range.lower;
+    const double upper = thresholds[maxIndex]; // all values from here on have the highest level
+    const int shift = mLogLookupShift;
+    const quint64 base = mLogLookupBase;
+#ifdef QCP_SSE2
+    const __m128d lowerPd = _mm_set1_pd(lower);
+    const __m128d upperPd = _mm_set1_pd(upper);
+    const __m128i shiftEpi = _mm_cvtsi32_si128(shift);
+    const __m128i baseEpi = _mm_set_epi32(int(base >> 32), int(base), int(base >> 32), int(base));
+    double clamped[2];
+    for (; i+2<=n; i+=2)
+    {
+      const __m128d values = _mm_set_pd(data[dataIndexFactor*(i+1)], data[dataIndexFactor*i]);
+      // max returns its second operand if the first is NaN, so NaN values become the lower bound:
+      const __m128d clampedPd = _mm_min_pd(_mm_max_pd(values, lowerPd), upperPd);
+      const __m128i buckets = _mm_sub_epi64(_mm_srl_epi64(_mm_castpd_si128(clampedPd), shiftEpi), baseEpi);
+      _mm_storeu_pd(clamped, clampedPd);
+      int level = levels[_mm_cvtsi128_si32(buckets)];
+      scanLine[i] = colors[level+int(clamped[0] >= thresholds[level+1])];
+      level = levels[_mm_cvtsi128_si32(_mm_unpackhi_epi64(buckets, buckets))];
+      scanLine[i+1] = colors[level+int(clamped[1] >= thresholds[level+1])];
+      if (const int nanMask = _mm_movemask_pd(_mm_cmpunord_pd(values, values)))
+      {
+        if (nanMask & 1) scanLine[i] = nanColor;
+        if (nanMask & 2) scanLine[i+1] = nanColor;
+      }
+    }
+#endif
+    for (; i<n; ++i)
+    {
+      const double value = data[dataIndexFactor*i];
+      if (std::isnan(value))
+      {
+        scanLine[i] = nanColor;
+        continue;
+      }
+      const double clampedValue = qBound(lower, value, upper);
+      quint64 bits;
+      memcpy(&bits, &clampedValue, sizeof(bits));
+      const int level = levels[(bits >> shift)-base];
+      scanLine[i] = colors[level+int(clampedValue >= thresholds[level+1])];
+    }
+  }
+  return true;
+}
+
 /*! \internal
 
   This method is used to colorize a single data value given in \a position, to colors. The data
@@ -17130,6 +19863,70 @@ void QCPColorGradient::updateColorBuffer()
   }
   mColorBufferInvalidated = false;
 }
+
+/*! \internal
+
+  Builds the lookup table that \ref colorizeClamped uses to map values of the logarithmic data
+  \a range to color levels without evaluating a logarithm per value.
+
+  The table holds the value at which each level starts (the thresholds), and divides the range
+  into buckets by the bit pattern of the values: Positive doubles sort like their bit patterns, so
+  the exponent and the leading mantissa bits of a value select a bucket whose width is roughly
+  constant on the logarithmic scale. The mantissa bits are chosen such that a bucket is narrower
+  than a level, so each bucket stores the level of its first value and contains at most one
+  further threshold, which is resolved by a single comparison.
+
+  If the range isn't positive and finite, the table is left empty, so the generic loop in \ref
+  colorize is used. The table is rebuilt when the range or the level count changes.
+*/
+void QCPColorGradient::updateLogLookup(const QCPRange &range)
+{
+  mLogLookupRange = range;
+  mLogLookupLevelCount = mLevelCount;
+  mLogLookupLevels.clear();
+  mLogLookupThresholds.clear();
+  if (!(range.lower > 0 && range.upper > range.lower) || qIsInf(range.upper) || mLevelCount < 2)
+    return;
+  
+  // values where the levels start, the last entry is a sentinel for the comparison with level+1:
+  const int maxIndex = mLevelCount-1;
+  const double posToIndexFactor = maxIndex/qLn(range.upper/range.lower);
+  QVector<double> thresholds(mLevelCount+1);
+  thresholds[0] = range.lower;
+  for (int level=1; level<=maxIndex; ++level)
+    thresholds[level] = range.lower*qExp(level/posToIndexFactor);
+  thresholds[mLevelCount] = std::numeric_limits<double>::infinity();
+  
+  // with m mantissa bits, a bucket spans less than 2^-m in the natural logarithm, which must be
+  // below the level width 1/posToIndexFactor:
+  const int mantissaBits = qMax(0, qCeil(qLn(posToIndexFactor)/qLn(2.0)))+1;
+  if (mantissaBits > 52)
+    return;
+  const int shift = 52-mantissaBits;
+  quint64 lowerBits, upperBits;
+  memcpy(&lowerBits, &thresholds[0], sizeof(lowerBits));
+  memcpy(&upperBits, &thresholds[maxIndex], sizeof(upperBits));
+  const quint64 base = lowerBits >> shift;
+  const quint64 bucketCount = (upperBits >> shift)-base+1;
+  if (bucketCount > (1 << 22))
+    return;
+  
+  QVector<int> levels(static_cast<int>(bucketCount));
+  int level = 0;
+  for (int bucket=0; bucket<levels.size(); ++bucket)
+  {
+    const quint64 bucketBits = (base+quint64(bucket)) << shift;
+    double bucketStart;
+    memcpy(&bucketStart, &bucketBits, sizeof(bucketStart));
+    while (level < maxIndex && thresholds[level+1] <= bucketStart)
+      ++level;
+    levels[bucket] = level;
+  }
+  mLogLookupShift = shift;
+  mLogLookupBase = base;
+  mLogLookupLevels = levels;
+  mLogLookupThresholds = thresholds;
+}
 /* end of 'src/colorgradient.cpp' */
 
 
@@ -20810,6 +23607,812 @@ QCPGraphData::QCPGraphData(double key, double value) :
 {
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPGraphDataColumns
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPGraphDataColumns
+  \brief Holds the data of a QCPGraph as separate key and value columns
+  
+  In contrast to the \ref QCPGraphDataContainer, which stores \ref QCPGraphData points (an array
+  of structures), this class stores the keys and the values in two separate contiguous arrays (a
+  structure of arrays). Loops over one coordinate, like the min/max scans of \ref valueRange and
+  the binary searches of \ref findBegin and \ref findEnd, then only touch the memory of that
+  coordinate and can be vectorized by the compiler.
+  
+  The columns are either owned by this instance (\ref set, \ref add), or they are provided by the
+  application with \ref setRawData. In the latter case, the data isn't copied, which allows
+  displaying large data sets, e.g. from a memory mapped file, without doubling the memory usage.
+  The application must keep the arrays alive and unchanged as long as they are used. Modifying
+  external columns with \ref add first copies them into owned storage.
+  
+  The keys are always sorted ascending. A graph displays the columns after passing them to \ref
+  QCPGraph::setDataColumns.
+  
+  For real time data, the columns can be limited to a fixed number of data points with \ref
+  setCapacity. They then work as a ring buffer: Appending a data point with a key greater than or
+  equal to the existing ones takes constant time, and once the capacity is reached, the data point
+  with the smallest key is discarded in the same step. Neither the storage is reallocated nor the
+  remaining data points are moved, in contrast to combining \ref QCPDataContainer::add with \ref
+  QCPDataContainer::removeBefore.
+  
+  Each element of the ring is stored twice, at its position and one capacity further. This way, the
+  current data points always form one contiguous, sorted section of the storage, so \ref keys and
+  \ref values can be used directly by the graph and by binary searches, without first copying the
+  ring into a linear array. The price is twice the memory of the capacity.
+  
+  \see QCPGraphDataContainer
+*/
+
+/* start documentation of inline functions */
+
+/*! \fn bool QCPGraphDataColumns::isExternal() const
+  
+  Returns whether the columns are provided by the application via \ref setRawData, rather than
+  being owned by this instance.
+*/
+
+/*! \fn int QCPGraphDataColumns::capacity() const
+  
+  Returns the maximum number of data points, or 0 if the number of data points is unbounded.
+  
+  \see setCapacity
+*/
+
+/*! \fn const double *QCPGraphDataColumns::keys() const
+  
+  Returns a pointer to the contiguous, ascending key column with \ref size elements.
+*/
+
+/*! \fn const double *QCPGraphDataColumns::values() const
+  
+  Returns a pointer to the contiguous value column with \ref size elements.
+*/
+
+/*! \fn QCPGraphData QCPGraphDataColumns::at(int index) const
+  
+  Returns the data point at \a index, which must be in the range of 0 to \ref size - 1.
+*/
+
+/* end documentation of inline functions */
+
+/*!
+  Constructs empty data columns.
+*/
+QCPGraphDataColumns::QCPGraphDataColumns() :
+  mKeyData(nullptr),
+  mValueData(nullptr),
+  mSize(0),
+  mExternal(false),
+  mCapacity(0),
+  mStart(0),
+  mRevision(0)
+{
+}
+
+/*!
+  Limits the number of data points to \a capacity. Data points that are added beyond the capacity
+  replace the data points with the smallest keys, as described in the class documentation. If the
+  current data holds more data points, only the ones with the greatest keys are kept.
+  
+  Set \a capacity to 0 to remove the limit. External columns are copied into owned storage first.
+  
+  \see setRawData
+*/
+void QCPGraphDataColumns::setCapacity(int capacity)
+{
+  capacity = qMax(0, capacity);
+  if (capacity == mCapacity)
+    return;
+  detach();
+  QVector<double> keys, values;
+  copyWindow(keys, values);
+  mCapacity = capacity;
+  if (mCapacity > 0)
+  {
+    layoutRing(keys, values);
+  } else
+  {
+    mKeys.swap(keys);
+    mValues.swap(values);
+    mStart = 0;
+    updateDataPointers();
+  }
+}
+
+/*!
+  Replaces the current data with copies of the provided \a keys and \a values. If the vectors have
+  different sizes, only as many pairs as the smaller vector holds are used.
+  
+  If you can guarantee that the keys are sorted ascending, set \a alreadySorted to true to skip the
+  sorting.
+  
+  \see setRawData, add
+*/
+void QCPGraphDataColumns::set(const QVector<double> &keys, const QVector<double> &values, bool alreadySorted)
+{
+  const int n = qMin(keys.size(), values.size());
+  if (keys.size() != values.size())
+    qDebug() << Q_FUNC_INFO << "keys and values have different sizes:" << keys.size() << values.size();
+  QVector<double> sortedKeys(keys), sortedValues(values);
+  sortedKeys.resize(n);
+  sortedValues.resize(n);
+  if (!alreadySorted)
+    sortColumns(sortedKeys, sortedValues);
+  mExternal = false;
+  if (mCapacity > 0)
+  {
+    layoutRing(sortedKeys, sortedValues);
+  } else
+  {
+    mKeys.swap(sortedKeys);
+    mValues.swap(sortedValues);
+    updateDataPointers();
+  }
+}
+
+/*!
+  Replaces the current data with the external arrays \a keys and \a values, each holding \a size
+  elements. The arrays aren't copied, so they must stay valid and unchanged as long as these
+  columns (or a graph using them) access them. The keys must be sorted ascending.
+  
+  External columns have no capacity limit, so a previously set \ref setCapacity is reset to 0.
+  
+  \see set, isExternal
+*/
+void QCPGraphDataColumns::setRawData(const double *keys, const double *values, int size)
+{
+  mKeys.clear();
+  mValues.clear();
+  mCapacity = 0;
+  mStart = 0;
+  mKeyData = keys;
+  mValueData = values;
+  mSize = (keys && values) ? qMax(0, size) : 0;
+  mExternal = true;
+  ++mRevision;
+}
+
+/*!
+  Adds the provided \a keys and \a values to the current data. If the vectors have different sizes,
+  only as many pairs as the smaller vector holds are added.
+  
+  If you can guarantee that the keys are sorted ascending, set \a alreadySorted to true. If
+  additionally all keys are greater than or equal to the existing ones, they are simply appended.
+  With a \ref setCapacity "capacity" set, appending discards the data points with the smallest
+  keys once the capacity is reached.
+  
+  External columns are copied into owned storage first.
+*/
+void QCPGraphDataColumns::add(const QVector<double> &keys, const QVector<double> &values, bool alreadySorted)
+{
+  const int n = qMin(keys.size(), values.size());
+  if (keys.size() != values.size())
+    qDebug() << Q_FUNC_INFO << "keys and values have different sizes:" << keys.size() << values.size();
+  if (n == 0)
+    return;
+  detach();
+  const bool appendsSorted = alreadySorted && (mSize == 0 || keys.first() >= mKeyData[mSize-1]);
+  if (mCapacity > 0)
+  {
+    if (appendsSorted)
+    {
+      // data points that would be discarded within this call aren't written at all:
+      for (int i=qMax(0, n-mCapacity); i<n; ++i)
+        appendToRing(keys.at(i), values.at(i));
+    } else
+    {
+      QVector<double> mergedKeys, mergedValues;
+      copyWindow(mergedKeys, mergedValues);
+      mergedKeys.reserve(mSize+n);
+      mergedValues.reserve(mSize+n);
+      for (int i=0; i<n; ++i)
+      {
+        mergedKeys.append(keys.at(i));
+        mergedValues.append(values.at(i));
+      }
+      sortColumns(mergedKeys, mergedValues);
+      layoutRing(mergedKeys, mergedValues);
+    }
+    return;
+  }
+  mKeys.reserve(mSize+n);
+  mValues.reserve(mSize+n);
+  for (int i=0; i<n; ++i)
+  {
+    mKeys.append(keys.at(i));
+    mValues.append(values.at(i));
+  }
+  if (!appendsSorted)
+    sortColumns(mKeys, mValues);
+  updateDataPointers();
+}
+
+/*! \overload
+  
+  Adds the provided single data point to the current data. Appending a key that is greater than or
+  equal to the existing ones takes constant time, also when a \ref setCapacity "capacity" is set
+  and the data point with the smallest key is discarded.
+  
+  External columns are copied into owned storage first.
+*/
+void QCPGraphDataColumns::add(double key, double value)
+{
+  detach();
+  if (mCapacity > 0)
+  {
+    if (mSize == 0 || key >= mKeyData[mSize-1])
+    {
+      appendToRing(key, value);
+    } else if (mSize < mCapacity || key >= mKeyData[0])
+    {
+      QVector<double> insertedKeys, insertedValues;
+      copyWindow(insertedKeys, insertedValues);
+      const int index = int(std::upper_bound(insertedKeys.constBegin(), insertedKeys.constEnd(), key)-insertedKeys.constBegin());
+      insertedKeys.insert(index, key);
+      insertedValues.insert(index, value);
+      layoutRing(insertedKeys, insertedValues);
+    } // else the full ring would discard the new data point right away
+    return;
+  }
+  if (mSize == 0 || key >= mKeys.last())
+  {
+    mKeys.append(key);
+    mValues.append(value);
+  } else
+  {
+    const int index = int(std::upper_bound(mKeys.constBegin(), mKeys.constEnd(), key)-mKeys.constBegin());
+    mKeys.insert(index, key);
+    mValues.insert(index, value);
+  }
+  updateDataPointers();
+}
+
+/*!
+  Removes all data. External columns are released, but not freed. The storage of a ring buffer (see
+  \ref setCapacity) is kept for the next data points.
+*/
+void QCPGraphDataColumns::clear()
+{
+  if (mCapacity == 0)
+  {
+    mKeys.clear();
+    mValues.clear();
+  }
+  mExternal = false;
+  mSize = 0;
+  mStart = 0;
+  updateDataPointers();
+}
+
+/*!
+  Returns the index of the data point with a key that is equal to, just below, or just above \a
+  sortKey, following the same rules as \ref QCPDataContainer::findBegin. If there is no such data
+  point, \ref size is returned.
+  
+  \see findEnd
+*/
+int QCPGraphDataColumns::findBegin(double sortKey, bool expandedRange) const
+{
+  if (mSize == 0)
+    return 0;
+  int index = int(std::lower_bound(mKeyData, mKeyData+mSize, sortKey)-mKeyData);
+  if (expandedRange && index > 0)
+    --index;
+  return index;
+}
+
+/*!
+  Returns the index after the data point with a key that is equal to, just above, or just below \a
+  sortKey, following the same rules as \ref QCPDataContainer::findEnd.
+  
+  \see findBegin
+*/
+int QCPGraphDataColumns::findEnd(double sortKey, bool expandedRange) const
+{
+  if (mSize == 0)
+    return 0;
+  int index = int(std::upper_bound(mKeyData, mKeyData+mSize, sortKey)-mKeyData);
+  if (expandedRange && index < mSize)
+    ++index;
+  return index;
+}
+
+/*!
+  Returns the range encompassed by the keys. Since the keys are sorted, only the borders of the
+  requested \a signDomain need to be found. The output parameter \a foundRange indicates whether a
+  sensible range was found.
+*/
+QCPRange QCPGraphDataColumns::keyRange(bool &foundRange, QCP::SignDomain signDomain) const
+{
+  int begin = 0;
+  int end = mSize;
+  if (signDomain == QCP::sdNegative)
+    end = int(std::lower_bound(mKeyData, mKeyData+mSize, 0.0)-mKeyData);
+  else if (signDomain == QCP::sdPositive)
+    begin = int(std::upper_bound(mKeyData, mKeyData+mSize, 0.0)-mKeyData);
+  // skip invalid keys at the borders:
+  while (begin < end && !std::isfinite(mKeyData[begin]))
+    ++begin;
+  while (end > begin && !std::isfinite(mKeyData[end-1]))
+    --end;
+  foundRange = begin < end;
+  if (!foundRange)
+    return QCPRange();
+  QCPRange range;
+  range.lower = mKeyData[begin];
+  range.upper = mKeyData[end-1];
+  return range;
+}
+
+/*!
+  Returns the range encompassed by the values of the data points in the key range \a inKeyRange,
+  with the same rules as \ref QCPDataContainer::valueRange. If \a inKeyRange is equal to
+  <tt>QCPRange()</tt>, all data points are considered.
+*/
+QCPRange QCPGraphDataColumns::valueRange(bool &foundRange, QCP::SignDomain signDomain, const QCPRange &inKeyRange) const
+{
+  if (inKeyRange != QCPRange())
+    return valueRange(foundRange, findBegin(inKeyRange.lower, false), findEnd(inKeyRange.upper, false), signDomain);
+  else
+    return valueRange(foundRange, 0, mSize, signDomain);
+}
+
+/*! \overload
+  
+  Returns the range encompassed by the values of the data points with indices from \a begin up to
+  (but not including) \a end. Inf and NaN values as well as values outside of \a signDomain are
+  ignored.
+  
+  The loops only read the contiguous value column and select the bounds without branches, so they
+  are vectorized by the compiler.
+*/
+QCPRange QCPGraphDataColumns::valueRange(bool &foundRange, int begin, int end, QCP::SignDomain signDomain) const
+{
+  begin = qBound(0, begin, mSize);
+  end = qBound(begin, end, mSize);
+  double lower = std::numeric_limits<double>::infinity();
+  double upper = -std::numeric_limits<double>::infinity();
+  const double *values = mValueData;
+  switch (signDomain)
+  {
+    case QCP::sdBoth:
+    {
+      for (int i=begin; i<end; ++i)
+      {
+        const double v = values[i];
+        const bool valid = v-v == 0; // false for NaN and Inf
+        lower = (valid && v < lower) ? v : lower;
+        upper = (valid && v > upper) ? v : upper;
+      }
+      break;
+    }
+    case QCP::sdNegative:
+    {
+      for (int i=begin; i<end; ++i)
+      {
+        const double v = values[i];
+        const bool valid = v-v == 0 && v < 0;
+        lower = (valid && v < lower) ? v : lower;
+        upper = (valid && v > upper) ? v : upper;
+      }
+      break;
+    }
+    case QCP::sdPositive:
+    {
+      for (int i=begin; i<end; ++i)
+      {
+        const double v = values[i];
+        const bool valid = v-v == 0 && v > 0;
+        lower = (valid && v < lower) ? v : lower;
+        upper = (valid && v > upper) ? v : upper;
+      }
+      break;
+    }
+  }
+  foundRange = lower <= upper;
+  if (!foundRange)
+    return QCPRange();
+  QCPRange range;
+  range.lower = lower;
+  range.upper = upper;
+  return range;
+}
+
+/*! \internal
+  
+  Copies external columns into owned storage, so they can be modified.
+*/
+void QCPGraphDataColumns::detach()
+{
+  if (!mExternal)
+    return;
+  mKeys.resize(mSize);
+  mValues.resize(mSize);
+  if (mSize > 0)
+  {
+    std::copy(mKeyData, mKeyData+mSize, mKeys.begin());
+    std::copy(mValueData, mValueData+mSize, mValues.begin());
+  }
+  mExternal = false;
+  updateDataPointers();
+}
+
+/*! \internal
+  
+  Points the column pointers to the owned storage after it was modified, and advances the \ref
+  revision. For a ring buffer, they point to the start of the current window and the size is
+  maintained by the caller.
+*/
+void QCPGraphDataColumns::updateDataPointers()
+{
+  ++mRevision;
+  if (mCapacity > 0)
+  {
+    mKeyData = mKeys.constData()+mStart;
+    mValueData = mValues.constData()+mStart;
+  } else
+  {
+    mSize = int(mKeys.size());
+    mKeyData = mKeys.constData();
+    mValueData = mValues.constData();
+  }
+}
+
+/*! \internal
+  
+  Copies the current data points into the linear arrays \a keys and \a values.
+*/
+void QCPGraphDataColumns::copyWindow(QVector<double> &keys, QVector<double> &values) const
+{
+  keys.resize(mSize);
+  values.resize(mSize);
+  if (mSize > 0)
+  {
+    std::copy(mKeyData, mKeyData+mSize, keys.begin());
+    std::copy(mValueData, mValueData+mSize, values.begin());
+  }
+}
+
+/*! \internal
+  
+  Replaces the ring buffer storage with the sorted linear arrays \a keys and \a values. If they hold
+  more data points than the capacity, only the ones with the greatest keys are kept. Each data point
+  is written to its position and its mirror position one capacity further, see the class
+  documentation.
+*/
+void QCPGraphDataColumns::layoutRing(const QVector<double> &keys, const QVector<double> &values)
+{
+  const int n = int(keys.size());
+  const int first = qMax(0, n-mCapacity);
+  QVector<double> ringKeys(2*mCapacity), ringValues(2*mCapacity);
+  for (int i=first; i<n; ++i)
+  {
+    const int position = i-first;
+    ringKeys[position] = ringKeys[position+mCapacity] = keys.at(i);
+    ringValues[position] = ringValues[position+mCapacity] = values.at(i);
+  }
+  mKeys.swap(ringKeys);
+  mValues.swap(ringValues);
+  mStart = 0;
+  mSize = n-first;
+  updateDataPointers();
+}
+
+/*! \internal
+  
+  Appends the data point to the ring buffer in constant time. The key must be greater than or equal
+  to the existing keys. If the ring is full, the data point with the smallest key is discarded.
+*/
+void QCPGraphDataColumns::appendToRing(double key, double value)
+{
+  if (mSize == mCapacity)
+  {
+    mStart = (mStart+1)%mCapacity;
+    --mSize;
+  }
+  const int position = (mStart+mSize)%mCapacity;
+  double *keyData = mKeys.data();
+  double *valueData = mValues.data();
+  keyData[position] = keyData[position+mCapacity] = key;
+  valueData[position] = valueData[position+mCapacity] = value;
+  ++mSize;
+  updateDataPointers();
+}
+
+/*! \internal
+  
+  Sorts the linear arrays \a keys and \a values by key, keeping the order of data points with equal
+  keys. Sorted data is detected in linear time and left untouched.
+*/
+void QCPGraphDataColumns::sortColumns(QVector<double> &keys, QVector<double> &values)
+{
+  if (std::is_sorted(keys.constBegin(), keys.constEnd()))
+    return;
+  const int n = int(keys.size());
+  QVector<QCPGraphData> data(n);
+  for (int i=0; i<n; ++i)
+    data[i] = QCPGraphData(keys.at(i), values.at(i));
+  std::stable_sort(data.begin(), data.end(), qcpLessThanSortKey<QCPGraphData>);
+  for (int i=0; i<n; ++i)
+  {
+    keys[i] = data.at(i).key;
+    values[i] = data.at(i).value;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPGraphDataQueue
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPGraphDataQueue
+  \brief Passes data points from producer threads to a QCPGraph
+  
+  The data of a graph may only be modified on the thread of the QCustomPlot, usually the GUI
+  thread. Data acquired on other threads would normally have to be marshalled to the GUI thread
+  sample by sample, e.g. with queued signals. Instead, producer threads can \ref push data points
+  into a data queue, which is set on the graph with \ref QCPGraph::setDataQueue.
+  
+  Pushing is lock-free and safe from any number of threads at the same time: Each call appends one
+  batch to an intrusive multiple-producer single-consumer queue with a single atomic exchange, and
+  never waits for the consumer or other producers. Push the data points in batches rather than one
+  by one where possible, since every batch requires an allocation.
+  
+  The first push after a merge emits \ref dataPushed, which makes the graph request a replot with
+  \ref QCustomPlot::rpQueuedReplot. When the replot happens, the graph takes all pending batches
+  with \ref takeAll and adds them to its data in a single step (see \ref QCPGraph::mergeDataQueue).
+  Consequently, the data is merged at most once per replot, regardless of how many batches arrive
+  in the meantime.
+  
+  The queue measures the \ref latency from pushing a batch until it was merged, and the \ref
+  throughput of merged data points. The statistics are updated by \ref takeAll and should be read
+  on the same thread, usually the GUI thread.
+  
+  Since the queue is shared via QSharedPointer between the graph and the producers, it stays alive
+  until the last of them releases it. A queue should only be set on one graph.
+*/
+
+/* start documentation of inline functions */
+
+/*! \fn qint64 QCPGraphDataQueue::mergedCount() const
+  
+  Returns the number of data points that were taken from the queue since the construction or the
+  last call of \ref resetStatistics.
+*/
+
+/*! \fn qint64 QCPGraphDataQueue::mergedBatchCount() const
+  
+  Returns the number of batches that were taken from the queue since the construction or the last
+  call of \ref resetStatistics. Together with \ref mergedCount, this gives the average batch size.
+*/
+
+/*! \fn double QCPGraphDataQueue::maxLatency() const
+  
+  Returns the highest \ref latency in milliseconds since the construction or the last call of \ref
+  resetStatistics.
+*/
+
+/*! \fn double QCPGraphDataQueue::throughput() const
+  
+  Returns the number of merged data points per second, as an exponential moving average over the
+  last couple of merges.
+*/
+
+/* end documentation of inline functions */
+/* start documentation of signals */
+
+/*! \fn void QCPGraphDataQueue::dataPushed()
+  
+  This signal is emitted by the first \ref push after the pending data was taken with \ref takeAll.
+  It is emitted on the producer thread, so receivers on other threads are called via a queued
+  connection.
+*/
+
+/* end documentation of signals */
+
+/*!
+  Constructs an empty data queue.
+*/
+QCPGraphDataQueue::QCPGraphDataQueue(QObject *parent) :
+  QObject(parent),
+  mHead(&mStub),
+  mTail(&mStub),
+  mNotifyPending(0)
+{
+  mStub.pushTime = 0;
+  mClock.start();
+  resetStatistics();
+}
+
+QCPGraphDataQueue::~QCPGraphDataQueue()
+{
+  while (Batch *batch = dequeue())
+    delete batch;
+}
+
+/*!
+  Returns the time in milliseconds from pushing the oldest batch of the last merge until it was
+  taken with \ref takeAll. If \a average is set to true, an exponential moving average over the last
+  couple of merges is returned.
+  
+  \see maxLatency
+*/
+double QCPGraphDataQueue::latency(bool average) const
+{
+  return average ? mLatencyAverage : mLatency;
+}
+
+/*!
+  Pushes the data points given by \a keys and \a values as one batch. If the vectors have different
+  sizes, only as many pairs as the smaller vector holds are pushed.
+  
+  This method may be called from any thread.
+*/
+void QCPGraphDataQueue::push(const QVector<double> &keys, const QVector<double> &values)
+{
+  const int n = int(qMin(keys.size(), values.size()));
+  if (n == 0)
+    return;
+  Batch *batch = new Batch;
+  batch->data.resize(n);
+  for (int i=0; i<n; ++i)
+    batch->data[i] = QCPGraphData(keys.at(i), values.at(i));
+  enqueue(batch);
+}
+
+/*! \overload
+  
+  Pushes the data points given by \a data as one batch. The vector is implicitly shared, so it isn't
+  copied as long as the caller doesn't modify it afterwards.
+  
+  This method may be called from any thread.
+*/
+void QCPGraphDataQueue::push(const QVector<QCPGraphData> &data)
+{
+  if (data.isEmpty())
+    return;
+  Batch *batch = new Batch;
+  batch->data = data;
+  enqueue(batch);
+}
+
+/*! \overload
+  
+  Pushes a single data point. Prefer pushing batches for high data rates, since every push
+  allocates a batch.
+  
+  This method may be called from any thread.
+*/
+void QCPGraphDataQueue::push(double key, double value)
+{
+  Batch *batch = new Batch;
+  batch->data.append(QCPGraphData(key, value));
+  enqueue(batch);
+}
+
+/*!
+  Appends all pending data points to \a data, in the order they were pushed, and updates the
+  statistics. Returns whether any data points were taken.
+  
+  Batches that are pushed while this method runs are left for the next call, so the time spent here
+  is bounded even if producers push continuously.
+  
+  This method must only be called from one thread at a time, usually by \ref
+  QCPGraph::mergeDataQueue on the GUI thread.
+*/
+bool QCPGraphDataQueue::takeAll(QVector<QCPGraphData> &data)
+{
+  // reset the notification before draining, so a batch pushed meanwhile triggers a new one:
+  mNotifyPending.fetchAndStoreOrdered(0);
+  const qint64 now = mClock.nsecsElapsed();
+  qint64 oldestPushTime = now;
+  int batchCount = 0;
+  const int sizeBefore = int(data.size());
+  while (Batch *batch = dequeue())
+  {
+    if (batchCount == 0)
+      oldestPushTime = batch->pushTime; // batches are taken in push order
+    if (data.isEmpty())
+      data = batch->data;
+    else
+      data += batch->data;
+    ++batchCount;
+    const bool pushedMeanwhile = batch->pushTime > now;
+    delete batch;
+    if (pushedMeanwhile) // leave the rest for the next merge, so fast producers can't stall the consumer
+      break;
+  }
+  if (batchCount == 0)
+    return false;
+  
+  const int count = int(data.size())-sizeBefore;
+  mMergedCount += count;
+  mMergedBatchCount += batchCount;
+  mLatency = (now-oldestPushTime)*1e-6;
+  mMaxLatency = qMax(mMaxLatency, mLatency);
+  if (!qFuzzyIsNull(mLatencyAverage))
+    mLatencyAverage = mLatencyAverage*0.9 + mLatency*0.1; // exponential moving average with a time constant of 10 last merges
+  else
+    mLatencyAverage = mLatency;
+  if (mLastMergeTime >= 0 && now > mLastMergeTime)
+  {
+    const double rate = count/((now-mLastMergeTime)*1e-9);
+    if (!qFuzzyIsNull(mThroughput))
+      mThroughput = mThroughput*0.9 + rate*0.1;
+    else
+      mThroughput = rate;
+  }
+  mLastMergeTime = now;
+  return true;
+}
+
+/*!
+  Resets the counters, latencies and the throughput to zero. Pending data points are kept.
+*/
+void QCPGraphDataQueue::resetStatistics()
+{
+  mLastMergeTime = -1;
+  mMergedCount = 0;
+  mMergedBatchCount = 0;
+  mLatency = 0;
+  mLatencyAverage = 0;
+  mMaxLatency = 0;
+  mThroughput = 0;
+}
+
+/*! \internal
+  
+  Timestamps \a batch and appends it to the queue, then emits \ref dataPushed if this is the first
+  batch since the last \ref takeAll. Producers only exchange the head pointer and link the previous
+  head to the new batch, so they never block each other.
+*/
+void QCPGraphDataQueue::enqueue(Batch *batch)
+{
+  batch->pushTime = mClock.nsecsElapsed();
+  batch->next.storeRelease(nullptr);
+  Batch *previous = mHead.fetchAndStoreOrdered(batch);
+  previous->next.storeRelease(batch);
+  if (batch != &mStub && mNotifyPending.testAndSetOrdered(0, 1))
+    emit dataPushed();
+}
+
+/*! \internal
+  
+  Removes the oldest batch from the queue and returns it, or returns \c nullptr if the queue is
+  empty. The queue always holds a stub batch, so the consumer never touches the head pointer of the
+  producers unless the queue runs empty. A batch whose producer has exchanged the head but not yet
+  linked it is left for the next call.
+*/
+QCPGraphDataQueue::Batch *QCPGraphDataQueue::dequeue()
+{
+  Batch *tail = mTail;
+  Batch *next = tail->next.loadAcquire();
+  if (tail == &mStub)
+  {
+    if (!next)
+      return nullptr;
+    mTail = next;
+    tail = next;
+    next = next->next.loadAcquire();
+  }
+  if (next)
+  {
+    mTail = next;
+    return tail;
+  }
+  if (tail != mHead.loadAcquire())
+    return nullptr;
+  enqueue(&mStub);
+  next = tail->next.loadAcquire();
+  if (next)
+  {
+    mTail = next;
+    return tail;
+  }
+  return nullptr;
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////// QCPGraph
@@ -20911,11 +24514,16 @@ QCPGraph::~QCPGraph()
   the \ref QCPDataContainer<DataType>::set method on the graph's data container directly:
   \snippet documentation/doc-code-snippets/mainwindow.cpp qcpgraph-datasharing-2
   
+  If the graph displayed data columns (see \ref setDataColumns), it switches back to the data
+  container.
+  
   \see addData
 */
 void QCPGraph::setData(QSharedPointer<QCPGraphDataContainer> data)
 {
   mDataContainer = data;
+  mDataColumns.clear();
+  markDirty();
 }
 
 /*! \overload
@@ -20931,10 +24539,56 @@ void QCPGraph::setData(QSharedPointer<QCPGraphDataContainer> data)
 */
 void QCPGraph::setData(const QVector<double> &keys, const QVector<double> &values, bool alreadySorted)
 {
+  mDataColumns.clear();
   mDataContainer->clear();
   addData(keys, values, alreadySorted);
 }
 
+/*!
+  Makes the graph display the key and value columns provided by \a columns instead of its data
+  container (see \ref data). Pass a null pointer to switch back to the data container.
+  
+  Data columns store keys and values in separate arrays and may refer to external arrays without
+  copying them (see \ref QCPGraphDataColumns::setRawData). This is useful for very large data sets
+  which are produced elsewhere, like measurements. As with data containers, multiple graphs may
+  share the same columns, e.g. a magnitude and a phase graph may be built from columns sharing one
+  external key array.
+  
+  While columns are set, \ref addData adds to the columns, and the data point based interface
+  (\ref dataCount, \ref dataMainKey, etc.) as well as selection refer to the columns. Item tracers
+  (\ref QCPItemTracer::setGraph) and channel fills (\ref setChannelFillGraph) use that interface as
+  well, so they follow the columns, too. The data container returned by \ref data is left
+  untouched.
+*/
+void QCPGraph::setDataColumns(QSharedPointer<QCPGraphDataColumns> columns)
+{
+  mDataColumns = columns;
+  markDirty();
+}
+
+/*!
+  Sets the data queue through which other threads can feed data points to this graph. Pass a null
+  pointer to remove the queue.
+  
+  Whenever producers push data into the queue, the graph requests a replot with \ref
+  QCustomPlot::rpQueuedReplot. Before drawing, the replot merges the pending data into the data
+  container, or into the data columns if they are set (see \ref mergeDataQueue). The data must not
+  be modified directly from the producer threads.
+  
+  \see QCPGraphDataQueue
+*/
+void QCPGraph::setDataQueue(QSharedPointer<QCPGraphDataQueue> queue)
+{
+  if (mDataQueue)
+    disconnect(mDataQueue.data(), SIGNAL(dataPushed()), this, SLOT(dataQueueFilled()));
+  mDataQueue = queue;
+  if (mDataQueue)
+  {
+    connect(mDataQueue.data(), SIGNAL(dataPushed()), this, SLOT(dataQueueFilled()), Qt::QueuedConnection);
+    dataQueueFilled(); // data may have been pushed before the connection existed
+  }
+}
+
 /*!
   Sets how the single data points are connected in the plot. For scatter-only plots, set \a ls to
   \ref lsNone and \ref setScatterStyle to the desired scatter style.
@@ -20944,6 +24598,7 @@ void QCPGraph::setData(const QVector<double> &keys, const QVector<double> &value
 void QCPGraph::setLineStyle(LineStyle ls)
 {
   mLineStyle = ls;
+  markStyleDirty();
 }
 
 /*!
@@ -20955,6 +24610,7 @@ void QCPGraph::setLineStyle(LineStyle ls)
 void QCPGraph::setScatterStyle(const QCPScatterStyle &style)
 {
   mScatterStyle = style;
+  markStyleDirty();
 }
 
 /*!
@@ -20971,6 +24627,7 @@ void QCPGraph::setScatterStyle(const QCPScatterStyle &style)
 void QCPGraph::setScatterSkip(int skip)
 {
   mScatterSkip = qMax(0, skip);
+  markDirty();
 }
 
 /*!
@@ -21000,6 +24657,7 @@ void QCPGraph::setChannelFillGraph(QCPGraph *targetGraph)
   }
   
   mChannelFillGraph = targetGraph;
+  markDirty();
 }
 
 /*!
@@ -21017,6 +24675,10 @@ void QCPGraph::setChannelFillGraph(QCPGraph *targetGraph)
   reproduced reliably, as well as the overall shape of the data set. The replot time reduces
   dramatically though. This allows QCustomPlot to display large amounts of data in realtime.
   
+  If there are very many data points per pixel, line plots use the min/max index of the data
+  container (see \ref QCPDataContainer::setValueIndexEnabled) instead of visiting every data point,
+  so the replot time then only depends on the width of the plot in pixels.
+  
   \image html adaptive-sampling-scatter.png "A scatter plot of 100,000 points without and with adaptive sampling"
   
   Care must be taken when using high-density scatter plots in combination with adaptive sampling.
@@ -21049,9 +24711,16 @@ void QCPGraph::setAdaptiveSampling(bool enabled)
   
   Alternatively, you can also access and modify the data directly via the \ref data method, which
   returns a pointer to the internal data container.
+  
+  If the graph displays data columns (see \ref setDataColumns), the points are added to them.
 */
 void QCPGraph::addData(const QVector<double> &keys, const QVector<double> &values, bool alreadySorted)
 {
+  if (mDataColumns)
+  {
+    mDataColumns->add(keys, values, alreadySorted);
+    return;
+  }
   if (keys.size() != values.size())
     qDebug() << Q_FUNC_INFO << "keys and values have different sizes:" << keys.size() << values.size();
   const int n = qMin(keys.size(), values.size());
@@ -21078,7 +24747,156 @@ void QCPGraph::addData(const QVector<double> &keys, const QVector<double> &value
 */
 void QCPGraph::addData(double key, double value)
 {
-  mDataContainer->add(QCPGraphData(key, value));
+  if (mDataColumns)
+    mDataColumns->add(key, value);
+  else
+    mDataContainer->add(QCPGraphData(key, value));
+}
+
+/*!
+  Takes all data points that were pushed into the data queue (see \ref setDataQueue) and adds them
+  to the data container, or to the data columns if they are set. Returns the number of added data
+  points.
+  
+  This is called by \ref QCustomPlot::replot for every graph, so it usually isn't necessary to call
+  it manually. It must be called on the thread of the QCustomPlot.
+*/
+int QCPGraph::mergeDataQueue()
+{
+  if (!mDataQueue)
+    return 0;
+  QVector<QCPGraphData> data;
+  if (!mDataQueue->takeAll(data))
+    return 0;
+  const bool sorted = std::is_sorted(data.constBegin(), data.constEnd(), qcpLessThanSortKey<QCPGraphData>);
+  if (mDataColumns)
+  {
+    QVector<double> keys(data.size()), values(data.size());
+    for (int i=0; i<data.size(); ++i)
+    {
+      keys[i] = data.at(i).key;
+      values[i] = data.at(i).value;
+    }
+    mDataColumns->add(keys, values, sorted);
+  } else
+    mDataContainer->add(data, sorted);
+  return int(data.size());
+}
+
+/* inherits documentation from base class */
+int QCPGraph::dataCount() const
+{
+  if (mDataColumns)
+    return mDataColumns->size();
+  return QCPAbstractPlottable1D<QCPGraphData>::dataCount();
+}
+
+/* inherits documentation from base class */
+double QCPGraph::dataMainKey(int index) const
+{
+  if (!mDataColumns)
+    return QCPAbstractPlottable1D<QCPGraphData>::dataMainKey(index);
+  if (index >= 0 && index < mDataColumns->size())
+    return mDataColumns->key(index);
+  qDebug() << Q_FUNC_INFO << "Index out of bounds" << index;
+  return 0;
+}
+
+/* inherits documentation from base class */
+double QCPGraph::dataSortKey(int index) const
+{
+  if (!mDataColumns)
+    return QCPAbstractPlottable1D<QCPGraphData>::dataSortKey(index);
+  return dataMainKey(index);
+}
+
+/* inherits documentation from base class */
+double QCPGraph::dataMainValue(int index) const
+{
+  if (!mDataColumns)
+    return QCPAbstractPlottable1D<QCPGraphData>::dataMainValue(index);
+  if (index >= 0 && index < mDataColumns->size())
+    return mDataColumns->value(index);
+  qDebug() << Q_FUNC_INFO << "Index out of bounds" << index;
+  return 0;
+}
+
+/* inherits documentation from base class */
+QCPRange QCPGraph::dataValueRange(int index) const
+{
+  if (!mDataColumns)
+    return QCPAbstractPlottable1D<QCPGraphData>::dataValueRange(index);
+  const double value = dataMainValue(index);
+  return QCPRange(value, value);
+}
+
+/* inherits documentation from base class */
+QPointF QCPGraph::dataPixelPosition(int index) const
+{
+  if (!mDataColumns)
+    return QCPAbstractPlottable1D<QCPGraphData>::dataPixelPosition(index);
+  if (index >= 0 && index < mDataColumns->size())
+    return coordsToPixels(mDataColumns->key(index), mDataColumns->value(index));
+  qDebug() << Q_FUNC_INFO << "Index out of bounds" << index;
+  return QPointF();
+}
+
+/* inherits documentation from base class */
+QCPDataSelection QCPGraph::selectTestRect(const QRectF &rect, bool onlySelectable) const
+{
+  if (!mDataColumns)
+    return QCPAbstractPlottable1D<QCPGraphData>::selectTestRect(rect, onlySelectable);
+  
+  QCPDataSelection result;
+  if ((onlySelectable && mSelectable == QCP::stNone) || mDataColumns->isEmpty())
+    return result;
+  if (!mKeyAxis || !mValueAxis)
+    return result;
+  
+  // convert rect given in pixels to ranges given in plot coordinates:
+  double key1, value1, key2, value2;
+  pixelsToCoords(rect.topLeft(), key1, value1);
+  pixelsToCoords(rect.bottomRight(), key2, value2);
+  QCPRange keyRange(key1, key2); // QCPRange normalizes internally so we don't have to care about whether key1 < key2
+  QCPRange valueRange(value1, value2);
+  const int begin = mDataColumns->findBegin(keyRange.lower, false);
+  const int end = mDataColumns->findEnd(keyRange.upper, false);
+  
+  int currentSegmentBegin = -1; // -1 means we're currently not in a segment that's contained in rect
+  for (int i=begin; i<end; ++i)
+  {
+    if (currentSegmentBegin == -1)
+    {
+      if (valueRange.contains(mDataColumns->value(i))) // start segment
+        currentSegmentBegin = i;
+    } else if (!valueRange.contains(mDataColumns->value(i))) // segment just ended
+    {
+      result.addDataRange(QCPDataRange(currentSegmentBegin, i), false);
+      currentSegmentBegin = -1;
+    }
+  }
+  // process potential last segment:
+  if (currentSegmentBegin != -1)
+    result.addDataRange(QCPDataRange(currentSegmentBegin, end), false);
+  
+  result.simplify();
+  return result;
+}
+
+/* inherits documentation from base class */
+int QCPGraph::findBegin(double sortKey, bool expandedRange) const
+{
+  if (mDataColumns)
+    return mDataColumns->findBegin(sortKey, expandedRange);
+  return QCPAbstractPlottable1D<QCPGraphData>::findBegin(sortKey, expandedRange);
+}
+
+/* inherits documentation from base class */
+int QCPGraph::findEnd(double sortKey, bool expandedRange) const
+{
+  if (mDataColumns)
+    return mDataColumns->findEnd(sortKey, expandedRange);
+  return QCPAbstractPlottable1D<QCPGraphData>::findEnd(sortKey, expandedRange);
 }
 
 /*!
@@ -21091,20 +24909,17 @@ void QCPGraph::addData(double key, double value)
 */
 double QCPGraph::selectTest(const QPointF &pos, bool onlySelectable, QVariant *details) const
 {
-  if ((onlySelectable && mSelectable == QCP::stNone) || mDataContainer->isEmpty())
+  if ((onlySelectable && mSelectable == QCP::stNone) || dataCount() == 0)
     return -1;
   if (!mKeyAxis || !mValueAxis)
     return -1;
   
   if (mKeyAxis.data()->axisRect()->rect().contains(pos.toPoint()) || mParentPlot->interactions().testFlag(QCP::iSelectPlottablesBeyondAxisRect))
   {
-    QCPGraphDataContainer::const_iterator closestDataPoint = mDataContainer->constEnd();
-    double result = pointDistance(pos, closestDataPoint);
+    int pointIndex;
+    double result = pointDistance(pos, pointIndex);
     if (details)
-    {
-      int pointIndex = int(closestDataPoint-mDataContainer->constBegin());
       details->setValue(QCPDataSelection(QCPDataRange(pointIndex, pointIndex+1)));
-    }
     return result;
   } else
     return -1;
@@ -21113,12 +24928,16 @@ double QCPGraph::selectTest(const QPointF &pos, bool onlySelectable, QVariant *d
 /* inherits documentation from base class */
 QCPRange QCPGraph::getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain) const
 {
+  if (mDataColumns)
+    return mDataColumns->keyRange(foundRange, inSignDomain);
   return mDataContainer->keyRange(foundRange, inSignDomain);
 }
 
 /* inherits documentation from base class */
 QCPRange QCPGraph::getValueRange(bool &foundRange, QCP::SignDomain inSignDomain, const QCPRange &inKeyRange) const
 {
+  if (mDataColumns)
+    return mDataColumns->valueRange(foundRange, inSignDomain, inKeyRange);
   return mDataContainer->valueRange(foundRange, inSignDomain, inKeyRange);
 }
 
@@ -21126,10 +24945,12 @@ QCPRange QCPGraph::getValueRange(bool &foundRange, QCP::SignDomain inSignDomain,
 void QCPGraph::draw(QCPPainter *painter)
 {
   if (!mKeyAxis || !mValueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return; }
-  if (mKeyAxis.data()->range().size() <= 0 || mDataContainer->isEmpty()) return;
+  if (mKeyAxis.data()->range().size() <= 0 || dataCount() == 0) return;
   if (mLineStyle == lsNone && mScatterStyle.isNone()) return;
   
   QVector<QPointF> lines, scatters; // line and (if necessary) scatter pixel coordinates will be stored here while iterating over segments
+  QCPReplotProfiler *profiler = mParentPlot->profiler();
+  QElapsedTimer dataTimer; // measures the data extraction for the profiler
   
   // loop over and draw segments of unselected/selected data:
   QList<QCPDataRange> selectedSegments, unselectedSegments, allSegments;
@@ -21140,15 +24961,19 @@ void QCPGraph::draw(QCPPainter *painter)
     bool isSelectedSegment = i >= unselectedSegments.size();
     // get line pixel points appropriate to line style:
     QCPDataRange lineDataRange = isSelectedSegment ? allSegments.at(i) : allSegments.at(i).adjusted(-1, 1); // unselected segments extend lines to bordering selected data point (safe to exceed total data bounds in first/last segment, getLines takes care)
+    if (profiler)
+      dataTimer.start();
     getLines(&lines, lineDataRange);
+    if (profiler)
+      profiler->addDataTime(this, dataTimer.nsecsElapsed()*1e-6);
     
     // check data validity if flag set:
 #ifdef QCUSTOMPLOT_CHECK_DATA
-    QCPGraphDataContainer::const_iterator it;
-    for (it = mDataContainer->constBegin(); it != mDataContainer->constEnd(); ++it)
+    for (int k=0; k<dataCount(); ++k)
     {
-      if (QCP::isInvalidData(it->key, it->value))
-        qDebug() << Q_FUNC_INFO << "Data point at" << it->key << "invalid." << "Plottable name:" << name();
+      const QCPGraphData current = dataAt(k);
+      if (QCP::isInvalidData(current.key, current.value))
+        qDebug() << Q_FUNC_INFO << "Data point at" << current.key << "invalid." << "Plottable name:" << name();
     }
 #endif
     
@@ -21180,7 +25005,11 @@ void QCPGraph::draw(QCPPainter *painter)
       finalScatterStyle = mSelectionDecorator->getFinalScatterStyle(mScatterStyle);
     if (!finalScatterStyle.isNone())
     {
+      if (profiler)
+        dataTimer.start();
       getScatters(&scatters, allSegments.at(i));
+      if (profiler)
+        profiler->addDataTime(this, dataTimer.nsecsElapsed()*1e-6);
       drawScatterPlot(painter, scatters, finalScatterStyle);
     }
   }
@@ -21225,6 +25054,12 @@ void QCPGraph::drawLegendIcon(QCPPainter *painter, const QRectF &rect) const
   }
 }
 
+/* inherits documentation from base class */
+quint32 QCPGraph::dataRevision() const
+{
+  return mDataColumns ? mDataColumns->revision() : mDataContainer->revision();
+}
+
 /*! \internal
 
   This method retrieves an optimized set of data points via \ref getOptimizedLineData, and branches
@@ -21248,18 +25083,31 @@ void QCPGraph::drawLegendIcon(QCPPainter *painter, const QRectF &rect) const
 void QCPGraph::getLines(QVector<QPointF> *lines, const QCPDataRange &dataRange) const
 {
   if (!lines) return;
-  QCPGraphDataContainer::const_iterator begin, end;
-  getVisibleDataBounds(begin, end, dataRange);
-  if (begin == end)
+  QVector<QCPGraphData> lineData;
+  if (mDataColumns)
   {
-    lines->clear();
-    return;
+    int begin, end;
+    getVisibleColumnBounds(begin, end, dataRange);
+    if (begin == end)
+    {
+      lines->clear();
+      return;
+    }
+    if (mLineStyle != lsNone)
+      getColumnLineData(&lineData, begin, end);
+  } else
+  {
+    QCPGraphDataContainer::const_iterator begin, end;
+    getVisibleDataBounds(begin, end, dataRange);
+    if (begin == end)
+    {
+      lines->clear();
+      return;
+    }
+    if (mLineStyle != lsNone)
+      getOptimizedLineData(&lineData, begin, end);
   }
   
-  QVector<QCPGraphData> lineData;
-  if (mLineStyle != lsNone)
-    getOptimizedLineData(&lineData, begin, end);
-  
   if (mKeyAxis->rangeReversed() != (mKeyAxis->orientation() == Qt::Vertical)) // make sure key pixels are sorted ascending in lineData (significantly simplifies following processing)
     std::reverse(lineData.begin(), lineData.end());
 
@@ -21293,41 +25141,42 @@ void QCPGraph::getScatters(QVector<QPointF> *scatters, const QCPDataRange &dataR
   QCPAxis *valueAxis = mValueAxis.data();
   if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; scatters->clear(); return; }
   
-  QCPGraphDataContainer::const_iterator begin, end;
-  getVisibleDataBounds(begin, end, dataRange);
-  if (begin == end)
-  {
-    scatters->clear();
-    return;
-  }
-  
   QVector<QCPGraphData> data;
-  getOptimizedScatterData(&data, begin, end);
-  
-  if (mKeyAxis->rangeReversed() != (mKeyAxis->orientation() == Qt::Vertical)) // make sure key pixels are sorted ascending in data (significantly simplifies following processing)
-    std::reverse(data.begin(), data.end());
-  
-  scatters->resize(data.size());
-  if (keyAxis->orientation() == Qt::Vertical)
+  if (mDataColumns)
   {
-    for (int i=0; i<data.size(); ++i)
+    int begin, end;
+    getVisibleColumnBounds(begin, end, dataRange);
+    if (begin == end)
     {
-      if (!qIsNaN(data.at(i).value))
-      {
-        (*scatters)[i].setX(valueAxis->coordToPixel(data.at(i).value));
-        (*scatters)[i].setY(keyAxis->coordToPixel(data.at(i).key));
-      }
+      scatters->clear();
+      return;
     }
+    getSampledScatterData(&data, begin, end);
   } else
   {
-    for (int i=0; i<data.size(); ++i)
+    QCPGraphDataContainer::const_iterator begin, end;
+    getVisibleDataBounds(begin, end, dataRange);
+    if (begin == end)
     {
-      if (!qIsNaN(data.at(i).value))
-      {
-        (*scatters)[i].setX(keyAxis->coordToPixel(data.at(i).key));
-        (*scatters)[i].setY(valueAxis->coordToPixel(data.at(i).value));
-      }
+      scatters->clear();
+      return;
     }
+    getOptimizedScatterData(&data, begin, end);
+  }
+  
+  if (mKeyAxis->rangeReversed() != (mKeyAxis->orientation() == Qt::Vertical)) // make sure key pixels are sorted ascending in data (significantly simplifies following processing)
+    std::reverse(data.begin(), data.end());
+  
+  scatters->resize(data.size());
+  if (data.isEmpty())
+    return;
+  const int stride = int(sizeof(QCPGraphData)/sizeof(double));
+  keyAxis->coordsToPixels(&data.constData()->key, stride, scatters->data(), int(data.size()));
+  valueAxis->coordsToPixels(&data.constData()->value, stride, scatters->data(), int(data.size()));
+  for (int i=0; i<data.size(); ++i)
+  {
+    if (qIsNaN(data.at(i).value))
+      (*scatters)[i] = QPointF();
   }
 }
 
@@ -21349,23 +25198,13 @@ QVector<QPointF> QCPGraph::dataToLines(const QVector<QCPGraphData> &data) const
   if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return result; }
 
   result.resize(data.size());
+  if (data.isEmpty())
+    return result;
   
-  // transform data points to pixels:
-  if (keyAxis->orientation() == Qt::Vertical)
-  {
-    for (int i=0; i<data.size(); ++i)
-    {
-      result[i].setX(valueAxis->coordToPixel(data.at(i).value));
-      result[i].setY(keyAxis->coordToPixel(data.at(i).key));
-    }
-  } else // key axis is horizontal
-  {
-    for (int i=0; i<data.size(); ++i)
-    {
-      result[i].setX(keyAxis->coordToPixel(data.at(i).key));
-      result[i].setY(valueAxis->coordToPixel(data.at(i).value));
-    }
-  }
+  // transform data points to pixels (each axis writes the pixel coordinate of its orientation):
+  const int stride = int(sizeof(QCPGraphData)/sizeof(double));
+  keyAxis->coordsToPixels(&data.constData()->key, stride, result.data(), int(data.size()));
+  valueAxis->coordsToPixels(&data.constData()->value, stride, result.data(), int(data.size()));
   return result;
 }
 
@@ -21613,7 +25452,11 @@ void QCPGraph::drawFill(QCPPainter *painter, QVector<QPointF> *lines) const
   {
     // draw base fill under graph, fill goes all the way to the zero-value-line:
     foreach (QCPDataRange segment, segments)
-      painter->drawPolygon(getFillPolygon(lines, segment));
+    {
+      const QPolygonF fillPolygon = getFillPolygon(lines, segment);
+      if (!QCPRasterizer::drawPolygon(painter, fillPolygon))
+        painter->drawPolygon(fillPolygon);
+    }
   } else
   {
     // draw fill between this graph and mChannelFillGraph:
@@ -21624,7 +25467,11 @@ void QCPGraph::drawFill(QCPPainter *painter, QVector<QPointF> *lines) const
       QVector<QCPDataRange> otherSegments = getNonNanSegments(&otherLines, mChannelFillGraph->keyAxis()->orientation());
       QVector<QPair<QCPDataRange, QCPDataRange> > segmentPairs = getOverlappingSegments(segments, lines, otherSegments, &otherLines);
       for (int i=0; i<segmentPairs.size(); ++i)
-        painter->drawPolygon(getChannelFillPolygon(lines, segmentPairs.at(i).first, &otherLines, segmentPairs.at(i).second));
+      {
+        const QPolygonF fillPolygon = getChannelFillPolygon(lines, segmentPairs.at(i).first, &otherLines, segmentPairs.at(i).second);
+        if (!QCPRasterizer::drawPolygon(painter, fillPolygon))
+          painter->drawPolygon(fillPolygon);
+      }
     }
   }
 }
@@ -21640,8 +25487,13 @@ void QCPGraph::drawScatterPlot(QCPPainter *painter, const QVector<QPointF> &scat
 {
   applyScattersAntialiasingHint(painter);
   style.applyTo(painter, mPen);
-  foreach (const QPointF &scatter, scatters)
-    style.drawShape(painter, scatter.x(), scatter.y());
+  if (mParentPlot->plottingHints().testFlag(QCP::phCacheScatters))
+    style.drawShapes(painter, scatters);
+  else
+  {
+    foreach (const QPointF &scatter, scatters)
+      style.drawShape(painter, scatter.x(), scatter.y());
+  }
 }
 
 /*!  \internal
@@ -21710,7 +25562,10 @@ void QCPGraph::getOptimizedLineData(QVector<QCPGraphData> *lineData, const QCPGr
       maxCount = int(2*keyPixelSpan+2);
   }
   
-  if (mAdaptiveSampling && dataCount >= maxCount) // use adaptive sampling only if there are at least two points per pixel on average
+  if (mAdaptiveSampling && mDataContainer->valueIndexEnabled() && dataCount >= 32*maxCount) // many points per pixel, sample pixel by pixel with the min/max index of the data container
+  {
+    getPixelSampledLineData(lineData, int(begin-mDataContainer->constBegin()), int(end-mDataContainer->constBegin()));
+  } else if (mAdaptiveSampling && dataCount >= maxCount) // use adaptive sampling only if there are at least two points per pixel on average
   {
     QCPGraphDataContainer::const_iterator it = begin;
     double minValue = it->value;
@@ -21773,6 +25628,136 @@ void QCPGraph::getOptimizedLineData(QVector<QCPGraphData> *lineData, const QCPGr
   }
 }
 
+/*! \internal
+  
+  Called via a queued connection when producers pushed data into the data queue. Requests a queued
+  replot, which merges the pending data (see \ref mergeDataQueue).
+*/
+void QCPGraph::dataQueueFilled()
+{
+  if (mParentPlot)
+    mParentPlot->replot(QCustomPlot::rpQueuedReplot);
+}
+
+/*! \internal
+
+  Returns the data point with the specified \a index from the data storage that is currently
+  displayed, i.e. the data columns if they are set (see \ref setDataColumns), or the data container
+  otherwise. \a index must be valid.
+
+  This allows the sampling and hit-testing code to be shared by both storage types.
+*/
+QCPGraphData QCPGraph::dataAt(int index) const
+{
+  if (mDataColumns)
+    return mDataColumns->at(index);
+  return *(mDataContainer->constBegin()+index);
+}
+
+/*! \internal
+
+  Variant of the adaptive sampling in \ref getOptimizedLineData for data with many points per
+  pixel. It produces the same clusters, but instead of visiting every data point, it jumps to the
+  end of each pixel column with a binary search and obtains the value span of the column from the
+  displayed data storage. For the data container, this uses the min/max index (see \ref
+  QCPDataContainer::setValueIndexEnabled), a pyramid of min/max summaries over blocks of data
+  points, so each column is covered by the coarsest levels that fit into it. For data columns (see
+  \ref setDataColumns), it is a contiguous scan of the value column.
+
+  The effort thus depends on the number of pixels instead of the number of data points, which keeps
+  zooming and panning fluent even for very large data sets. The considered data is restricted to
+  the indices from \a begin to \a end.
+*/
+void QCPGraph::getPixelSampledLineData(QVector<QCPGraphData> *lineData, int begin, int end) const
+{
+  QCPAxis *keyAxis = mKeyAxis.data();
+  int reversedFactor = keyAxis->pixelOrientation(); // is used to calculate keyEpsilon pixel into the correct direction
+  int reversedRound = reversedFactor==-1 ? 1 : 0; // is used to switch between floor (normal) and ceil (reversed) rounding of intervalStartKey
+  double intervalStartKey = keyAxis->pixelToCoord(int(keyAxis->coordToPixel(dataAt(begin).key)+reversedRound));
+  double lastIntervalEndKey = intervalStartKey;
+  double keyEpsilon = qAbs(intervalStartKey-keyAxis->pixelToCoord(keyAxis->coordToPixel(intervalStartKey)+1.0*reversedFactor)); // interval of one pixel on screen when mapped to plot key coordinates
+  bool keyEpsilonVariable = keyAxis->scaleType() == QCPAxis::stLogarithmic; // indicates whether keyEpsilon needs to be updated after every interval (for log axes)
+  
+  const QCPGraphDataContainer::const_iterator containerBegin = mDataContainer->constBegin();
+  int i = begin;
+  while (i < end)
+  {
+    const QCPGraphData first = dataAt(i);
+    int intervalEnd;
+    bool foundRange = false;
+    QCPRange valueSpan;
+    if (mDataColumns)
+    {
+      const double *keys = mDataColumns->keys();
+      intervalEnd = int(std::lower_bound(keys+i+1, keys+end, intervalStartKey+keyEpsilon)-keys);
+      if (intervalEnd-i >= 2)
+        valueSpan = mDataColumns->valueRange(foundRange, i, intervalEnd);
+    } else
+    {
+      intervalEnd = int(std::lower_bound(containerBegin+i+1, containerBegin+end, QCPGraphData::fromSortKey(intervalStartKey+keyEpsilon), qcpLessThanSortKey<QCPGraphData>)-containerBegin);
+      if (intervalEnd-i >= 2)
+        valueSpan = mDataContainer->valueRange(foundRange, containerBegin+i, containerBegin+intervalEnd);
+    }
+    if (intervalEnd-i >= 2) // pixel has multiple data points, consolidate them to a cluster
+    {
+      if (!foundRange)
+        valueSpan = QCPRange(first.value, first.value);
+      if (lastIntervalEndKey < intervalStartKey-keyEpsilon) // last point is further away, so first point of this cluster must be at a real data point
+        lineData->append(QCPGraphData(intervalStartKey+keyEpsilon*0.2, first.value));
+      lineData->append(QCPGraphData(intervalStartKey+keyEpsilon*0.25, valueSpan.lower));
+      lineData->append(QCPGraphData(intervalStartKey+keyEpsilon*0.75, valueSpan.upper));
+      if (intervalEnd < end && dataAt(intervalEnd).key > intervalStartKey+keyEpsilon*2) // next pixel starts further away from this cluster, so make sure the last point of the cluster is at a real data point
+        lineData->append(QCPGraphData(intervalStartKey+keyEpsilon*0.8, dataAt(intervalEnd-1).value));
+    } else
+      lineData->append(first);
+    lastIntervalEndKey = dataAt(intervalEnd-1).key;
+    i = intervalEnd;
+    if (i < end)
+    {
+      intervalStartKey = keyAxis->pixelToCoord(int(keyAxis->coordToPixel(dataAt(i).key)+reversedRound));
+      if (keyEpsilonVariable)
+        keyEpsilon = qAbs(intervalStartKey-keyAxis->pixelToCoord(keyAxis->coordToPixel(intervalStartKey)+1.0*reversedFactor));
+    }
+  }
+}
+
+/*! \internal
+
+  Column based counterpart of \ref getOptimizedLineData, used while the graph displays data
+  columns (see \ref setDataColumns). Returns via \a lineData the data points with indices from \a
+  begin to \a end that need to be visualized.
+
+  If adaptive sampling is enabled and there are at least two points per pixel on average, the
+  points are consolidated to clusters with \ref getPixelSampledLineData.
+*/
+void QCPGraph::getColumnLineData(QVector<QCPGraphData> *lineData, int begin, int end) const
+{
+  if (!lineData) return;
+  QCPAxis *keyAxis = mKeyAxis.data();
+  QCPAxis *valueAxis = mValueAxis.data();
+  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return; }
+  if (begin >= end) return;
+  
+  int dataCount = end-begin;
+  int maxCount = (std::numeric_limits<int>::max)();
+  if (mAdaptiveSampling)
+  {
+    double keyPixelSpan = qAbs(keyAxis->coordToPixel(mDataColumns->key(begin))-keyAxis->coordToPixel(mDataColumns->key(end-1)));
+    if (2*keyPixelSpan+2 < static_cast<double>((std::numeric_limits<int>::max)()))
+      maxCount = int(2*keyPixelSpan+2);
+  }
+  
+  if (mAdaptiveSampling && dataCount >= maxCount) // use adaptive sampling only if there are at least two points per pixel on average
+  {
+    getPixelSampledLineData(lineData, begin, end);
+  } else // don't use adaptive sampling algorithm, transfer points one-to-one from the columns into the output
+  {
+    lineData->resize(dataCount);
+    for (int i=0; i<dataCount; ++i)
+      (*lineData)[i] = mDataColumns->at(begin+i);
+  }
+}
+
 /*! \internal
 
   Returns via \a scatterData the data points that need to be visualized for this graph when
@@ -21786,6 +25771,17 @@ void QCPGraph::getOptimizedLineData(QVector<QCPGraphData> *lineData, const QCPGr
   \see getOptimizedLineData
 */
 void QCPGraph::getOptimizedScatterData(QVector<QCPGraphData> *scatterData, QCPGraphDataContainer::const_iterator begin, QCPGraphDataContainer::const_iterator end) const
+{
+  getSampledScatterData(scatterData, int(begin-mDataContainer->constBegin()), int(end-mDataContainer->constBegin()));
+}
+
+/*! \internal
+
+  Implements \ref getOptimizedScatterData on the data indices from \a begin to \a end of the
+  displayed data storage (see \ref dataAt), so it serves both the data container and data columns
+  (see \ref setDataColumns).
+*/
+void QCPGraph::getSampledScatterData(QVector<QCPGraphData> *scatterData, int begin, int end) const
 {
   if (!scatterData) return;
   QCPAxis *keyAxis = mKeyAxis.data();
@@ -21793,20 +25789,14 @@ void QCPGraph::getOptimizedScatterData(QVector<QCPGraphData> *scatterData, QCPGr
   if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return; }
   
   const int scatterModulo = mScatterSkip+1;
-  const bool doScatterSkip = mScatterSkip > 0;
-  int beginIndex = int(begin-mDataContainer->constBegin());
-  int endIndex = int(end-mDataContainer->constBegin());
-  while (doScatterSkip && begin != end && beginIndex % scatterModulo != 0) // advance begin iterator to first non-skipped scatter
-  {
-    ++beginIndex;
-    ++begin;
-  }
-  if (begin == end) return;
-  int dataCount = int(end-begin);
+  if (begin % scatterModulo != 0) // advance begin to first non-skipped scatter
+    begin = qMin(begin+scatterModulo-begin % scatterModulo, end);
+  if (begin >= end) return;
+  int dataCount = end-begin;
   int maxCount = (std::numeric_limits<int>::max)();
   if (mAdaptiveSampling)
   {
-    int keyPixelSpan = int(qAbs(keyAxis->coordToPixel(begin->key)-keyAxis->coordToPixel((end-1)->key)));
+    int keyPixelSpan = int(qAbs(keyAxis->coordToPixel(dataAt(begin).key)-keyAxis->coordToPixel(dataAt(end-1).key)));
     maxCount = 2*keyPixelSpan+2;
   }
   
@@ -21814,146 +25804,79 @@ void QCPGraph::getOptimizedScatterData(QVector<QCPGraphData> *scatterData, QCPGr
   {
     double valueMaxRange = valueAxis->range().upper;
     double valueMinRange = valueAxis->range().lower;
-    QCPGraphDataContainer::const_iterator it = begin;
-    int itIndex = int(beginIndex);
-    double minValue = it->value;
-    double maxValue = it->value;
-    QCPGraphDataContainer::const_iterator minValueIt = it;
-    QCPGraphDataContainer::const_iterator maxValueIt = it;
-    QCPGraphDataContainer::const_iterator currentIntervalStart = it;
+    QCPGraphData current = dataAt(begin);
+    double minValue = current.value;
+    double maxValue = current.value;
+    int minValueIndex = begin;
+    int maxValueIndex = begin;
+    int currentIntervalStart = begin;
     int reversedFactor = keyAxis->pixelOrientation(); // is used to calculate keyEpsilon pixel into the correct direction
     int reversedRound = reversedFactor==-1 ? 1 : 0; // is used to switch between floor (normal) and ceil (reversed) rounding of currentIntervalStartKey
-    double currentIntervalStartKey = keyAxis->pixelToCoord(int(keyAxis->coordToPixel(begin->key)+reversedRound));
+    double currentIntervalStartKey = keyAxis->pixelToCoord(int(keyAxis->coordToPixel(current.key)+reversedRound));
     double keyEpsilon = qAbs(currentIntervalStartKey-keyAxis->pixelToCoord(keyAxis->coordToPixel(currentIntervalStartKey)+1.0*reversedFactor)); // interval of one pixel on screen when mapped to plot key coordinates
     bool keyEpsilonVariable = keyAxis->scaleType() == QCPAxis::stLogarithmic; // indicates whether keyEpsilon needs to be updated after every interval (for log axes)
     int intervalDataCount = 1;
-    // advance iterator to second (non-skipped) data point because adaptive sampling works in 1 point retrospect:
-    if (!doScatterSkip)
-      ++it;
-    else
-    {
-      itIndex += scatterModulo;
-      if (itIndex < endIndex) // make sure we didn't jump over end
-        it += scatterModulo;
-      else
-      {
-        it = end;
-        itIndex = endIndex;
-      }
-    }
-    // main loop over data points:
-    while (it != end)
-    {
-      if (it->key < currentIntervalStartKey+keyEpsilon) // data point is still within same pixel, so skip it and expand value span of this pixel if necessary
+    // advance to second (non-skipped) data point because adaptive sampling works in 1 point retrospect:
+    int i = qMin(begin+scatterModulo, end);
+    // main loop over data points, plus one pass at end to handle the last interval:
+    while (true)
+    {
+      if (i < end)
+        current = dataAt(i);
+      if (i < end && current.key < currentIntervalStartKey+keyEpsilon) // data point is still within same pixel, so skip it and expand value span of this pixel if necessary
       {
-        if (it->value < minValue && it->value > valueMinRange && it->value < valueMaxRange)
+        if (current.value < minValue && current.value > valueMinRange && current.value < valueMaxRange)
         {
-          minValue = it->value;
-          minValueIt = it;
-        } else if (it->value > maxValue && it->value > valueMinRange && it->value < valueMaxRange)
+          minValue = current.value;
+          minValueIndex = i;
+        } else if (current.value > maxValue && current.value > valueMinRange && current.value < valueMaxRange)
         {
-          maxValue = it->value;
-          maxValueIt = it;
+          maxValue = current.value;
+          maxValueIndex = i;
         }
         ++intervalDataCount;
-      } else // new pixel started
+      } else // new pixel started, or end reached
       {
         if (intervalDataCount >= 2) // last pixel had multiple data points, consolidate them
         {
           // determine value pixel span and add as many points in interval to maintain certain vertical data density (this is specific to scatter plot):
           double valuePixelSpan = qAbs(valueAxis->coordToPixel(minValue)-valueAxis->coordToPixel(maxValue));
           int dataModulo = qMax(1, qRound(intervalDataCount/(valuePixelSpan/4.0))); // approximately every 4 value pixels one data point on average
-          QCPGraphDataContainer::const_iterator intervalIt = currentIntervalStart;
           int c = 0;
-          while (intervalIt != it)
+          for (int intervalIndex=currentIntervalStart; intervalIndex<i; intervalIndex+=scatterModulo)
           {
-            if ((c % dataModulo == 0 || intervalIt == minValueIt || intervalIt == maxValueIt) && intervalIt->value > valueMinRange && intervalIt->value < valueMaxRange)
-              scatterData->append(*intervalIt);
+            const QCPGraphData intervalData = dataAt(intervalIndex);
+            if ((c % dataModulo == 0 || intervalIndex == minValueIndex || intervalIndex == maxValueIndex) && intervalData.value > valueMinRange && intervalData.value < valueMaxRange)
+              scatterData->append(intervalData);
             ++c;
-            if (!doScatterSkip)
-              ++intervalIt;
-            else
-              intervalIt += scatterModulo; // since we know indices of "currentIntervalStart", "intervalIt" and "it" are multiples of scatterModulo, we can't accidentally jump over "it" here
           }
-        } else if (currentIntervalStart->value > valueMinRange && currentIntervalStart->value < valueMaxRange)
-          scatterData->append(*currentIntervalStart);
-        minValue = it->value;
-        maxValue = it->value;
-        currentIntervalStart = it;
-        currentIntervalStartKey = keyAxis->pixelToCoord(int(keyAxis->coordToPixel(it->key)+reversedRound));
+        } else
+        {
+          const QCPGraphData intervalData = dataAt(currentIntervalStart);
+          if (intervalData.value > valueMinRange && intervalData.value < valueMaxRange)
+            scatterData->append(intervalData);
+        }
+        if (i >= end)
+          break;
+        minValue = current.value;
+        maxValue = current.value;
+        minValueIndex = i;
+        maxValueIndex = i;
+        currentIntervalStart = i;
+        currentIntervalStartKey = keyAxis->pixelToCoord(int(keyAxis->coordToPixel(current.key)+reversedRound));
         if (keyEpsilonVariable)
           keyEpsilon = qAbs(currentIntervalStartKey-keyAxis->pixelToCoord(keyAxis->coordToPixel(currentIntervalStartKey)+1.0*reversedFactor));
         intervalDataCount = 1;
       }
       // advance to next data point:
-      if (!doScatterSkip)
-        ++it;
-      else
-      {
-        itIndex += scatterModulo;
-        if (itIndex < endIndex) // make sure we didn't jump over end
-          it += scatterModulo;
-        else
-        {
-          it = end;
-          itIndex = endIndex;
-        }
-      }
+      i = qMin(i+scatterModulo, end);
     }
-    // handle last interval:
-    if (intervalDataCount >= 2) // last pixel had multiple data points, consolidate them
-    {
-      // determine value pixel span and add as many points in interval to maintain certain vertical data density (this is specific to scatter plot):
-      double valuePixelSpan = qAbs(valueAxis->coordToPixel(minValue)-valueAxis->coordToPixel(maxValue));
-      int dataModulo = qMax(1, qRound(intervalDataCount/(valuePixelSpan/4.0))); // approximately every 4 value pixels one data point on average
-      QCPGraphDataContainer::const_iterator intervalIt = currentIntervalStart;
-      int intervalItIndex = int(intervalIt-mDataContainer->constBegin());
-      int c = 0;
-      while (intervalIt != it)
-      {
-        if ((c % dataModulo == 0 || intervalIt == minValueIt || intervalIt == maxValueIt) && intervalIt->value > valueMinRange && intervalIt->value < valueMaxRange)
-          scatterData->append(*intervalIt);
-        ++c;
-        if (!doScatterSkip)
-          ++intervalIt;
-        else // here we can't guarantee that adding scatterModulo doesn't exceed "it" (because "it" is equal to "end" here, and "end" isn't scatterModulo-aligned), so check via index comparison:
-        {
-          intervalItIndex += scatterModulo;
-          if (intervalItIndex < itIndex)
-            intervalIt += scatterModulo;
-          else
-          {
-            intervalIt = it;
-            intervalItIndex = itIndex;
-          }
-        }
-      }
-    } else if (currentIntervalStart->value > valueMinRange && currentIntervalStart->value < valueMaxRange)
-      scatterData->append(*currentIntervalStart);
     
-  } else // don't use adaptive sampling algorithm, transfer points one-to-one from the data container into the output
+  } else // don't use adaptive sampling algorithm, transfer points one-to-one from the data storage into the output
   {
-    QCPGraphDataContainer::const_iterator it = begin;
-    int itIndex = beginIndex;
-    scatterData->reserve(dataCount);
-    while (it != end)
-    {
-      scatterData->append(*it);
-      // advance to next data point:
-      if (!doScatterSkip)
-        ++it;
-      else
-      {
-        itIndex += scatterModulo;
-        if (itIndex < endIndex)
-          it += scatterModulo;
-        else
-        {
-          it = end;
-          itIndex = endIndex;
-        }
-      }
-    }
+    scatterData->reserve(dataCount/scatterModulo+1);
+    for (int i=begin; i<end; i+=scatterModulo)
+      scatterData->append(dataAt(i));
   }
 }
 
@@ -21985,6 +25908,27 @@ void QCPGraph::getVisibleDataBounds(QCPGraphDataContainer::const_iterator &begin
   }
 }
 
+/*! \internal
+
+  Column based counterpart of \ref getVisibleDataBounds, used while the graph displays data
+  columns (see \ref setDataColumns). Returns the visible index range in \a begin and \a end,
+  restricted to \a rangeRestriction.
+*/
+void QCPGraph::getVisibleColumnBounds(int &begin, int &end, const QCPDataRange &rangeRestriction) const
+{
+  begin = 0;
+  end = 0;
+  if (rangeRestriction.isEmpty())
+    return;
+  QCPAxis *keyAxis = mKeyAxis.data();
+  if (!keyAxis) { qDebug() << Q_FUNC_INFO << "invalid key axis"; return; }
+  // get visible data range and limit it to rangeRestriction:
+  QCPDataRange visibleRange(mDataColumns->findBegin(keyAxis->range().lower), mDataColumns->findEnd(keyAxis->range().upper));
+  visibleRange = visibleRange.bounded(rangeRestriction.bounded(QCPDataRange(0, mDataColumns->size())));
+  begin = visibleRange.begin();
+  end = visibleRange.end();
+}
+
 /*!  \internal
   
   This method goes through the passed points in \a lineData and returns a list of the segments
@@ -22418,16 +26362,33 @@ int QCPGraph::findIndexAboveY(const QVector<QPointF> *data, double y) const
   
   If either the graph has no data or if the line style is \ref lsNone and the scatter style's shape
   is \ref QCPScatterStyle::ssNone (i.e. there is no visual representation of the graph), returns -1.0.
+
+  While the graph displays data columns (see \ref setDataColumns), \a closestData is always the end
+  iterator of the data container, use the index based overload instead.
 */
 double QCPGraph::pointDistance(const QPointF &pixelPoint, QCPGraphDataContainer::const_iterator &closestData) const
 {
-  closestData = mDataContainer->constEnd();
-  if (mDataContainer->isEmpty())
+  int closestIndex;
+  const double result = pointDistance(pixelPoint, closestIndex);
+  closestData = mDataColumns ? mDataContainer->constEnd() : mDataContainer->constBegin()+closestIndex;
+  return result;
+}
+
+/*! \internal \overload
+
+  Index based variant of \ref pointDistance which works on the displayed data storage, i.e. the
+  data container or the data columns (see \ref setDataColumns). The index of the closest data point
+  is returned in \a closestIndex, or \ref dataCount if no data point is near \a pixelPoint.
+*/
+double QCPGraph::pointDistance(const QPointF &pixelPoint, int &closestIndex) const
+{
+  closestIndex = dataCount();
+  if (closestIndex == 0)
     return -1.0;
   if (mLineStyle == lsNone && mScatterStyle.isNone())
     return -1.0;
   
-  // calculate minimum distances to graph data points and find closestData iterator:
+  // calculate minimum distances to graph data points and find closestIndex:
   double minDistSqr = (std::numeric_limits<double>::max)();
   // determine which key range comes into question, taking selection tolerance around pos into account:
   double posKeyMin, posKeyMax, dummy;
@@ -22436,37 +26397,58 @@ double QCPGraph::pointDistance(const QPointF &pixelPoint, QCPGraphDataContainer:
   if (posKeyMin > posKeyMax)
     qSwap(posKeyMin, posKeyMax);
   // iterate over found data points and then choose the one with the shortest distance to pos:
-  QCPGraphDataContainer::const_iterator begin = mDataContainer->findBegin(posKeyMin, true);
-  QCPGraphDataContainer::const_iterator end = mDataContainer->findEnd(posKeyMax, true);
-  for (QCPGraphDataContainer::const_iterator it=begin; it!=end; ++it)
+  const int begin = findBegin(posKeyMin, true);
+  const int end = findEnd(posKeyMax, true);
+  for (int i=begin; i<end; ++i)
   {
-    const double currentDistSqr = QCPVector2D(coordsToPixels(it->key, it->value)-pixelPoint).lengthSquared();
+    const QCPGraphData current = dataAt(i);
+    const double currentDistSqr = QCPVector2D(coordsToPixels(current.key, current.value)-pixelPoint).lengthSquared();
     if (currentDistSqr < minDistSqr)
     {
       minDistSqr = currentDistSqr;
-      closestData = it;
+      closestIndex = i;
     }
   }
-    
+  
   // calculate distance to graph line if there is one (if so, will probably be smaller than distance to closest data point):
   if (mLineStyle != lsNone)
   {
-    // line displayed, calculate distance to line segments:
-    QVector<QPointF> lineData;
-    getLines(&lineData, QCPDataRange(0, dataCount())); // don't limit data range further since with sharp data spikes, line segments may be closer to test point than segments with closer key coordinate
-    QCPVector2D p(pixelPoint);
-    const int step = mLineStyle==lsImpulse ? 2 : 1; // impulse plot differs from other line styles in that the lineData points are only pairwise connected
-    for (int i=0; i<lineData.size()-1; i+=step)
-    {
-      const double currentDistSqr = p.distanceSquaredToLine(lineData.at(i), lineData.at(i+1));
-      if (currentDistSqr < minDistSqr)
-        minDistSqr = currentDistSqr;
-    }
+    const double lineDistSqr = lineDistanceSquared(pixelPoint);
+    if (lineDistSqr >= 0 && lineDistSqr < minDistSqr)
+      minDistSqr = lineDistSqr;
   }
   
   return qSqrt(minDistSqr);
 }
 
+/*! \internal
+  
+  Returns the squared distance in pixels of \a pixelPoint to the closest line segment of the graph,
+  or -1 if no line segment is displayed. Used by \ref pointDistance.
+  
+  The line segments are the full output of \ref getLines (the data range isn't limited further,
+  since with sharp data spikes, line segments may be closer to the test point than segments with
+  closer key coordinate). To avoid regenerating and scanning them on every mouse move, they are kept
+  in a \ref QCPSegmentIndex, which is rebuilt only when the data, the axis ranges, the axis rect
+  geometry or the line style changed since the last hit-test.
+*/
+double QCPGraph::lineDistanceSquared(const QPointF &pixelPoint) const
+{
+  QVector<double> signature = hitTestSignature();
+  signature << mLineStyle << mAdaptiveSampling << quintptr(mDataContainer.data()) << quintptr(mDataColumns.data());
+  if (!mLineIndex.isValid(signature))
+  {
+    QVector<QPointF> lineData;
+    getLines(&lineData, QCPDataRange(0, dataCount()));
+    // impulse plot differs from other line styles in that the lineData points are only pairwise connected:
+    const QCPSegmentIndex::SegmentMode mode = mLineStyle == lsImpulse ? QCPSegmentIndex::smPairs : QCPSegmentIndex::smPolyline;
+    const QRectF axisRect = mKeyAxis->axisRect()->rect();
+    mLineIndex.build(lineData, mode, signature, axisRect.adjusted(-axisRect.width(), -axisRect.height(), axisRect.width(), axisRect.height()));
+  }
+  const double distance = mLineIndex.nearest(pixelPoint);
+  return distance < 0 ? -1 : distance*distance;
+}
+
 /*! \internal
   
   Finds the highest index of \a data, whose points y value is just below \a y. Assumes y values in
@@ -22686,6 +26668,7 @@ QCPCurve::~QCPCurve()
 void QCPCurve::setData(QSharedPointer<QCPCurveDataContainer> data)
 {
   mDataContainer = data;
+  markDirty();
 }
 
 /*! \overload
@@ -22909,6 +26892,8 @@ void QCPCurve::draw(QCPPainter *painter)
   
   // allocate line vector:
   QVector<QPointF> lines, scatters;
+  QCPReplotProfiler *profiler = mParentPlot->profiler();
+  QElapsedTimer dataTimer; // measures the data extraction for the profiler
   
   // loop over and draw segments of unselected/selected data:
   QList<QCPDataRange> selectedSegments, unselectedSegments, allSegments;
@@ -22924,7 +26909,11 @@ void QCPCurve::draw(QCPPainter *painter)
       finalCurvePen = mSelectionDecorator->pen();
     
     QCPDataRange lineDataRange = isSelectedSegment ? allSegments.at(i) : allSegments.at(i).adjusted(-1, 1); // unselected segments extend lines to bordering selected data point (safe to exceed total data bounds in first/last segment, getCurveLines takes care)
+    if (profiler)
+      dataTimer.start();
     getCurveLines(&lines, lineDataRange, finalCurvePen.widthF());
+    if (profiler)
+      profiler->addDataTime(this, dataTimer.nsecsElapsed()*1e-6);
     
     // check data validity if flag set:
   #ifdef QCUSTOMPLOT_CHECK_DATA
@@ -22944,7 +26933,11 @@ void QCPCurve::draw(QCPPainter *painter)
       painter->setBrush(mBrush);
     painter->setPen(Qt::NoPen);
     if (painter->brush().style() != Qt::NoBrush && painter->brush().color().alpha() != 0)
-      painter->drawPolygon(QPolygonF(lines));
+    {
+      const QPolygonF fillPolygon(lines);
+      if (!QCPRasterizer::drawPolygon(painter, fillPolygon))
+        painter->drawPolygon(fillPolygon);
+    }
     
     // draw curve line:
     if (mLineStyle != lsNone)
@@ -22960,7 +26953,11 @@ void QCPCurve::draw(QCPPainter *painter)
       finalScatterStyle = mSelectionDecorator->getFinalScatterStyle(mScatterStyle);
     if (!finalScatterStyle.isNone())
     {
+      if (profiler)
+        dataTimer.start();
       getScatters(&scatters, allSegments.at(i), finalScatterStyle.size());
+      if (profiler)
+        profiler->addDataTime(this, dataTimer.nsecsElapsed()*1e-6);
       drawScatterPlot(painter, scatters, finalScatterStyle);
     }
   }
@@ -23032,9 +27029,14 @@ void QCPCurve::drawScatterPlot(QCPPainter *painter, const QVector<QPointF> &poin
   // draw scatter point symbols:
   applyScattersAntialiasingHint(painter);
   style.applyTo(painter, mPen);
-  foreach (const QPointF &point, points)
-    if (!qIsNaN(point.x()) && !qIsNaN(point.y()))
-      style.drawShape(painter,  point);
+  if (mParentPlot->plottingHints().testFlag(QCP::phCacheScatters))
+    style.drawShapes(painter, points);
+  else
+  {
+    foreach (const QPointF &point, points)
+      if (!qIsNaN(point.x()) && !qIsNaN(point.y()))
+        style.drawShape(painter,  point);
+  }
 }
 
 /*! \internal
@@ -23135,7 +27137,17 @@ void QCPCurve::getCurveLines(QVector<QPointF> *lines, const QCPDataRange &dataRa
     {
       if (currentRegion == 5) // still in R, keep adding original points
       {
-        lines->append(coordsToPixels(it->key, it->value));
+        // transform the whole run of consecutive points inside R at once:
+        QCPCurveDataContainer::const_iterator runEnd = it+1;
+        while (runEnd != itEnd && getRegion(runEnd->key, runEnd->value, keyMin, valueMax, keyMax, valueMin) == 5)
+          ++runEnd;
+        const int runLength = int(runEnd-it);
+        const int oldSize = int(lines->size());
+        const int stride = int(sizeof(QCPCurveData)/sizeof(double));
+        lines->resize(oldSize+runLength);
+        keyAxis->coordsToPixels(&it->key, stride, lines->data()+oldSize, runLength);
+        valueAxis->coordsToPixels(&it->value, stride, lines->data()+oldSize, runLength);
+        it = runEnd-1; // last point of the run becomes prevIt below
       } else // still outside R, no need to add anything
       {
         // see how this is not doing anything? That's the main optimization...
@@ -23917,32 +27929,43 @@ double QCPCurve::pointDistance(const QPointF &pixelPoint, QCPCurveDataContainer:
     return QCPVector2D(dataPoint-pixelPoint).length();
   }
   
-  // calculate minimum distances to curve data points and find closestData iterator:
-  double minDistSqr = (std::numeric_limits<double>::max)();
-  // iterate over found data points and then choose the one with the shortest distance to pos:
-  QCPCurveDataContainer::const_iterator begin = mDataContainer->constBegin();
-  QCPCurveDataContainer::const_iterator end = mDataContainer->constEnd();
-  for (QCPCurveDataContainer::const_iterator it=begin; it!=end; ++it)
+  // the data points and line segments in pixel coordinates are kept in segment indices, which are
+  // rebuilt only when the data, the axis ranges or the axis rect geometry changed:
+  QVector<double> signature = hitTestSignature();
+  signature << quintptr(mDataContainer.data());
+  const QRectF axisRect = mKeyAxis->axisRect()->rect();
+  const QRectF focusRect = axisRect.adjusted(-axisRect.width(), -axisRect.height(), axisRect.width(), axisRect.height());
+  
+  // find the data point with the shortest distance to pos and the closestData iterator:
+  if (!mPointIndex.isValid(signature))
   {
-    const double currentDistSqr = QCPVector2D(coordsToPixels(it->key, it->value)-pixelPoint).lengthSquared();
-    if (currentDistSqr < minDistSqr)
-    {
-      minDistSqr = currentDistSqr;
-      closestData = it;
-    }
+    QVector<QPointF> points;
+    points.reserve(mDataContainer->size());
+    for (QCPCurveDataContainer::const_iterator it=mDataContainer->constBegin(); it!=mDataContainer->constEnd(); ++it)
+      points.append(coordsToPixels(it->key, it->value));
+    mPointIndex.build(points, QCPSegmentIndex::smPoints, signature, focusRect);
   }
+  int closestIndex;
+  const double pointDist = mPointIndex.nearest(pixelPoint, &closestIndex);
+  if (closestIndex < 0)
+    return -1.0;
+  closestData = mDataContainer->constBegin()+closestIndex;
+  double minDistSqr = pointDist*pointDist;
   
   // calculate distance to line if there is one (if so, will probably be smaller than distance to closest data point):
   if (mLineStyle != lsNone)
   {
-    QVector<QPointF> lines;
-    getCurveLines(&lines, QCPDataRange(0, dataCount()), mParentPlot->selectionTolerance()*1.2); // optimized lines outside axis rect shouldn't respond to clicks at the edge, so use 1.2*tolerance as pen width
-    for (int i=0; i<lines.size()-1; ++i)
+    const double penWidth = mParentPlot->selectionTolerance()*1.2; // optimized lines outside axis rect shouldn't respond to clicks at the edge, so use 1.2*tolerance as pen width
+    signature << penWidth;
+    if (!mLineIndex.isValid(signature))
     {
-      double currentDistSqr = QCPVector2D(pixelPoint).distanceSquaredToLine(lines.at(i), lines.at(i+1));
-      if (currentDistSqr < minDistSqr)
-        minDistSqr = currentDistSqr;
+      QVector<QPointF> lines;
+      getCurveLines(&lines, QCPDataRange(0, dataCount()), penWidth);
+      mLineIndex.build(lines, QCPSegmentIndex::smPolyline, signature, focusRect);
     }
+    const double lineDist = mLineIndex.nearest(pixelPoint);
+    if (lineDist >= 0 && lineDist*lineDist < minDistSqr)
+      minDistSqr = lineDist*lineDist;
   }
   
   return qSqrt(minDistSqr);
@@ -24481,6 +28504,7 @@ QCPBars::~QCPBars()
 void QCPBars::setData(QSharedPointer<QCPBarsDataContainer> data)
 {
   mDataContainer = data;
+  markDirty();
 }
 
 /*! \overload
@@ -25357,6 +29381,7 @@ QCPStatisticalBox::QCPStatisticalBox(QCPAxis *keyAxis, QCPAxis *valueAxis) :
 void QCPStatisticalBox::setData(QSharedPointer<QCPStatisticalBoxDataContainer> data)
 {
   mDataContainer = data;
+  markDirty();
 }
 /*! \overload
   
@@ -25825,7 +29850,15 @@ QVector<QLineF> QCPStatisticalBox::getWhiskerBarLines(QCPStatisticalBoxDataConta
   given by \ref recalculateDataBounds, such that you can decide when it is sensible to find the
   true current minimum and maximum. The method QCPColorMap::rescaleDataRange offers a convenience
   parameter \a recalculateDataBounds which may be set to true to automatically call \ref
-  recalculateDataBounds internally.
+  recalculateDataBounds internally. The minimum and maximum are also buffered per row of cells
+  with the same value index, so \ref recalculateDataBounds only goes through the rows in which a
+  cell holding the row minimum or maximum was overwritten since the last call.
+  
+  For data that arrives row by row or column by column, as in waterfall diagrams and spectrograms,
+  the cells can be shifted with \ref scroll, \ref appendValueRow and \ref appendKeyColumn. The
+  color map keeps track of the cells that were modified or scrolled since it was last drawn, and
+  only colorizes these cells again, while the rest of its map image is scrolled along with the
+  data.
 */
 
 /* start of documentation of inline functions */
@@ -25853,7 +29886,8 @@ QCPColorMapData::QCPColorMapData(int keySize, int valueSize, const QCPRange &key
   mIsEmpty(true),
   mData(nullptr),
   mAlpha(nullptr),
-  mDataModified(true)
+  mDataModified(true),
+  mRevision(0)
 {
   setSize(keySize, valueSize);
   fill(0);
@@ -25874,7 +29908,8 @@ QCPColorMapData::QCPColorMapData(const QCPColorMapData &other) :
   mIsEmpty(true),
   mData(nullptr),
   mAlpha(nullptr),
-  mDataModified(true)
+  mDataModified(true),
+  mRevision(0)
 {
   *this = other;
 }
@@ -25902,7 +29937,9 @@ QCPColorMapData &QCPColorMapData::operator=(const QCPColorMapData &other)
         memcpy(mAlpha, other.mAlpha, sizeof(mAlpha[0])*size_t(keySize*valueSize));
     }
     mDataBounds = other.mDataBounds;
-    mDataModified = true;
+    mRowBounds = other.mRowBounds;
+    mRowBoundsStale = other.mRowBoundsStale;
+    markModified(QRect(0, 0, mKeySize, mValueSize));
   }
   return *this;
 }
@@ -25978,11 +30015,18 @@ void QCPColorMapData::setSize(int keySize, int valueSize)
         qDebug() << Q_FUNC_INFO << "out of memory for data dimensions "<< mKeySize << "*" << mValueSize;
     } else
       mData = nullptr;
+    if (!mData)
+    {
+      mRowBounds.clear();
+      mRowBoundsStale.clear();
+    }
     
     if (mAlpha) // if we had an alpha map, recreate it with new size
       createAlpha();
     
-    mDataModified = true;
+    mModifiedCells = QRect();
+    mScrolledCells = QPoint();
+    markModified(QRect(0, 0, mKeySize, mValueSize));
   }
 }
 
@@ -26079,14 +30123,7 @@ void QCPColorMapData::setData(double key, double value, double z)
   int keyCell = int( (key-mKeyRange.lower)/(mKeyRange.upper-mKeyRange.lower)*(mKeySize-1)+0.5 );
   int valueCell = int( (value-mValueRange.lower)/(mValueRange.upper-mValueRange.lower)*(mValueSize-1)+0.5 );
   if (keyCell >= 0 && keyCell < mKeySize && valueCell >= 0 && valueCell < mValueSize)
-  {
-    mData[valueCell*mKeySize + keyCell] = z;
-    if (z < mDataBounds.lower)
-      mDataBounds.lower = z;
-    if (z > mDataBounds.upper)
-      mDataBounds.upper = z;
-     mDataModified = true;
-  }
+    writeCell(keyCell, valueCell, z);
 }
 
 /*!
@@ -26103,14 +30140,8 @@ void QCPColorMapData::setData(double key, double value, double z)
 void QCPColorMapData::setCell(int keyIndex, int valueIndex, double z)
 {
   if (keyIndex >= 0 && keyIndex < mKeySize && valueIndex >= 0 && valueIndex < mValueSize)
-  {
-    mData[valueIndex*mKeySize + keyIndex] = z;
-    if (z < mDataBounds.lower)
-      mDataBounds.lower = z;
-    if (z > mDataBounds.upper)
-      mDataBounds.upper = z;
-     mDataModified = true;
-  } else
+    writeCell(keyIndex, valueIndex, z);
+  else
     qDebug() << Q_FUNC_INFO << "index out of bounds:" << keyIndex << valueIndex;
 }
 
@@ -26136,7 +30167,7 @@ void QCPColorMapData::setAlpha(int keyIndex, int valueIndex, unsigned char alpha
     if (mAlpha || createAlpha())
     {
       mAlpha[valueIndex*mKeySize + keyIndex] = alpha;
-      mDataModified = true;
+      markModified(QRect(keyIndex, valueIndex, 1, 1));
     }
   } else
     qDebug() << Q_FUNC_INFO << "index out of bounds:" << keyIndex << valueIndex;
@@ -26154,20 +30185,25 @@ void QCPColorMapData::setAlpha(int keyIndex, int valueIndex, unsigned char alpha
   Note that the method \ref QCPColorMap::rescaleDataRange provides a parameter \a
   recalculateDataBounds for convenience. Setting this to true will call this method for you, before
   doing the rescale.
+  
+  Only the rows whose buffered bounds may be too wide are gone through, the bounds of all other
+  rows are still exact (see the class description).
 */
 void QCPColorMapData::recalculateDataBounds()
 {
   if (mKeySize > 0 && mValueSize > 0)
   {
-    double minHeight = std::numeric_limits<double>::max();
-    double maxHeight = -std::numeric_limits<double>::max();
-    const int dataCount = mValueSize*mKeySize;
-    for (int i=0; i<dataCount; ++i)
+    double minHeight = (std::numeric_limits<double>::max)();
+    double maxHeight = -(std::numeric_limits<double>::max)();
+    for (int valueIndex=0; valueIndex<mRowBounds.size(); ++valueIndex)
     {
-      if (mData[i] > maxHeight)
-        maxHeight = mData[i];
-      if (mData[i] < minHeight)
-        minHeight = mData[i];
+      if (mRowBoundsStale.at(valueIndex))
+        recalculateRowBounds(valueIndex);
+      const QCPRange &rowBounds = mRowBounds.at(valueIndex);
+      if (rowBounds.upper > maxHeight)
+        maxHeight = rowBounds.upper;
+      if (rowBounds.lower < minHeight)
+        minHeight = rowBounds.lower;
     }
     mDataBounds.lower = minHeight;
     mDataBounds.upper = maxHeight;
@@ -26193,7 +30229,7 @@ void QCPColorMapData::clearAlpha()
   {
     delete[] mAlpha;
     mAlpha = nullptr;
-    mDataModified = true;
+    markModified(QRect(0, 0, mKeySize, mValueSize));
   }
 }
 
@@ -26203,9 +30239,13 @@ void QCPColorMapData::clearAlpha()
 void QCPColorMapData::fill(double z)
 {
   const int dataCount = mValueSize*mKeySize;
-  memset(mData, z, dataCount*sizeof(*mData));
+  for (int i=0; i<dataCount; ++i)
+    mData[i] = z;
   mDataBounds = QCPRange(z, z);
-  mDataModified = true;
+  // a row of NaNs has no bounds, so that the first number written to it becomes its minimum and maximum:
+  mRowBounds.fill(std::isnan(z) ? QCPRange((std::numeric_limits<double>::max)(), -(std::numeric_limits<double>::max)()) : QCPRange(z, z), mValueSize);
+  mRowBoundsStale.fill(false, mValueSize);
+  markModified(QRect(0, 0, mKeySize, mValueSize));
 }
 
 /*!
@@ -26223,10 +30263,181 @@ void QCPColorMapData::fillAlpha(unsigned char alpha)
   {
     const int dataCount = mValueSize*mKeySize;
     memset(mAlpha, alpha, dataCount*sizeof(*mAlpha));
-    mDataModified = true;
+    markModified(QRect(0, 0, mKeySize, mValueSize));
   }
 }
 
+/*! \internal
+
+  Shifts the 2D array \a cells, which has the size of this color map data, by \a keyCells and \a
+  valueCells (both within the map size) and sets the vacated cells to \a fillValue. This is used
+  by \ref scroll for the data and the alpha map.
+*/
+template <typename T>
+void QCPColorMapData::scrollCells(T *cells, int keyCells, int valueCells, T fillValue)
+{
+  const int movedCount = mKeySize-qAbs(keyCells);
+  const int targetBegin = qMax(0, keyCells);
+  const int sourceBegin = qMax(0, -keyCells);
+  for (int i=0; i<mValueSize; ++i)
+  {
+    // when shifting towards higher value indices, go through the rows from the top, so source rows
+    // are moved before they're overwritten:
+    const int valueIndex = valueCells > 0 ? mValueSize-1-i : i;
+    const int sourceIndex = valueIndex-valueCells;
+    T *row = cells+valueIndex*mKeySize;
+    if (sourceIndex >= 0 && sourceIndex < mValueSize)
+    {
+      if (movedCount > 0)
+        memmove(row+targetBegin, cells+sourceIndex*mKeySize+sourceBegin, sizeof(T)*size_t(movedCount));
+      for (int keyIndex=0; keyIndex<targetBegin; ++keyIndex)
+        row[keyIndex] = fillValue;
+      for (int keyIndex=targetBegin+movedCount; keyIndex<mKeySize; ++keyIndex)
+        row[keyIndex] = fillValue;
+    } else
+    {
+      for (int keyIndex=0; keyIndex<mKeySize; ++keyIndex)
+        row[keyIndex] = fillValue;
+    }
+  }
+}
+
+/*!
+  Shifts all cells by \a keyCells in the key dimension and by \a valueCells in the value dimension.
+  Positive values shift towards higher indices. Cells shifted beyond the map are discarded, the
+  vacated cells are set to \a z and, if an alpha map exists, to full opacity.
+  
+  The color map only scrolls its map image accordingly and colorizes the vacated cells, so scrolling
+  is much faster than setting all cells anew. To append a row or column of new data at the upper
+  end of the map, use \ref appendValueRow or \ref appendKeyColumn.
+  
+  The buffered data bounds are extended by \a z, but like with \ref setCell, they aren't decreased
+  if the cells holding the minimum or maximum were shifted out (see \ref recalculateDataBounds).
+*/
+void QCPColorMapData::scroll(int keyCells, int valueCells, double z)
+{
+  if (isEmpty() || !mData || (keyCells == 0 && valueCells == 0))
+    return;
+  keyCells = qBound(-mKeySize, keyCells, mKeySize);
+  valueCells = qBound(-mValueSize, valueCells, mValueSize);
+  const QRect allCells(0, 0, mKeySize, mValueSize);
+  
+  // move the row bounds along with the rows. The cells shifted out of a row may have held its bounds:
+  const QCPRange vacatedBounds = std::isnan(z) ? QCPRange((std::numeric_limits<double>::max)(), -(std::numeric_limits<double>::max)()) : QCPRange(z, z);
+  QVector<QCPRange> rowBounds(mValueSize, vacatedBounds);
+  QVector<bool> rowBoundsStale(mValueSize, false);
+  const int droppedBegin = keyCells > 0 ? mKeySize-keyCells : 0;
+  const int droppedEnd = keyCells > 0 ? mKeySize : -keyCells;
+  for (int valueIndex=0; valueIndex<mValueSize; ++valueIndex)
+  {
+    const int sourceIndex = valueIndex-valueCells;
+    if (sourceIndex < 0 || sourceIndex >= mValueSize)
+      continue;
+    QCPRange bounds = mRowBounds.at(sourceIndex);
+    bool stale = mRowBoundsStale.at(sourceIndex);
+    const double *sourceRow = mData+sourceIndex*mKeySize;
+    for (int keyIndex=droppedBegin; keyIndex<droppedEnd && !stale; ++keyIndex)
+    {
+      if (sourceRow[keyIndex] <= bounds.lower || sourceRow[keyIndex] >= bounds.upper)
+        stale = true;
+    }
+    if (keyCells != 0)
+    {
+      if (z < bounds.lower)
+        bounds.lower = z;
+      if (z > bounds.upper)
+        bounds.upper = z;
+    }
+    rowBounds[valueIndex] = bounds;
+    rowBoundsStale[valueIndex] = stale;
+  }
+  mRowBounds = rowBounds;
+  mRowBoundsStale = rowBoundsStale;
+  if (z < mDataBounds.lower)
+    mDataBounds.lower = z;
+  if (z > mDataBounds.upper)
+    mDataBounds.upper = z;
+  
+  scrollCells(mData, keyCells, valueCells, z);
+  if (mAlpha)
+    scrollCells(mAlpha, keyCells, valueCells, static_cast<unsigned char>(255));
+  
+  // the modified cells move along, and the vacated cells are modified:
+  mModifiedCells = mModifiedCells.translated(keyCells, valueCells) & allCells;
+  mScrolledCells += QPoint(keyCells, valueCells);
+  QRect vacatedCells;
+  if (keyCells != 0)
+    vacatedCells |= QRect(keyCells > 0 ? 0 : mKeySize+keyCells, 0, qAbs(keyCells), mValueSize);
+  if (valueCells != 0)
+    vacatedCells |= QRect(0, valueCells > 0 ? 0 : mValueSize+valueCells, mKeySize, qAbs(valueCells));
+  markModified(vacatedCells);
+}
+
+/*!
+  Shifts all cells by one towards lower key indices (see \ref scroll) and sets the cells with the
+  highest key index to the values in \a z, which must have one entry per value index. The entry
+  at index 0 of \a z is the cell with value index 0.
+  
+  This is the typical way to feed a spectrogram whose time is on the key axis.
+  
+  \see appendValueRow
+*/
+void QCPColorMapData::appendKeyColumn(const QVector<double> &z)
+{
+  if (isEmpty() || !mData)
+    return;
+  if (z.size() != mValueSize)
+  {
+    qDebug() << Q_FUNC_INFO << "column size doesn't match value size:" << z.size() << mValueSize;
+    return;
+  }
+  // vacate the column with NaN, which doesn't extend the bounds, before writing the new values:
+  scroll(-1, 0, std::numeric_limits<double>::quiet_NaN());
+  for (int valueIndex=0; valueIndex<mValueSize; ++valueIndex)
+    writeCell(mKeySize-1, valueIndex, z.at(valueIndex));
+}
+
+/*!
+  Shifts all cells by one towards lower value indices (see \ref scroll) and sets the cells with the
+  highest value index to the values in \a z, which must have one entry per key index. The entry
+  at index 0 of \a z is the cell with key index 0.
+  
+  This is the typical way to feed a waterfall diagram whose time is on the value axis.
+  
+  \see appendKeyColumn
+*/
+void QCPColorMapData::appendValueRow(const QVector<double> &z)
+{
+  if (isEmpty() || !mData)
+    return;
+  if (z.size() != mKeySize)
+  {
+    qDebug() << Q_FUNC_INFO << "row size doesn't match key size:" << z.size() << mKeySize;
+    return;
+  }
+  scroll(0, -1, std::numeric_limits<double>::quiet_NaN());
+  
+  // the new row replaces the vacated row entirely, so its bounds are exact:
+  const int valueIndex = mValueSize-1;
+  double *row = mData+valueIndex*mKeySize;
+  QCPRange &bounds = mRowBounds[valueIndex];
+  for (int keyIndex=0; keyIndex<mKeySize; ++keyIndex)
+  {
+    const double value = z.at(keyIndex);
+    row[keyIndex] = value;
+    if (value < bounds.lower)
+      bounds.lower = value;
+    if (value > bounds.upper)
+      bounds.upper = value;
+  }
+  mRowBoundsStale[valueIndex] = false;
+  if (bounds.lower < mDataBounds.lower)
+    mDataBounds.lower = bounds.lower;
+  if (bounds.upper > mDataBounds.upper)
+    mDataBounds.upper = bounds.upper;
+  markModified(QRect(0, valueIndex, mKeySize, 1));
+}
+
 /*!
   Transforms plot coordinates given by \a key and \a value to cell indices of this QCPColorMapData
   instance. The resulting cell indices are returned via the output parameters \a keyIndex and \a
@@ -26313,6 +30524,66 @@ bool QCPColorMapData::createAlpha(bool initializeOpaque)
   }
 }
 
+/*! \internal
+
+  Sets the cell with the (valid) indices \a keyIndex and \a valueIndex to \a z and extends the
+  buffered data bounds and the bounds of its row. If the cell held the minimum or maximum of its
+  row and \a z doesn't, the row bounds may now be too wide and are marked for recalculation in \ref
+  recalculateDataBounds.
+*/
+void QCPColorMapData::writeCell(int keyIndex, int valueIndex, double z)
+{
+  double &cell = mData[valueIndex*mKeySize + keyIndex];
+  QCPRange &rowBounds = mRowBounds[valueIndex];
+  if ((cell <= rowBounds.lower && !(z <= cell)) || (cell >= rowBounds.upper && !(z >= cell)))
+    mRowBoundsStale[valueIndex] = true;
+  cell = z;
+  if (z < rowBounds.lower)
+    rowBounds.lower = z;
+  if (z > rowBounds.upper)
+    rowBounds.upper = z;
+  if (z < mDataBounds.lower)
+    mDataBounds.lower = z;
+  if (z > mDataBounds.upper)
+    mDataBounds.upper = z;
+  markModified(QRect(keyIndex, valueIndex, 1, 1));
+}
+
+/*! \internal
+
+  Marks the data as modified and adds \a cells to the rectangle of modified cells (in cell
+  indices, with keys along x and values along y), which the color map colorizes again on its next
+  update of the map image.
+*/
+void QCPColorMapData::markModified(const QRect &cells)
+{
+  if (!cells.isEmpty())
+    mModifiedCells |= cells;
+  mDataModified = true;
+  ++mRevision;
+}
+
+/*! \internal
+
+  Goes through the cells with value index \a valueIndex and updates the buffered bounds of this
+  row.
+*/
+void QCPColorMapData::recalculateRowBounds(int valueIndex)
+{
+  double minHeight = (std::numeric_limits<double>::max)();
+  double maxHeight = -(std::numeric_limits<double>::max)();
+  const double *row = mData+valueIndex*mKeySize;
+  for (int keyIndex=0; keyIndex<mKeySize; ++keyIndex)
+  {
+    if (row[keyIndex] > maxHeight)
+      maxHeight = row[keyIndex];
+    if (row[keyIndex] < minHeight)
+      minHeight = row[keyIndex];
+  }
+  mRowBounds[valueIndex] = QCPRange(minHeight, maxHeight);
+  mRowBoundsStale[valueIndex] = false;
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////// QCPColorMap
@@ -26445,7 +30716,8 @@ QCPColorMap::QCPColorMap(QCPAxis *keyAxis, QCPAxis *valueAxis) :
   mGradient(QCPColorGradient::gpCold),
   mInterpolate(true),
   mTightBoundary(false),
-  mMapImageInvalidated(true)
+  mMapImageInvalidated(true),
+  mMapImageKeyOrientation(Qt::Horizontal)
 {
 }
 
@@ -26477,6 +30749,7 @@ void QCPColorMap::setData(QCPColorMapData *data, bool copy)
     mMapData = data;
   }
   mMapImageInvalidated = true;
+  markDirty();
 }
 
 /*!
@@ -26497,6 +30770,7 @@ void QCPColorMap::setDataRange(const QCPRange &dataRange)
     else
       mDataRange = dataRange.sanitizedForLinScale();
     mMapImageInvalidated = true;
+    markDirty();
     emit dataRangeChanged(mDataRange);
   }
 }
@@ -26512,6 +30786,7 @@ void QCPColorMap::setDataScaleType(QCPAxis::ScaleType scaleType)
   {
     mDataScaleType = scaleType;
     mMapImageInvalidated = true;
+    markDirty();
     emit dataScaleTypeChanged(mDataScaleType);
     if (mDataScaleType == QCPAxis::stLogarithmic)
       setDataRange(mDataRange.sanitizedForLogScale());
@@ -26535,6 +30810,7 @@ void QCPColorMap::setGradient(const QCPColorGradient &gradient)
   {
     mGradient = gradient;
     mMapImageInvalidated = true;
+    markDirty();
     emit gradientChanged(mGradient);
   }
 }
@@ -26549,6 +30825,7 @@ void QCPColorMap::setInterpolate(bool enabled)
 {
   mInterpolate = enabled;
   mMapImageInvalidated = true; // because oversampling factors might need to change
+  markDirty();
 }
 
 /*!
@@ -26737,6 +31014,63 @@ QCPRange QCPColorMap::getValueRange(bool &foundRange, QCP::SignDomain inSignDoma
   return result;
 }
 
+/*! \internal
+  \class QCPColorMapColorizeTask
+  
+  A runnable used by \ref QCPColorMap::updateMapImage to colorize chunks of scanlines on a thread
+  pool. The task colorizes chunks until all are claimed (see \ref colorizeChunks), then releases
+  the semaphore passed to the constructor.
+*/
+class QCPColorMapColorizeTask : public QRunnable
+{
+public:
+  QCPColorMapColorizeTask(QCPColorMap *colorMap, uchar *imageBits, int bytesPerLine, Qt::Orientation keyOrientation, const QRect &cells, int chunkLines, QAtomicInt *nextLine, QSemaphore *finished) :
+    mColorMap(colorMap),
+    mImageBits(imageBits),
+    mBytesPerLine(bytesPerLine),
+    mKeyOrientation(keyOrientation),
+    mCells(cells),
+    mChunkLines(chunkLines),
+    mNextLine(nextLine),
+    mFinished(finished)
+  {
+    setAutoDelete(false);
+  }
+  
+  virtual void run() Q_DECL_OVERRIDE
+  {
+    colorizeChunks(mColorMap, mImageBits, mBytesPerLine, mKeyOrientation, mCells, mChunkLines, *mNextLine);
+    mFinished->release();
+  }
+  
+  // returns the cells of the scanlines beginLine to endLine (exclusive) of cells:
+  static QRect lineCells(const QRect &cells, Qt::Orientation keyOrientation, int beginLine, int endLine)
+  {
+    if (keyOrientation == Qt::Horizontal)
+      return QRect(cells.left(), cells.top()+beginLine, cells.width(), endLine-beginLine);
+    else
+      return QRect(cells.left()+beginLine, cells.top(), endLine-beginLine, cells.height());
+  }
+  
+  static void colorizeChunks(QCPColorMap *colorMap, uchar *imageBits, int bytesPerLine, Qt::Orientation keyOrientation, const QRect &cells, int chunkLines, QAtomicInt &nextLine)
+  {
+    const int lineCount = keyOrientation == Qt::Horizontal ? cells.height() : cells.width();
+    int beginLine;
+    while ((beginLine = nextLine.fetchAndAddOrdered(chunkLines)) < lineCount)
+      colorMap->colorizeCells(imageBits, bytesPerLine, keyOrientation, lineCells(cells, keyOrientation, beginLine, qMin(beginLine+chunkLines, lineCount)));
+  }
+  
+private:
+  QCPColorMap *mColorMap;
+  uchar *mImageBits;
+  int mBytesPerLine;
+  Qt::Orientation mKeyOrientation;
+  QRect mCells;
+  int mChunkLines;
+  QAtomicInt *mNextLine;
+  QSemaphore *mFinished;
+};
+
 /*! \internal
   
   Updates the internal map image buffer by going through the internal \ref QCPColorMapData and
@@ -26746,6 +31080,15 @@ QCPRange QCPColorMap::getValueRange(bool &foundRange, QCP::SignDomain inSignDoma
   has been invalidated for a different reason (e.g. a change of the data range with \ref
   setDataRange).
   
+  If the map image is otherwise still valid, only the cells that were modified since the last
+  update are colorized, after the image was scrolled along with the data (see \ref
+  QCPColorMapData::scroll). This keeps the update cost proportional to the new data, e.g. one row
+  per time step in a waterfall diagram.
+  
+  Large areas are colorized concurrently in chunks of scanlines (see \ref colorizeCells) on the
+  global QThreadPool, with the calling thread taking part. Only threads that are currently idle in
+  the pool are used, and this method returns after all scanlines are colorized.
+  
   If the map cell count is low, the image created will be oversampled in order to avoid a
   QPainter::drawImage bug which makes inner pixel boundaries jitter when stretch-drawing images
   without smooth transform enabled. Accordingly, oversampling isn't performed if \ref
@@ -26760,14 +31103,21 @@ void QCPColorMap::updateMapImage()
   const QImage::Format format = QImage::Format_ARGB32_Premultiplied;
   const int keySize = mMapData->keySize();
   const int valueSize = mMapData->valueSize();
+  const Qt::Orientation keyOrientation = keyAxis->orientation();
   int keyOversamplingFactor = mInterpolate ? 1 : int(1.0+100.0/double(keySize)); // make mMapImage have at least size 100, factor becomes 1 if size > 200 or interpolation is on
   int valueOversamplingFactor = mInterpolate ? 1 : int(1.0+100.0/double(valueSize)); // make mMapImage have at least size 100, factor becomes 1 if size > 200 or interpolation is on
+  bool imageRecreated = false;
   
   // resize mMapImage to correct dimensions including possible oversampling factors, according to key/value axes orientation:
-  if (keyAxis->orientation() == Qt::Horizontal && (mMapImage.width() != keySize*keyOversamplingFactor || mMapImage.height() != valueSize*valueOversamplingFactor))
+  if (keyOrientation == Qt::Horizontal && (mMapImage.width() != keySize*keyOversamplingFactor || mMapImage.height() != valueSize*valueOversamplingFactor))
+  {
     mMapImage = QImage(QSize(keySize*keyOversamplingFactor, valueSize*valueOversamplingFactor), format);
-  else if (keyAxis->orientation() == Qt::Vertical && (mMapImage.width() != valueSize*valueOversamplingFactor || mMapImage.height() != keySize*keyOversamplingFactor))
+    imageRecreated = true;
+  } else if (keyOrientation == Qt::Vertical && (mMapImage.width() != valueSize*valueOversamplingFactor || mMapImage.height() != keySize*keyOversamplingFactor))
+  {
     mMapImage = QImage(QSize(valueSize*valueOversamplingFactor, keySize*keyOversamplingFactor), format);
+    imageRecreated = true;
+  }
   
   if (mMapImage.isNull())
   {
@@ -26780,54 +31130,157 @@ void QCPColorMap::updateMapImage()
     if (keyOversamplingFactor > 1 || valueOversamplingFactor > 1)
     {
       // resize undersampled map image to actual key/value cell sizes:
-      if (keyAxis->orientation() == Qt::Horizontal && (mUndersampledMapImage.width() != keySize || mUndersampledMapImage.height() != valueSize))
+      if (keyOrientation == Qt::Horizontal && (mUndersampledMapImage.width() != keySize || mUndersampledMapImage.height() != valueSize))
+      {
         mUndersampledMapImage = QImage(QSize(keySize, valueSize), format);
-      else if (keyAxis->orientation() == Qt::Vertical && (mUndersampledMapImage.width() != valueSize || mUndersampledMapImage.height() != keySize))
+        imageRecreated = true;
+      } else if (keyOrientation == Qt::Vertical && (mUndersampledMapImage.width() != valueSize || mUndersampledMapImage.height() != keySize))
+      {
         mUndersampledMapImage = QImage(QSize(valueSize, keySize), format);
+        imageRecreated = true;
+      }
       localMapImage = &mUndersampledMapImage; // make the colorization run on the undersampled image
     } else if (!mUndersampledMapImage.isNull())
       mUndersampledMapImage = QImage(); // don't need oversampling mechanism anymore (map size has changed) but mUndersampledMapImage still has nonzero size, free it
     
-    const double *rawData = mMapData->mData;
-    const unsigned char *rawAlpha = mMapData->mAlpha;
-    if (keyAxis->orientation() == Qt::Horizontal)
-    {
-      const int lineCount = valueSize;
-      const int rowCount = keySize;
-      for (int line=0; line<lineCount; ++line)
+    // if only data cells changed since the last update, scroll the image along with the data and
+    // colorize just the modified cells:
+    const QRect allCells(0, 0, keySize, valueSize);
+    QRect cells = allCells;
+    if (!mMapImageInvalidated && !imageRecreated && keyOrientation == mMapImageKeyOrientation)
+    {
+      cells = mMapData->mModifiedCells & allCells;
+      const QPoint scrolledCells = mMapData->mScrolledCells;
+      if (cells != allCells && !scrolledCells.isNull())
       {
-        QRgb* pixels = reinterpret_cast<QRgb*>(localMapImage->scanLine(lineCount-1-line)); // invert scanline index because QImage counts scanlines from top, but our vertical index counts from bottom (mathematical coordinate system)
-        if (rawAlpha)
-          mGradient.colorize(rawData+line*rowCount, rawAlpha+line*rowCount, mDataRange, pixels, rowCount, 1, mDataScaleType==QCPAxis::stLogarithmic);
+        // the image counts scanlines from the top, but the value index counts from the bottom:
+        if (keyOrientation == Qt::Horizontal)
+          scrollImage(localMapImage, scrolledCells.x(), -scrolledCells.y());
         else
-          mGradient.colorize(rawData+line*rowCount, mDataRange, pixels, rowCount, 1, mDataScaleType==QCPAxis::stLogarithmic);
+          scrollImage(localMapImage, scrolledCells.y(), -scrolledCells.x());
       }
-    } else // keyAxis->orientation() == Qt::Vertical
-    {
-      const int lineCount = keySize;
-      const int rowCount = valueSize;
-      for (int line=0; line<lineCount; ++line)
+    }
+    
+    // colorize the first scanline on this thread, which also brings the color buffer and lookup
+    // tables of the gradient up to date, so the remaining scanlines can be colorized concurrently
+    // (colorizeCells works on the raw image bits, because QImage::scanLine isn't reentrant on the
+    // same image):
+    if (!cells.isEmpty())
+    {
+      const int lineCount = keyOrientation == Qt::Horizontal ? cells.height() : cells.width();
+      uchar *imageBits = localMapImage->bits();
+      const int bytesPerLine = localMapImage->bytesPerLine();
+      colorizeCells(imageBits, bytesPerLine, keyOrientation, QCPColorMapColorizeTask::lineCells(cells, keyOrientation, 0, 1));
+      const int parallelMinimumCells = 1 << 16;
+      if (lineCount > 1 && qint64(cells.width())*qint64(cells.height()) >= parallelMinimumCells && QThread::idealThreadCount() > 1)
       {
-        QRgb* pixels = reinterpret_cast<QRgb*>(localMapImage->scanLine(lineCount-1-line)); // invert scanline index because QImage counts scanlines from top, but our vertical index counts from bottom (mathematical coordinate system)
-        if (rawAlpha)
-          mGradient.colorize(rawData+line, rawAlpha+line, mDataRange, pixels, rowCount, lineCount, mDataScaleType==QCPAxis::stLogarithmic);
-        else
-          mGradient.colorize(rawData+line, mDataRange, pixels, rowCount, lineCount, mDataScaleType==QCPAxis::stLogarithmic);
-      }
+        // split the remaining scanlines into chunks, four per thread for load balancing:
+        const int chunkLines = qMax(1, (lineCount-1)/(4*QThread::idealThreadCount()));
+        const int chunkCount = (lineCount-1+chunkLines-1)/chunkLines;
+        QAtomicInt nextLine(1);
+        QThreadPool *pool = QThreadPool::globalInstance();
+        QSemaphore finished;
+        QList<QCPColorMapColorizeTask*> tasks;
+        for (int i=1; i<chunkCount; ++i)
+        {
+          QCPColorMapColorizeTask *task = new QCPColorMapColorizeTask(this, imageBits, bytesPerLine, keyOrientation, cells, chunkLines, &nextLine, &finished);
+          if (!pool->tryStart(task))
+          {
+            delete task;
+            break;
+          }
+          tasks.append(task);
+        }
+        QCPColorMapColorizeTask::colorizeChunks(this, imageBits, bytesPerLine, keyOrientation, cells, chunkLines, nextLine);
+        finished.acquire(tasks.size());
+        qDeleteAll(tasks);
+      } else if (lineCount > 1)
+        colorizeCells(imageBits, bytesPerLine, keyOrientation, QCPColorMapColorizeTask::lineCells(cells, keyOrientation, 1, lineCount));
     }
     
     if (keyOversamplingFactor > 1 || valueOversamplingFactor > 1)
     {
-      if (keyAxis->orientation() == Qt::Horizontal)
+      if (keyOrientation == Qt::Horizontal)
         mMapImage = mUndersampledMapImage.scaled(keySize*keyOversamplingFactor, valueSize*valueOversamplingFactor, Qt::IgnoreAspectRatio, Qt::FastTransformation);
       else
         mMapImage = mUndersampledMapImage.scaled(valueSize*valueOversamplingFactor, keySize*keyOversamplingFactor, Qt::IgnoreAspectRatio, Qt::FastTransformation);
     }
   }
+  mMapImageKeyOrientation = keyOrientation;
   mMapData->mDataModified = false;
+  mMapData->mModifiedCells = QRect();
+  mMapData->mScrolledCells = QPoint();
   mMapImageInvalidated = false;
 }
 
+/*! \internal
+  
+  Colorizes the map cells \a cells (in cell indices, with keys along x and values along y) into the
+  map image whose pixels start at \a imageBits, with \a bytesPerLine bytes per scanline. A scanline
+  holds the cells of one value index if \a keyOrientation is Qt::Horizontal, and of one key index
+  otherwise.
+  
+  This method is called concurrently for cells of disjoint scanlines by \ref updateMapImage.
+*/
+void QCPColorMap::colorizeCells(uchar *imageBits, int bytesPerLine, Qt::Orientation keyOrientation, const QRect &cells)
+{
+  const double *rawData = mMapData->mData;
+  const unsigned char *rawAlpha = mMapData->mAlpha;
+  const bool logarithmic = mDataScaleType == QCPAxis::stLogarithmic;
+  const int keySize = mMapData->keySize();
+  const int valueSize = mMapData->valueSize();
+  if (keyOrientation == Qt::Horizontal)
+  {
+    for (int valueIndex=cells.top(); valueIndex<=cells.bottom(); ++valueIndex)
+    {
+      QRgb* pixels = reinterpret_cast<QRgb*>(imageBits+qint64(valueSize-1-valueIndex)*bytesPerLine)+cells.left(); // invert scanline index because QImage counts scanlines from top, but our vertical index counts from bottom (mathematical coordinate system)
+      const qint64 offset = qint64(valueIndex)*keySize+cells.left();
+      if (rawAlpha)
+        mGradient.colorize(rawData+offset, rawAlpha+offset, mDataRange, pixels, cells.width(), 1, logarithmic);
+      else
+        mGradient.colorize(rawData+offset, mDataRange, pixels, cells.width(), 1, logarithmic);
+    }
+  } else // keyOrientation == Qt::Vertical
+  {
+    for (int keyIndex=cells.left(); keyIndex<=cells.right(); ++keyIndex)
+    {
+      QRgb* pixels = reinterpret_cast<QRgb*>(imageBits+qint64(keySize-1-keyIndex)*bytesPerLine)+cells.top(); // invert scanline index because QImage counts scanlines from top, but our vertical index counts from bottom (mathematical coordinate system)
+      const qint64 offset = qint64(cells.top())*keySize+keyIndex;
+      if (rawAlpha)
+        mGradient.colorize(rawData+offset, rawAlpha+offset, mDataRange, pixels, cells.height(), keySize, logarithmic);
+      else
+        mGradient.colorize(rawData+offset, mDataRange, pixels, cells.height(), keySize, logarithmic);
+    }
+  }
+}
+
+/*! \internal
+  
+  Moves the pixels of \a image by \a dx to the right and by \a dy downwards. The pixels moved in
+  from outside keep their previous content, they are expected to be colorized afterwards. \a image
+  must have a 32 bit format.
+  
+  This is used by \ref updateMapImage to scroll the map image along with the data.
+*/
+void QCPColorMap::scrollImage(QImage *image, int dx, int dy)
+{
+  const int width = image->width();
+  const int height = image->height();
+  if ((dx == 0 && dy == 0) || qAbs(dx) >= width || qAbs(dy) >= height)
+    return;
+  uchar *bits = image->bits();
+  const int bytesPerLine = image->bytesPerLine();
+  const size_t movedBytes = sizeof(QRgb)*size_t(width-qAbs(dx));
+  for (int i=0; i<height-qAbs(dy); ++i)
+  {
+    // when moving downwards, go through the scanlines from the bottom, so source scanlines are
+    // moved before they're overwritten:
+    const int targetLine = dy > 0 ? height-1-i : i;
+    const int sourceLine = targetLine-dy;
+    memmove(bits+qint64(targetLine)*bytesPerLine+sizeof(QRgb)*size_t(qMax(0, dx)), bits+qint64(sourceLine)*bytesPerLine+sizeof(QRgb)*size_t(qMax(0, -dx)), movedBytes);
+  }
+}
+
 /* inherits documentation from base class */
 void QCPColorMap::draw(QCPPainter *painter)
 {
@@ -26836,7 +31289,15 @@ void QCPColorMap::draw(QCPPainter *painter)
   applyDefaultAntialiasingHint(painter);
   
   if (mMapData->mDataModified || mMapImageInvalidated)
+  {
+    QCPReplotProfiler *profiler = mParentPlot->profiler();
+    QElapsedTimer dataTimer; // measures the colorization for the profiler
+    if (profiler)
+      dataTimer.start();
     updateMapImage();
+    if (profiler)
+      profiler->addDataTime(this, dataTimer.nsecsElapsed()*1e-6);
+  }
   
   // use buffer if painting vectorized (PDF):
   const bool useBuffer = painter->modes().testFlag(QCPPainter::pmVectorized);
@@ -26885,7 +31346,16 @@ void QCPColorMap::draw(QCPPainter *painter)
                                   coordsToPixels(mMapData->keyRange().upper, mMapData->valueRange().upper)).normalized();
     localPainter->setClipRect(tightClipRect, Qt::IntersectClip);
   }
-  localPainter->drawImage(imageRect, mMapImage.mirrored(mirrorX, mirrorY));
+  const QImage mirroredMapImage = mMapImage.mirrored(mirrorX, mirrorY);
+  const double tiledRenderingMinimumArea = 1e6; // in pixels, below this a single thread scales the image fast enough
+  if (mParentPlot->plottingHints().testFlag(QCP::phTiledRendering) &&
+      imageRect.width()*imageRect.height() >= tiledRenderingMinimumArea &&
+      QCPTiledRenderer::canRender(localPainter))
+  {
+    QCPImageTileRenderer renderer(localPainter, imageRect, mirroredMapImage);
+    renderer.render();
+  } else
+    localPainter->drawImage(imageRect, mirroredMapImage);
   if (mTightBoundary)
     localPainter->setClipRegion(clipBackup);
   localPainter->setRenderHint(QPainter::SmoothPixmapTransform, smoothBackup);
@@ -26916,6 +31386,12 @@ void QCPColorMap::drawLegendIcon(QCPPainter *painter, const QRectF &rect) const
   painter->drawRect(rect.adjusted(1, 1, 0, 0));
   */
 }
+
+/* inherits documentation from base class */
+quint32 QCPColorMap::dataRevision() const
+{
+  return mMapData->revision();
+}
 /* end of 'src/plottables/plottable-colormap.cpp' */
 
 
@@ -27131,6 +31607,7 @@ QCPFinancial::~QCPFinancial()
 void QCPFinancial::setData(QSharedPointer<QCPFinancialDataContainer> data)
 {
   mDataContainer = data;
+  markDirty();
 }
 
 /*! \overload
@@ -27972,6 +32449,9 @@ QCPErrorBarsData::QCPErrorBarsData(double errorMinus, double errorPlus) :
   Returns a shared pointer to the internal data storage of type \ref QCPErrorBarsDataContainer. You
   may use it to directly manipulate the error values, which may be more convenient and faster than
   using the regular \ref setData methods.
+  
+  After modifying the error values this way, call \ref setData with the same container, so the
+  error bars are redrawn by incremental replots and the hit-test index is rebuilt.
 */
 
 /* end of documentation of inline functions */
@@ -27994,7 +32474,8 @@ QCPErrorBars::QCPErrorBars(QCPAxis *keyAxis, QCPAxis *valueAxis) :
   mDataContainer(new QVector<QCPErrorBarsData>),
   mErrorType(etValueError),
   mWhiskerWidth(9),
-  mSymbolGap(10)
+  mSymbolGap(10),
+  mDataRevision(0)
 {
   setPen(QPen(Qt::black, 0));
   setBrush(Qt::NoBrush);
@@ -28025,6 +32506,8 @@ QCPErrorBars::~QCPErrorBars()
 void QCPErrorBars::setData(QSharedPointer<QCPErrorBarsDataContainer> data)
 {
   mDataContainer = data;
+  ++mDataRevision;
+  markDirty();
 }
 
 /*! \overload
@@ -28088,6 +32571,7 @@ void QCPErrorBars::setDataPlottable(QCPAbstractPlottable *plottable)
   }
   
   mDataPlottable = plottable;
+  ++mDataRevision;
 }
 
 /*!
@@ -28150,6 +32634,7 @@ void QCPErrorBars::addData(const QVector<double> &errorMinus, const QVector<doub
   mDataContainer->reserve(n);
   for (int i=0; i<n; ++i)
     mDataContainer->append(QCPErrorBarsData(errorMinus.at(i), errorPlus.at(i)));
+  ++mDataRevision;
 }
 
 /*! \overload
@@ -28164,6 +32649,7 @@ void QCPErrorBars::addData(const QVector<double> &errorMinus, const QVector<doub
 void QCPErrorBars::addData(double error)
 {
   mDataContainer->append(QCPErrorBarsData(error));
+  ++mDataRevision;
 }
 
 /*! \overload
@@ -28179,6 +32665,7 @@ void QCPErrorBars::addData(double error)
 void QCPErrorBars::addData(double errorMinus, double errorPlus)
 {
   mDataContainer->append(QCPErrorBarsData(errorMinus, errorPlus));
+  ++mDataRevision;
 }
 
 /* inherits documentation from base class */
@@ -28746,26 +33233,46 @@ double QCPErrorBars::pointDistance(const QPointF &pixelPoint, QCPErrorBarsDataCo
     return -1.0;
   }
   
-  QCPErrorBarsDataContainer::const_iterator begin, end;
-  getVisibleDataBounds(begin, end, QCPDataRange(0, dataCount()));
-  
-  // calculate minimum distances to error backbones (whiskers are ignored for speed) and find closestData iterator:
-  double minDistSqr = (std::numeric_limits<double>::max)();
-  QVector<QLineF> backbones, whiskers;
-  for (QCPErrorBarsDataContainer::const_iterator it=begin; it!=end; ++it)
+  // the error backbones (whiskers are ignored for speed) are kept in a segment index, which is rebuilt
+  // only when the data, the axis ranges or the axis rect geometry changed:
+  QVector<double> signature = hitTestSignature();
+  signature << mErrorType << mSymbolGap << quintptr(mDataContainer.data()) << quintptr(mDataPlottable.data());
+  if (!mBackboneIndex.isValid(signature))
   {
-    getErrorBarLines(it, backbones, whiskers);
-    foreach (const QLineF &backbone, backbones)
+    QCPErrorBarsDataContainer::const_iterator begin, end;
+    getVisibleDataBounds(begin, end, QCPDataRange(0, dataCount()));
+    QVector<QPointF> backbonePoints;
+    QVector<QLineF> backbones, whiskers;
+    mBackboneDataIndices.clear();
+    for (QCPErrorBarsDataContainer::const_iterator it=begin; it!=end; ++it)
     {
-      const double currentDistSqr = QCPVector2D(pixelPoint).distanceSquaredToLine(backbone);
-      if (currentDistSqr < minDistSqr)
+      backbones.clear();
+      getErrorBarLines(it, backbones, whiskers);
+      foreach (const QLineF &backbone, backbones)
       {
-        minDistSqr = currentDistSqr;
-        closestData = it;
+        backbonePoints << backbone.p1() << backbone.p2();
+        mBackboneDataIndices << int(it-mDataContainer->constBegin());
       }
     }
+    mBackboneIndex.build(backbonePoints, QCPSegmentIndex::smPairs, signature, mKeyAxis->axisRect()->rect());
   }
-  return qSqrt(minDistSqr);
+  
+  int pointIndex;
+  const double distance = mBackboneIndex.nearest(pixelPoint, &pointIndex);
+  if (pointIndex < 0)
+    return qSqrt((std::numeric_limits<double>::max)());
+  closestData = mDataContainer->constBegin()+mBackboneDataIndices.at(pointIndex/2);
+  return distance;
+}
+
+/*! \internal
+  
+  Returns the revision of the error values combined with the data revision of the data plottable,
+  since the error bars move with the data points they are attached to.
+*/
+quint32 QCPErrorBars::dataRevision() const
+{
+  return mDataRevision + (mDataPlottable ? mDataPlottable->dataRevision()*2654435761u : 0u);
 }
 
 /*! \internal
@@ -30558,6 +35065,7 @@ void QCPItemTracer::setGraph(QCPGraph *graph)
 void QCPItemTracer::setGraphKey(double key)
 {
   mGraphKey = key;
+  markDirty();
 }
 
 /*!
@@ -30698,43 +35206,44 @@ void QCPItemTracer::updatePosition()
   {
     if (mParentPlot->hasPlottable(mGraph))
     {
-      if (mGraph->data()->size() > 1)
+      const int count = mGraph->dataCount(); // also covers graphs that display data columns, see QCPGraph::setDataColumns
+      if (count > 1)
       {
-        QCPGraphDataContainer::const_iterator first = mGraph->data()->constBegin();
-        QCPGraphDataContainer::const_iterator last = mGraph->data()->constEnd()-1;
-        if (mGraphKey <= first->key)
-          position->setCoords(first->key, first->value);
-        else if (mGraphKey >= last->key)
-          position->setCoords(last->key, last->value);
+        const int last = count-1;
+        if (mGraphKey <= mGraph->dataMainKey(0))
+          position->setCoords(mGraph->dataMainKey(0), mGraph->dataMainValue(0));
+        else if (mGraphKey >= mGraph->dataMainKey(last))
+          position->setCoords(mGraph->dataMainKey(last), mGraph->dataMainValue(last));
         else
         {
-          QCPGraphDataContainer::const_iterator it = mGraph->data()->findBegin(mGraphKey);
-          if (it != mGraph->data()->constEnd()) // mGraphKey is not exactly on last iterator, but somewhere between iterators
+          const int index = mGraph->findBegin(mGraphKey);
+          if (index < last) // mGraphKey is not exactly on last data point, but somewhere between data points
           {
-            QCPGraphDataContainer::const_iterator prevIt = it;
-            ++it; // won't advance to constEnd because we handled that case (mGraphKey >= last->key) before
+            const double prevKey = mGraph->dataMainKey(index);
+            const double prevValue = mGraph->dataMainValue(index);
+            const double nextKey = mGraph->dataMainKey(index+1);
+            const double nextValue = mGraph->dataMainValue(index+1);
             if (mInterpolating)
             {
-              // interpolate between iterators around mGraphKey:
+              // interpolate between data points around mGraphKey:
               double slope = 0;
-              if (!qFuzzyCompare(double(it->key), double(prevIt->key)))
-                slope = (it->value-prevIt->value)/(it->key-prevIt->key);
-              position->setCoords(mGraphKey, (mGraphKey-prevIt->key)*slope+prevIt->value);
+              if (!qFuzzyCompare(nextKey, prevKey))
+                slope = (nextValue-prevValue)/(nextKey-prevKey);
+              position->setCoords(mGraphKey, (mGraphKey-prevKey)*slope+prevValue);
             } else
             {
-              // find iterator with key closest to mGraphKey:
-              if (mGraphKey < (prevIt->key+it->key)*0.5)
-                position->setCoords(prevIt->key, prevIt->value);
+              // find data point with key closest to mGraphKey:
+              if (mGraphKey < (prevKey+nextKey)*0.5)
+                position->setCoords(prevKey, prevValue);
               else
-                position->setCoords(it->key, it->value);
+                position->setCoords(nextKey, nextValue);
             }
-          } else // mGraphKey is exactly on last iterator (should actually be caught when comparing first/last keys, but this is a failsafe for fp uncertainty)
-            position->setCoords(it->key, it->value);
+          } else // mGraphKey is exactly on last data point (should actually be caught when comparing first/last keys, but this is a failsafe for fp uncertainty)
+            position->setCoords(mGraph->dataMainKey(last), mGraph->dataMainValue(last));
         }
-      } else if (mGraph->data()->size() == 1)
+      } else if (count == 1)
       {
-        QCPGraphDataContainer::const_iterator it = mGraph->data()->constBegin();
-        position->setCoords(it->key, it->value);
+        position->setCoords(mGraph->dataMainKey(0), mGraph->dataMainValue(0));
       } else
         qDebug() << Q_FUNC_INFO << "graph has no data";
     } else
@@ -32642,7 +37151,6 @@ QCPPolarAxisAngular::QCPPolarAxisAngular(QCustomPlot *parentPlot) :
   setTickLabelMode(lmUpright);
   mLabelPainter.setAnchorReferenceType(QCPLabelPainterPrivate::artNormal);
   mLabelPainter.setAbbreviateDecimalPowers(false);
-  mLabelPainter.setCacheSize(24); // so we can cache up to 15-degree intervals, polar angular axis uses a bit larger cache than normal axes
   
   setMinimumSize(50, 50);
   setMinimumMargins(QMargins(30, 30, 30, 30));
@@ -35122,7 +39630,11 @@ void QCPPolarGraph::drawFill(QCPPainter *painter, QVector<QPointF> *lines) const
 {
   applyFillAntialiasingHint(painter);
   if (painter->brush().style() != Qt::NoBrush && painter->brush().color().alpha() != 0)
-    painter->drawPolygon(QPolygonF(*lines));
+  {
+    const QPolygonF fillPolygon(*lines);
+    if (!QCPRasterizer::drawPolygon(painter, fillPolygon))
+      painter->drawPolygon(fillPolygon);
+  }
 }
 
 /*! \internal
@@ -35136,8 +39648,13 @@ void QCPPolarGraph::drawScatterPlot(QCPPainter *painter, const QVector<QPointF>
 {
   applyScattersAntialiasingHint(painter);
   style.applyTo(painter, mPen);
-  for (int i=0; i<scatters.size(); ++i)
-    style.drawShape(painter, scatters.at(i).x(), scatters.at(i).y());
+  if (mParentPlot->plottingHints().testFlag(QCP::phCacheScatters))
+    style.drawShapes(painter, scatters);
+  else
+  {
+    for (int i=0; i<scatters.size(); ++i)
+      style.drawShape(painter, scatters.at(i).x(), scatters.at(i).y());
+  }
 }
 
 void QCPPolarGraph::drawLegendIcon(QCPPainter *painter, const QRectF &rect) const
@@ -35257,6 +39774,10 @@ void QCPPolarGraph::getDataSegments(QList<QCPDataRange> &selectedSegments, QList
 
 void QCPPolarGraph::drawPolyline(QCPPainter *painter, const QVector<QPointF> &lineData) const
 {
+  // draw antialiased solid lines directly into the paint buffer, if the software rasterizer is enabled:
+  if (QCPRasterizer::drawPolyline(painter, lineData.constData(), lineData.size()))
+    return;
+  
   // if drawing solid line and not in PDF, use much faster line drawing instead of polyline:
   if (mParentPlot->plottingHints().testFlag(QCP::phFastPolylines) &&
       painter->pen().style() == Qt::SolidLine &&
@@ -47,6 +47,10 @@
 #  endif
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define QCP_SSE2
+#endif
+
 #include <QtCore/QObject>
 #include <QtCore/QPointer>
 #include <QtCore/QSharedPointer>
@@ -99,6 +103,17 @@
 #if QT_VERSION >= QT_VERSION_CHECK(4, 8, 0)
 #  include <QtCore/QElapsedTimer>
 #endif
+#include <QtCore/QAtomicPointer>
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QMutex>
+#include <QtCore/QDataStream>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QThreadStorage>
+#ifdef QCP_SSE2
+#  include <emmintrin.h>
+#endif
 # if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
 #  include <QtCore/QTimeZone>
 #endif
@@ -118,6 +133,9 @@ class QCPPlottableInterface1D;
 class QCPLegend;
 class QCPItemPosition;
 class QCPLayer;
+class QCPPaintBufferRenderTask;
+class QCPTileRenderTask;
+class QCPColorMapColorizeTask;
 class QCPAbstractLegendItem;
 class QCPSelectionRect;
 class QCPColorMap;
@@ -267,7 +285,14 @@ enum PlottingHint { phNone              = 0x000 ///< <tt>0x000</tt> No hints are
                                                 ///<                joins, thus is most effective for pen sizes larger than 1. It is only used for solid line pens.
                     ,phImmediateRefresh = 0x002 ///< <tt>0x002</tt> causes an immediate repaint() instead of a soft update() when QCustomPlot::replot() is called with parameter \ref QCustomPlot::rpRefreshHint.
                                                 ///<                This is set by default to prevent the plot from freezing on fast consecutive replots (e.g. user drags ranges with mouse).
-                    ,phCacheLabels      = 0x004 ///< <tt>0x004</tt> axis (tick) labels will be cached as pixmaps, increasing replot performance.
+                    ,phCacheLabels      = 0x004 ///< <tt>0x004</tt> axis (tick) labels will be cached as images, increasing replot performance. The cache is shared by all plots (see \ref QCPLabelCache).
+                    ,phIncrementalReplot = 0x008 ///< <tt>0x008</tt> QCustomPlot::replot() only redraws the paint buffers whose layers changed since the last replot (see \ref QCPLayerable::markDirty).
+                    ,phParallelLayers   = 0x010 ///< <tt>0x010</tt> QCustomPlot::replot() draws the layers of different paint buffers concurrently on the global thread pool, using QImage based paint buffers
+                                                ///<                (see \ref QCPPaintBufferImage). This has no effect if OpenGL is used (\ref QCustomPlot::setOpenGl).
+                    ,phTiledRendering   = 0x020 ///< <tt>0x020</tt> Long graph/curve lines and large color map images are rasterized in tiles on multiple threads (see \ref QCPTiledRenderer).
+                                                ///<                This also applies to raster exports with QCustomPlot::toPixmap and QCustomPlot::saveRastered.
+                    ,phCacheScatters    = 0x040 ///< <tt>0x040</tt> Scatter symbols of graphs and curves are rendered once per scatter style into images and then blitted at each data point
+                                                ///<                (see \ref QCPScatterStyle::drawShapes). Symbol positions are rounded to a quarter of a device pixel.
                   };
 Q_DECLARE_FLAGS(PlottingHints, PlottingHint)
 
@@ -506,6 +531,47 @@ inline QDebug operator<< (QDebug d, const QCPVector2D &vec)
     return d.space();
 }
 
+class QCP_LIB_DECL QCPSegmentIndex
+{
+public:
+  /*!
+    Defines how the points passed to \ref build form the indexed segments.
+  */
+  enum SegmentMode { smPolyline ///< consecutive points form a connected line, i.e. point i and i+1 form segment i
+                     ,smPairs   ///< every two points form an independent segment, e.g. impulse lines or error bars
+                     ,smPoints  ///< every point is indexed on its own, e.g. scatter points
+                   };
+  
+  QCPSegmentIndex();
+  
+  // non-virtual methods:
+  bool isValid(const QVector<double> &signature) const;
+  void build(const QVector<QPointF> &points, SegmentMode mode, const QVector<double> &signature, const QRectF &focusRect=QRectF());
+  void clear();
+  double nearest(const QPointF &pixelPoint, int *pointIndex=nullptr) const;
+  
+protected:
+  // property members:
+  QVector<QPointF> mPoints;
+  SegmentMode mMode;
+  QVector<double> mSignature;
+  bool mBuilt;
+  
+  // non-property members:
+  int mColumns, mRows;
+  double mCellWidth, mCellHeight;
+  QPointF mGridOrigin;
+  QVector<int> mCellStart, mCellSegments;
+  
+  // non-virtual methods:
+  void searchCell(int cell, const QCPVector2D &p, double &minDistSqr, int &closestSegment) const;
+  int segmentCount() const;
+  bool segment(int index, QPointF &p1, QPointF &p2) const;
+  void segmentCells(const QPointF &p1, const QPointF &p2, QVector<int> &cells) const;
+  int cellColumn(double x) const;
+  int cellRow(double y) const;
+};
+
 /* end of 'src/vector2d.h' */
 
 
@@ -524,6 +590,7 @@ public:
                      ,pmVectorized   = 0x01   ///< <tt>0x01</tt> Mode for vectorized painting (e.g. PDF export). For example, this prevents some antialiasing fixes.
                      ,pmNoCaching    = 0x02   ///< <tt>0x02</tt> Mode for all sorts of exports (e.g. PNG, PDF,...). For example, this prevents using cached pixmap labels
                      ,pmNonCosmetic  = 0x04   ///< <tt>0x04</tt> Turns pen widths 0 to 1, i.e. disables cosmetic pens. (A cosmetic pen is always drawn with width 1 pixel in the vector image/pdf viewer, independent of zoom.)
+                     ,pmSoftwareRasterizer = 0x08 ///< <tt>0x08</tt> Mode for painting on a \ref QCPPaintBufferRasterizer. Antialiased solid polylines and fills of plottables are drawn by \ref QCPRasterizer instead of QPainter.
                    };
   Q_ENUMS(PainterMode)
   Q_FLAGS(PainterModes)
@@ -626,6 +693,37 @@ protected:
 };
 
 
+class QCP_LIB_DECL QCPPaintBufferImage : public QCPAbstractPaintBuffer
+{
+public:
+  explicit QCPPaintBufferImage(const QSize &size, double devicePixelRatio);
+  virtual ~QCPPaintBufferImage() Q_DECL_OVERRIDE;
+  
+  // reimplemented virtual methods:
+  virtual QCPPainter *startPainting() Q_DECL_OVERRIDE;
+  virtual void draw(QCPPainter *painter) const Q_DECL_OVERRIDE;
+  void clear(const QColor &color) Q_DECL_OVERRIDE;
+  
+protected:
+  // non-property members:
+  QImage mBuffer;
+  
+  // reimplemented virtual methods:
+  virtual void reallocateBuffer() Q_DECL_OVERRIDE;
+};
+
+
+class QCP_LIB_DECL QCPPaintBufferRasterizer : public QCPPaintBufferImage
+{
+public:
+  explicit QCPPaintBufferRasterizer(const QSize &size, double devicePixelRatio);
+  virtual ~QCPPaintBufferRasterizer() Q_DECL_OVERRIDE;
+  
+  // reimplemented virtual methods:
+  virtual QCPPainter *startPainting() Q_DECL_OVERRIDE;
+};
+
+
 #ifdef QCP_OPENGL_PBUFFER
 class QCP_LIB_DECL QCPPaintBufferGlPbuffer : public QCPAbstractPaintBuffer
 {
@@ -673,6 +771,114 @@ protected:
 };
 #endif // QCP_OPENGL_FBO
 
+
+class QCP_LIB_DECL QCPTiledRenderer
+{
+public:
+  QCPTiledRenderer(QCPPainter *painter, Qt::Orientation orientation);
+  virtual ~QCPTiledRenderer();
+  
+  // non-virtual methods:
+  void render();
+  static bool canRender(QCPPainter *painter);
+  
+protected:
+  // non-property members:
+  QCPPainter *mPainter;
+  Qt::Orientation mOrientation;
+  double mDevicePixelRatio;
+  QRectF mArea;
+  QTransform mTransform;
+  QVector<QRect> mTileRects;
+  QVector<QImage> mTileImages;
+  QAtomicInt mNextTile;
+  
+  // introduced virtual methods:
+  virtual void drawTile(QCPPainter *painter, const QRectF &tileRect) const = 0;
+  
+  // non-virtual methods:
+  void drawTiles();
+  
+private:
+  Q_DISABLE_COPY(QCPTiledRenderer)
+  
+  friend class QCPTileRenderTask;
+};
+
+
+class QCP_LIB_DECL QCPPolylineTileRenderer : public QCPTiledRenderer
+{
+public:
+  QCPPolylineTileRenderer(QCPPainter *painter, Qt::Orientation orientation, const QVector<QPointF> &lineData, bool fastPolylines);
+  
+protected:
+  // non-property members:
+  const QVector<QPointF> &mLineData;
+  bool mFastPolylines;
+  
+  // reimplemented virtual methods:
+  virtual void drawTile(QCPPainter *painter, const QRectF &tileRect) const Q_DECL_OVERRIDE;
+};
+
+
+class QCP_LIB_DECL QCPImageTileRenderer : public QCPTiledRenderer
+{
+public:
+  QCPImageTileRenderer(QCPPainter *painter, const QRectF &targetRect, const QImage &image);
+  
+protected:
+  // non-property members:
+  QRectF mTargetRect;
+  const QImage &mImage;
+  
+  // reimplemented virtual methods:
+  virtual void drawTile(QCPPainter *painter, const QRectF &tileRect) const Q_DECL_OVERRIDE;
+};
+
+
+class QCP_LIB_DECL QCPRasterizer
+{
+public:
+  // non-virtual methods:
+  static bool canRasterize(QCPPainter *painter);
+  static bool drawPolyline(QCPPainter *painter, const QPointF *points, int pointCount);
+  static bool drawPolygon(QCPPainter *painter, const QPolygonF &polygon);
+  
+protected:
+  struct CoverageBuffer
+  {
+    CoverageBuffer() : smallAreaCount(0) {}
+    QVector<float> cells;
+    int smallAreaCount;
+  };
+  
+  explicit QCPRasterizer(QCPPainter *painter);
+  
+  // non-property members:
+  QImage *mImage;
+  QRect mClipRect;
+  QRect mArea;
+  int mStride;
+  float *mCoverage;
+  QVector<int> mRowBegin, mRowEnd;
+  
+  // non-virtual methods:
+  bool beginArea(const QRectF &bounds);
+  void addLine(const QPointF &p1, const QPointF &p2);
+  void addTriangle(const QPointF &p1, QPointF p2, QPointF p3);
+  void addQuad(const QPointF &start, const QPointF &end, const QPointF &normal);
+  void addStroke(const QPointF *points, int pointCount, double halfWidth, bool extendEnds);
+  void accumulateLine(double x1, double y1, double x2, double y2);
+  void composite(quint32 color, bool oddEven);
+  static bool mapToDevice(const QTransform &transform, const QPointF *points, int pointCount, QVector<QPointF> *devicePoints, QRectF *bounds);
+  static quint32 premultipliedColor(QColor color, double opacity);
+  static quint32 multiplyPixel(quint32 pixel, quint32 alpha);
+  static void compositeSpan(const float *coverage, quint32 *pixels, int count, quint32 color, bool oddEven);
+  
+private:
+  Q_DISABLE_COPY(QCPRasterizer)
+};
+
 /* end of 'src/paintbuffer.h' */
 
 
@@ -721,6 +927,7 @@ public:
   
   // non-virtual methods:
   void replot();
+  void markDirty();
   
 protected:
   // property members:
@@ -745,6 +952,7 @@ private:
   
   friend class QCustomPlot;
   friend class QCPLayerable;
+  friend class QCPPaintBufferRenderTask;
 };
 Q_DECLARE_METATYPE(QCPLayer::LayerMode)
 
@@ -780,6 +988,7 @@ public:
 
   // non-property methods:
   bool realVisibility() const;
+  void markDirty();
   
 signals:
   void layerChanged(QCPLayer *newLayer);
@@ -1589,6 +1798,44 @@ Q_DECLARE_METATYPE(QCPLineEnding::EndingStyle)
 /* including file 'src/axis/labelpainter.h' */
 /* modified 2022-11-06T12:45:56, size 7086  */
 
+class QCP_LIB_DECL QCPLabelCache
+{
+public:
+  /*!
+    Holds a rendered label and the offset of its top left corner relative to the label anchor.
+  */
+  struct Label
+  {
+    QPointF offset;
+    QImage image;
+  };
+  
+  static QCPLabelCache *instance();
+  
+  // getters:
+  int maximumSize() const;
+  
+  // setters:
+  void setMaximumSize(int kilobytes);
+  
+  // non-property methods:
+  bool find(const QByteArray &key, Label *label);
+  void insert(const QByteArray &key, const Label &label);
+  void clear();
+  static QImage createImage(const QSize &size, double devicePixelRatio);
+  
+protected:
+  QCPLabelCache();
+  
+  // non-property members:
+  mutable QMutex mMutex;
+  QCache<QByteArray, Label> mLabels;
+  
+private:
+  Q_DISABLE_COPY(QCPLabelCache)
+};
+
+
 class QCPLabelPainterPrivate
 {
   Q_GADGET
@@ -1639,7 +1886,6 @@ public:
   void setSubstituteExponent(bool enabled);
   void setMultiplicationSymbol(QChar symbol);
   void setAbbreviateDecimalPowers(bool enabled);
-  void setCacheSize(int labelCount);
   
   // getters:
   AnchorMode anchorMode() const { return mAnchorMode; }
@@ -1653,24 +1899,17 @@ public:
   bool substituteExponent() const { return mSubstituteExponent; }
   QChar multiplicationSymbol() const { return mMultiplicationSymbol; }
   bool abbreviateDecimalPowers() const { return mAbbreviateDecimalPowers; }
-  int cacheSize() const;
   
   //virtual int size() const;
   
   // non-property methods: 
   void drawTickLabel(QCPPainter *painter, const QPointF &tickPos, const QString &text);
-  void clearCache();
   
   // constants that may be used with setMultiplicationSymbol:
   static const QChar SymbolDot;
   static const QChar SymbolCross;
   
 protected:
-  struct CachedLabel
-  {
-    QPoint offset;
-    QPixmap pixmap;
-  };
   struct LabelData
   {
     AnchorSide side;
@@ -1698,14 +1937,11 @@ protected:
   bool mAbbreviateDecimalPowers;
   // non-property members:
   QCustomPlot *mParentPlot;
-  QByteArray mLabelParameterHash; // to determine whether mLabelCache needs to be cleared due to changed parameters
-  QCache<QString, CachedLabel> mLabelCache;
   QRect mAxisSelectionBox, mTickLabelsSelectionBox, mLabelSelectionBox;
   int mLetterCapHeight, mLetterDescent;
   
   // introduced virtual methods:
   virtual void drawLabelMaybeCached(QCPPainter *painter, const QFont &font, const QColor &color, const QPointF &pos, AnchorSide side, double rotation, const QString &text);
-  virtual QByteArray generateLabelParameterHash() const; // TODO: get rid of this in favor of invalidation flag upon setters?
 
   // non-virtual methods:
   QPointF getAnchorPos(const QPointF &tickPos);
@@ -1713,8 +1949,8 @@ protected:
   LabelData getTickLabelData(const QFont &font, const QColor &color, double rotation, AnchorSide side, const QString &text) const;
   void applyAnchorTransform(LabelData &labelData) const;
   //void getMaxTickLabelSize(const QFont &font, const QString &text, QSize *tickLabelsSize) const;
-  CachedLabel *createCachedLabel(const LabelData &labelData) const;
-  QByteArray cacheKey(const QString &text, const QColor &color, double rotation, AnchorSide side) const;
+  QCPLabelCache::Label createCachedLabel(const LabelData &labelData) const;
+  QByteArray cacheKey(const QFont &font, const QString &text, const QColor &color, double rotation, AnchorSide side) const;
   AnchorSide skewedAnchorSide(const QPointF &tickPos, double sideExpandHorz, double sideExpandVert) const;
   AnchorSide rotationCorrectedSide(AnchorSide side, double rotation) const;
   void analyzeFontMetrics();
@@ -2047,6 +2283,9 @@ public:
   void setLogBase(double base);
   void setSubTickCount(int subTicks);
   
+  // reimplemented virtual methods:
+  virtual void generate(const QCPRange &range, const QLocale &locale, QChar formatChar, int precision, QVector<double> &ticks, QVector<double> *subTicks, QVector<QString> *tickLabels) Q_DECL_OVERRIDE;
+  
 protected:
   // property members:
   double mLogBase;
@@ -2054,6 +2293,14 @@ protected:
   
   // non-property members:
   double mLogBaseLnInv;
+  bool mTicksCached, mLabelsCached;
+  bool mCachedPositive;
+  int mCachedPowerStep, mCachedFirstPower;
+  QVector<double> mCachedTicks, mCachedSubTicks;
+  QVector<QString> mCachedLabels;
+  QLocale mCachedLocale;
+  QChar mCachedFormatChar;
+  int mCachedPrecision;
   
   // reimplemented virtual methods:
   virtual int getSubTickCount(double tickStep) Q_DECL_OVERRIDE;
@@ -2315,6 +2562,8 @@ public:
   void rescale(bool onlyVisiblePlottables=false);
   double pixelToCoord(double value) const;
   double coordToPixel(double value) const;
+  void coordsToPixels(const double *coords, double *pixels, int count) const;
+  void coordsToPixels(const double *coords, int coordStride, QPointF *pixels, int count) const;
   SelectablePart getPartAt(const QPointF &pos) const;
   QList<QCPAbstractPlottable*> plottables() const;
   QList<QCPGraph*> graphs() const;
@@ -2399,6 +2648,10 @@ protected:
   
   // non-virtual methods:
   void setupTickVectors();
+  void getPixelTransform(double &offset, double &scale, double &logSign, double &invalidPixel) const;
+#ifdef QCP_SSE2
+  static __m128d logPd(__m128d x);
+#endif
   QPen getBasePen() const;
   QPen getTickPen() const;
   QPen getSubTickPen() const;
@@ -2430,7 +2683,6 @@ public:
   
   virtual void draw(QCPPainter *painter);
   virtual int size();
-  void clearCache();
   
   QRect axisSelectionBox() const { return mAxisSelectionBox; }
   QRect tickLabelsSelectionBox() const { return mTickLabelsSelectionBox; }
@@ -2463,11 +2715,6 @@ public:
   QVector<QString> tickLabels;
   
 protected:
-  struct CachedLabel
-  {
-    QPointF offset;
-    QPixmap pixmap;
-  };
   struct TickLabelData
   {
     QString basePart, expPart, suffixPart;
@@ -2475,8 +2722,7 @@ protected:
     QFont baseFont, expFont;
   };
   QCustomPlot *mParentPlot;
-  QByteArray mLabelParameterHash; // to determine whether mLabelCache needs to be cleared due to changed parameters
-  QCache<QString, CachedLabel> mLabelCache;
+  QByteArray mLabelParameterHash; // the part of the label cache keys that is common to all labels of this axis
   QRect mAxisSelectionBox, mTickLabelsSelectionBox, mLabelSelectionBox;
   
   virtual QByteArray generateLabelParameterHash() const;
@@ -2577,6 +2823,7 @@ public:
   void applyTo(QCPPainter *painter, const QPen &defaultPen) const;
   void drawShape(QCPPainter *painter, const QPointF &pos) const;
   void drawShape(QCPPainter *painter, double x, double y) const;
+  void drawShapes(QCPPainter *painter, const QVector<QPointF> &positions) const;
 
 protected:
   // property members:
@@ -2595,6 +2842,38 @@ Q_DECLARE_OPERATORS_FOR_FLAGS(QCPScatterStyle::ScatterProperties)
 Q_DECLARE_METATYPE(QCPScatterStyle::ScatterProperty)
 Q_DECLARE_METATYPE(QCPScatterStyle::ScatterShape)
 
+
+class QCP_LIB_DECL QCPScatterSpriteCache
+{
+public:
+  static QCPScatterSpriteCache *instance();
+  
+  // getters:
+  int maximumSize() const;
+  
+  // setters:
+  void setMaximumSize(int kilobytes);
+  
+  // non-property methods:
+  QVector<QImage> sprites(const QCPScatterStyle &style, const QPen &pen, const QBrush &brush, bool antialiased, double devicePixelRatio, int halfExtent);
+  void clear();
+  
+  static const int phaseCount = 4;
+  
+protected:
+  QCPScatterSpriteCache();
+  
+  // non-property members:
+  mutable QMutex mMutex;
+  QCache<QByteArray, QVector<QImage> > mSprites;
+  
+  // non-virtual methods:
+  QVector<QImage> renderSprites(const QCPScatterStyle &style, const QPen &pen, const QBrush &brush, bool antialiased, double devicePixelRatio, int halfExtent) const;
+  
+private:
+  Q_DISABLE_COPY(QCPScatterSpriteCache)
+};
+
 /* end of 'src/scatterstyle.h' */
 
 
@@ -2617,14 +2896,19 @@ public:
   typedef typename QVector<DataType>::iterator iterator;
   
   QCPDataContainer();
+  QCPDataContainer(const QCPDataContainer<DataType> &other);
+  QCPDataContainer<DataType> &operator=(const QCPDataContainer<DataType> &other);
   
   // getters:
   int size() const { return mData.size()-mPreallocSize; }
   bool isEmpty() const { return size() == 0; }
   bool autoSqueeze() const { return mAutoSqueeze; }
+  bool valueIndexEnabled() const { return mValueIndexEnabled; }
+  quint32 revision() const { return mRevision; }
   
   // setters:
   void setAutoSqueeze(bool enabled);
+  void setValueIndexEnabled(bool enabled);
   
   // non-virtual methods:
   void set(const QCPDataContainer<DataType> &data);
@@ -2642,28 +2926,44 @@ public:
   
   const_iterator constBegin() const { return mData.constBegin()+mPreallocSize; }
   const_iterator constEnd() const { return mData.constEnd(); }
-  iterator begin() { return mData.begin()+mPreallocSize; }
-  iterator end() { return mData.end(); }
+  iterator begin() { mValueIndexValid = false; ++mRevision; return mData.begin()+mPreallocSize; }
+  iterator end() { mValueIndexValid = false; ++mRevision; return mData.end(); }
   const_iterator findBegin(double sortKey, bool expandedRange=true) const;
   const_iterator findEnd(double sortKey, bool expandedRange=true) const;
   const_iterator at(int index) const { return constBegin()+qBound(0, index, size()); }
   QCPRange keyRange(bool &foundRange, QCP::SignDomain signDomain=QCP::sdBoth);
   QCPRange valueRange(bool &foundRange, QCP::SignDomain signDomain=QCP::sdBoth, const QCPRange &inKeyRange=QCPRange());
+  QCPRange valueRange(bool &foundRange, const const_iterator &begin, const const_iterator &end, QCP::SignDomain signDomain=QCP::sdBoth);
   QCPDataRange dataRange() const { return QCPDataRange(0, size()); }
   void limitIteratorsToDataRange(const_iterator &begin, const_iterator &end, const QCPDataRange &dataRange) const;
   
 protected:
   // property members:
   bool mAutoSqueeze;
+  bool mValueIndexEnabled;
   
   // non-property memebers:
   QVector<DataType> mData;
   int mPreallocSize;
   int mPreallocIteration;
+  QVector<QCPRange> mValueIndex[3]; // one min/max segment tree per QCP::SignDomain
+  int mValueIndexLeafCount;
+  int mValueIndexDirtyBegin, mValueIndexDirtyEnd;
+  bool mValueIndexValid;
+  QMutex mValueIndexMutex;
+  quint32 mRevision;
   
   // non-virtual methods:
+  iterator dataBegin() { return mData.begin()+mPreallocSize; }
+  iterator dataEnd() { return mData.end(); }
   void preallocateGrow(int minimumPreallocSize);
   void performAutoSqueeze();
+  void markValueIndexDirty(int indexBegin, int indexEnd);
+  void updateValueIndex();
+  QCPRange indexedValueRange(int indexBegin, int indexEnd, QCP::SignDomain signDomain);
+  static int valueIndexBlockSize() { return 64; }
+  static QCPRange emptyValueIndexRange();
+  static void expandValueIndexRange(QCPRange &range, const QCPRange &current, QCP::SignDomain signDomain);
 };
 
 
@@ -2702,6 +3002,12 @@ protected:
   sort. Failing to do so can not be detected by the container efficiently and will cause both
   rendering artifacts and potential data loss.
 
+  To answer \ref valueRange queries of large containers quickly (e.g. when rescaling axes), the
+  container maintains a min/max index over blocks of data points, see \ref setValueIndexEnabled.
+  The index is updated lazily and incrementally when data is added or removed through the container
+  interface. Obtaining non-const iterators (\ref begin, \ref end) marks the whole index as outdated,
+  since the values may be modified through them.
+
   Implementing one-dimensional plottables that make use of a \ref QCPDataContainer<T> is usually
   done by subclassing from \ref QCPAbstractPlottable1D "QCPAbstractPlottable1D<T>", which
   introduces an according \a mDataContainer member and some convenience methods.
@@ -2805,9 +3111,54 @@ protected:
 template <class DataType>
 QCPDataContainer<DataType>::QCPDataContainer() :
   mAutoSqueeze(true),
+  mValueIndexEnabled(true),
   mPreallocSize(0),
-  mPreallocIteration(0)
+  mPreallocIteration(0),
+  mValueIndexLeafCount(0),
+  mValueIndexDirtyBegin(0),
+  mValueIndexDirtyEnd(0),
+  mValueIndexValid(false),
+  mRevision(0)
+{
+}
+
+/*!
+  Constructs a copy of \a other. The value index isn't copied, it is rebuilt when it is first
+  needed.
+*/
+template <class DataType>
+QCPDataContainer<DataType>::QCPDataContainer(const QCPDataContainer<DataType> &other) :
+  mAutoSqueeze(other.mAutoSqueeze),
+  mValueIndexEnabled(other.mValueIndexEnabled),
+  mData(other.mData),
+  mPreallocSize(other.mPreallocSize),
+  mPreallocIteration(other.mPreallocIteration),
+  mValueIndexLeafCount(0),
+  mValueIndexDirtyBegin(0),
+  mValueIndexDirtyEnd(0),
+  mValueIndexValid(false),
+  mRevision(0)
+{
+}
+
+/*!
+  Copies the data points and settings of \a other into this container. The value index of this
+  container is invalidated and rebuilt when it is next needed.
+*/
+template <class DataType>
+QCPDataContainer<DataType> &QCPDataContainer<DataType>::operator=(const QCPDataContainer<DataType> &other)
 {
+  if (&other != this)
+  {
+    mAutoSqueeze = other.mAutoSqueeze;
+    mValueIndexEnabled = other.mValueIndexEnabled;
+    mData = other.mData;
+    mPreallocSize = other.mPreallocSize;
+    mPreallocIteration = other.mPreallocIteration;
+    mValueIndexValid = false;
+    ++mRevision;
+  }
+  return *this;
 }
 
 /*!
@@ -2829,6 +3180,34 @@ void QCPDataContainer<DataType>::setAutoSqueeze(bool enabled)
   }
 }
 
+/*!
+  Sets whether the container maintains a min/max index of the data point values, which allows \ref
+  valueRange to find the value range of an arbitrary key interval in O(log n) instead of scanning
+  all data points in the interval. By default this is enabled.
+
+  The index consists of the value ranges of blocks of consecutive data points, aggregated in a
+  segment tree. It is built the first time it is needed, and afterwards only the blocks touched by
+  \ref add and \ref remove operations are recalculated. Small key intervals are always scanned
+  directly, so the index is only built for large data sets.
+
+  Disabling the index releases its memory.
+*/
+template <class DataType>
+void QCPDataContainer<DataType>::setValueIndexEnabled(bool enabled)
+{
+  if (mValueIndexEnabled != enabled)
+  {
+    mValueIndexEnabled = enabled;
+    mValueIndexValid = false;
+    if (!mValueIndexEnabled)
+    {
+      for (int i=0; i<3; ++i)
+        mValueIndex[i] = QVector<QCPRange>();
+      mValueIndexLeafCount = 0;
+    }
+  }
+}
+
 /*! \overload
   
   Replaces the current data in this container with the provided \a data.
@@ -2857,6 +3236,8 @@ void QCPDataContainer<DataType>::set(const QVector<DataType> &data, bool already
   mData = data;
   mPreallocSize = 0;
   mPreallocIteration = 0;
+  mValueIndexValid = false;
+  ++mRevision;
   if (!alreadySorted)
     sort();
 }
@@ -2881,13 +3262,20 @@ void QCPDataContainer<DataType>::add(const QCPDataContainer<DataType> &data)
     if (mPreallocSize < n)
       preallocateGrow(n);
     mPreallocSize -= n;
-    std::copy(data.constBegin(), data.constEnd(), begin());
+    std::copy(data.constBegin(), data.constEnd(), dataBegin());
+    markValueIndexDirty(mPreallocSize, mPreallocSize+n);
   } else // don't need to prepend, so append and merge if necessary
   {
     mData.resize(mData.size()+n);
-    std::copy(data.constBegin(), data.constEnd(), end()-n);
+    std::copy(data.constBegin(), data.constEnd(), dataEnd()-n);
+    int changedBegin = int(mData.size())-n;
     if (oldSize > 0 && !qcpLessThanSortKey<DataType>(*(constEnd()-n-1), *(constEnd()-n))) // if appended range keys aren't all greater than existing ones, merge the two partitions
-      std::inplace_merge(begin(), end()-n, end(), qcpLessThanSortKey<DataType>);
+    {
+      iterator mergeBegin = std::upper_bound(dataBegin(), dataEnd()-n, *(dataEnd()-n), qcpLessThanSortKey<DataType>); // existing data before this point stays in place
+      changedBegin = int(mergeBegin-mData.begin());
+      std::inplace_merge(mergeBegin, dataEnd()-n, dataEnd(), qcpLessThanSortKey<DataType>);
+    }
+    markValueIndexDirty(changedBegin, int(mData.size()));
   }
 }
 
@@ -2918,15 +3306,22 @@ void QCPDataContainer<DataType>::add(const QVector<DataType> &data, bool already
     if (mPreallocSize < n)
       preallocateGrow(n);
     mPreallocSize -= n;
-    std::copy(data.constBegin(), data.constEnd(), begin());
+    std::copy(data.constBegin(), data.constEnd(), dataBegin());
+    markValueIndexDirty(mPreallocSize, mPreallocSize+n);
   } else // don't need to prepend, so append and then sort and merge if necessary
   {
     mData.resize(mData.size()+n);
-    std::copy(data.constBegin(), data.constEnd(), end()-n);
+    std::copy(data.constBegin(), data.constEnd(), dataEnd()-n);
     if (!alreadySorted) // sort appended subrange if it wasn't already sorted
-      std::sort(end()-n, end(), qcpLessThanSortKey<DataType>);
+      std::sort(dataEnd()-n, dataEnd(), qcpLessThanSortKey<DataType>);
+    int changedBegin = int(mData.size())-n;
     if (oldSize > 0 && !qcpLessThanSortKey<DataType>(*(constEnd()-n-1), *(constEnd()-n))) // if appended range keys aren't all greater than existing ones, merge the two partitions
-      std::inplace_merge(begin(), end()-n, end(), qcpLessThanSortKey<DataType>);
+    {
+      iterator mergeBegin = std::upper_bound(dataBegin(), dataEnd()-n, *(dataEnd()-n), qcpLessThanSortKey<DataType>); // existing data before this point stays in place
+      changedBegin = int(mergeBegin-mData.begin());
+      std::inplace_merge(mergeBegin, dataEnd()-n, dataEnd(), qcpLessThanSortKey<DataType>);
+    }
+    markValueIndexDirty(changedBegin, int(mData.size()));
   }
 }
 
@@ -2942,16 +3337,20 @@ void QCPDataContainer<DataType>::add(const DataType &data)
   if (isEmpty() || !qcpLessThanSortKey<DataType>(data, *(constEnd()-1))) // quickly handle appends if new data key is greater or equal to existing ones
   {
     mData.append(data);
+    markValueIndexDirty(int(mData.size())-1, int(mData.size()));
   } else if (qcpLessThanSortKey<DataType>(data, *constBegin()))  // quickly handle prepends using preallocated space
   {
     if (mPreallocSize < 1)
       preallocateGrow(1);
     --mPreallocSize;
-    *begin() = data;
+    *dataBegin() = data;
+    markValueIndexDirty(mPreallocSize, mPreallocSize+1);
   } else // handle inserts, maintaining sorted keys
   {
-    QCPDataContainer<DataType>::iterator insertionPoint = std::lower_bound(begin(), end(), data, qcpLessThanSortKey<DataType>);
+    QCPDataContainer<DataType>::iterator insertionPoint = std::lower_bound(dataBegin(), dataEnd(), data, qcpLessThanSortKey<DataType>);
+    const int insertionIndex = int(insertionPoint-mData.begin());
     mData.insert(insertionPoint, data);
+    markValueIndexDirty(insertionIndex, int(mData.size()));
   }
 }
 
@@ -2963,9 +3362,10 @@ void QCPDataContainer<DataType>::add(const DataType &data)
 template <class DataType>
 void QCPDataContainer<DataType>::removeBefore(double sortKey)
 {
-  QCPDataContainer<DataType>::iterator it = begin();
-  QCPDataContainer<DataType>::iterator itEnd = std::lower_bound(begin(), end(), DataType::fromSortKey(sortKey), qcpLessThanSortKey<DataType>);
-  mPreallocSize += int(itEnd-it); // don't actually delete, just add it to the preallocated block (if it gets too large, squeeze will take care of it)
+  QCPDataContainer<DataType>::iterator it = dataBegin();
+  QCPDataContainer<DataType>::iterator itEnd = std::lower_bound(dataBegin(), dataEnd(), DataType::fromSortKey(sortKey), qcpLessThanSortKey<DataType>);
+  mPreallocSize += int(itEnd-it); // don't actually delete, just add it to the preallocated block (if it gets too large, squeeze will take care of it). The value index stays valid, since no data point moves
+  ++mRevision;
   if (mAutoSqueeze)
     performAutoSqueeze();
 }
@@ -2978,8 +3378,9 @@ void QCPDataContainer<DataType>::removeBefore(double sortKey)
 template <class DataType>
 void QCPDataContainer<DataType>::removeAfter(double sortKey)
 {
-  QCPDataContainer<DataType>::iterator it = std::upper_bound(begin(), end(), DataType::fromSortKey(sortKey), qcpLessThanSortKey<DataType>);
-  QCPDataContainer<DataType>::iterator itEnd = end();
+  QCPDataContainer<DataType>::iterator it = std::upper_bound(dataBegin(), dataEnd(), DataType::fromSortKey(sortKey), qcpLessThanSortKey<DataType>);
+  QCPDataContainer<DataType>::iterator itEnd = dataEnd();
+  markValueIndexDirty(int(it-mData.begin()), int(mData.size()));
   mData.erase(it, itEnd); // typically adds it to the postallocated block
   if (mAutoSqueeze)
     performAutoSqueeze();
@@ -2998,8 +3399,10 @@ void QCPDataContainer<DataType>::remove(double sortKeyFrom, double sortKeyTo)
   if (sortKeyFrom >= sortKeyTo || isEmpty())
     return;
   
-  QCPDataContainer<DataType>::iterator it = std::lower_bound(begin(), end(), DataType::fromSortKey(sortKeyFrom), qcpLessThanSortKey<DataType>);
-  QCPDataContainer<DataType>::iterator itEnd = std::upper_bound(it, end(), DataType::fromSortKey(sortKeyTo), qcpLessThanSortKey<DataType>);
+  QCPDataContainer<DataType>::iterator it = std::lower_bound(dataBegin(), dataEnd(), DataType::fromSortKey(sortKeyFrom), qcpLessThanSortKey<DataType>);
+  QCPDataContainer<DataType>::iterator itEnd = std::upper_bound(it, dataEnd(), DataType::fromSortKey(sortKeyTo), qcpLessThanSortKey<DataType>);
+  if (it != itEnd)
+    markValueIndexDirty(int(it-mData.begin()), int(mData.size()));
   mData.erase(it, itEnd);
   if (mAutoSqueeze)
     performAutoSqueeze();
@@ -3017,13 +3420,18 @@ void QCPDataContainer<DataType>::remove(double sortKeyFrom, double sortKeyTo)
 template <class DataType>
 void QCPDataContainer<DataType>::remove(double sortKey)
 {
-  QCPDataContainer::iterator it = std::lower_bound(begin(), end(), DataType::fromSortKey(sortKey), qcpLessThanSortKey<DataType>);
-  if (it != end() && it->sortKey() == sortKey)
+  QCPDataContainer::iterator it = std::lower_bound(dataBegin(), dataEnd(), DataType::fromSortKey(sortKey), qcpLessThanSortKey<DataType>);
+  if (it != dataEnd() && it->sortKey() == sortKey)
   {
-    if (it == begin())
+    if (it == dataBegin())
+    {
       ++mPreallocSize; // don't actually delete, just add it to the preallocated block (if it gets too large, squeeze will take care of it)
-    else
+      ++mRevision;
+    } else
+    {
+      markValueIndexDirty(int(it-mData.begin()), int(mData.size()));
       mData.erase(it);
+    }
   }
   if (mAutoSqueeze)
     performAutoSqueeze();
@@ -3040,6 +3448,8 @@ void QCPDataContainer<DataType>::clear()
   mData.clear();
   mPreallocIteration = 0;
   mPreallocSize = 0;
+  mValueIndexValid = false;
+  ++mRevision;
 }
 
 /*!
@@ -3056,7 +3466,9 @@ void QCPDataContainer<DataType>::clear()
 template <class DataType>
 void QCPDataContainer<DataType>::sort()
 {
-  std::sort(begin(), end(), qcpLessThanSortKey<DataType>);
+  std::sort(dataBegin(), dataEnd(), qcpLessThanSortKey<DataType>);
+  mValueIndexValid = false;
+  ++mRevision;
 }
 
 /*!
@@ -3076,9 +3488,10 @@ void QCPDataContainer<DataType>::squeeze(bool preAllocation, bool postAllocation
   {
     if (mPreallocSize > 0)
     {
-      std::copy(begin(), end(), mData.begin());
+      std::copy(dataBegin(), dataEnd(), mData.begin());
       mData.resize(size());
       mPreallocSize = 0;
+      mValueIndexValid = false;
     }
     mPreallocIteration = 0;
   }
@@ -3278,6 +3691,9 @@ QCPRange QCPDataContainer<DataType>::keyRange(bool &foundRange, QCP::SignDomain
   relevant e.g. for logarithmic plots which can mathematically only display one sign domain at a
   time.
 
+  For large data sets, the range is determined with the min/max index (see \ref
+  setValueIndexEnabled) in logarithmic time.
+
   \see keyRange
 */
 template <class DataType>
@@ -3300,6 +3716,8 @@ QCPRange QCPDataContainer<DataType>::valueRange(bool &foundRange, QCP::SignDomai
     itBegin = findBegin(inKeyRange.lower, false);
     itEnd = findEnd(inKeyRange.upper, false);
   }
+  if (mValueIndexEnabled && (DataType::sortKeyIsMainKey() || !restrictKeyRange)) // interval of consecutive data points, may use min/max index
+    return valueRange(foundRange, itBegin, itEnd, signDomain);
   if (signDomain == QCP::sdBoth) // range may be anywhere
   {
     for (QCPDataContainer<DataType>::const_iterator it = itBegin; it != itEnd; ++it)
@@ -3360,6 +3778,41 @@ QCPRange QCPDataContainer<DataType>::valueRange(bool &foundRange, QCP::SignDomai
   return range;
 }
 
+/*! \overload
+
+  Returns the range encompassed by the value coordinates of the data points from \a begin up to
+  (but not including) \a end. The same rules as for the key range based \ref valueRange apply to
+  \a foundRange, \a signDomain and infinite values.
+
+  If \ref setValueIndexEnabled is true and the interval is large, the range is determined with the
+  min/max index in logarithmic time. Plottables can use this to reduce many data points to their
+  value span without visiting each one, e.g. \ref QCPGraph does this for each pixel column when
+  adaptive sampling is enabled.
+*/
+template <class DataType>
+QCPRange QCPDataContainer<DataType>::valueRange(bool &foundRange, const const_iterator &begin, const const_iterator &end, QCP::SignDomain signDomain)
+{
+  QCPRange extent;
+  if (mValueIndexEnabled && end-begin >= 4*valueIndexBlockSize())
+  {
+    extent = indexedValueRange(int(begin-mData.constBegin()), int(end-mData.constBegin()), signDomain);
+  } else
+  {
+    extent = emptyValueIndexRange();
+    for (const_iterator it = begin; it != end; ++it)
+      expandValueIndexRange(extent, it->valueRange(), signDomain);
+  }
+  QCPRange range;
+  const bool haveLower = std::isfinite(extent.lower);
+  const bool haveUpper = std::isfinite(extent.upper);
+  if (haveLower)
+    range.lower = extent.lower;
+  if (haveUpper)
+    range.upper = extent.upper;
+  foundRange = haveLower && haveUpper;
+  return range;
+}
+
 /*!
   Makes sure \a begin and \a end mark a data range that is both within the bounds of this data
   container's data, as well as within the specified \a dataRange. The initial range described by
@@ -3400,6 +3853,7 @@ void QCPDataContainer<DataType>::preallocateGrow(int minimumPreallocSize)
   mData.resize(mData.size()+sizeDifference);
   std::copy_backward(mData.begin()+mPreallocSize, mData.end()-sizeDifference, mData.end());
   mPreallocSize = newPreallocSize;
+  mValueIndexValid = false; // all data points moved
 }
 
 /*! \internal
@@ -3438,6 +3892,188 @@ void QCPDataContainer<DataType>::performAutoSqueeze()
     squeeze(shrinkPreAllocation, shrinkPostAllocation);
 }
 
+/*! \internal
+
+  Marks the blocks of the value index that contain the data points with (internal, i.e. including
+  the preallocation) indices from \a indexBegin to \a indexEnd as outdated. They are recalculated the
+  next time the index is used (see \ref updateValueIndex).
+
+  \a indexEnd may exceed the current size of the data, e.g. to mark data points as outdated that
+  were removed from the end.
+*/
+template <class DataType>
+void QCPDataContainer<DataType>::markValueIndexDirty(int indexBegin, int indexEnd)
+{
+  ++mRevision;
+  if (!mValueIndexValid || indexBegin >= indexEnd)
+    return;
+  const int blockBegin = indexBegin/valueIndexBlockSize();
+  const int blockEnd = (indexEnd+valueIndexBlockSize()-1)/valueIndexBlockSize();
+  if (mValueIndexDirtyBegin >= mValueIndexDirtyEnd) // nothing dirty yet
+  {
+    mValueIndexDirtyBegin = blockBegin;
+    mValueIndexDirtyEnd = blockEnd;
+  } else
+  {
+    mValueIndexDirtyBegin = qMin(mValueIndexDirtyBegin, blockBegin);
+    mValueIndexDirtyEnd = qMax(mValueIndexDirtyEnd, blockEnd);
+  }
+}
+
+/*! \internal
+
+  Brings the value index up to date. If the index is invalid or the data has grown beyond the
+  capacity of the segment trees, the index is rebuilt completely. Otherwise only the blocks marked
+  by \ref markValueIndexDirty and their ancestors in the segment trees are recalculated.
+
+  The blocks are aligned to the internal data indices (including the preallocation), such that
+  removing data points from the front with \ref removeBefore doesn't affect the index. Blocks may
+  thus contain stale data points of the preallocation, which is why \ref indexedValueRange only
+  uses the block summaries of blocks that lie completely inside the queried data range.
+*/
+template <class DataType>
+void QCPDataContainer<DataType>::updateValueIndex()
+{
+  const int blockSize = valueIndexBlockSize();
+  const int blockCount = (int(mData.size())+blockSize-1)/blockSize;
+  if (!mValueIndexValid || blockCount > mValueIndexLeafCount)
+  {
+    mValueIndexLeafCount = 1;
+    while (mValueIndexLeafCount < blockCount)
+      mValueIndexLeafCount *= 2;
+    for (int i=0; i<3; ++i)
+      mValueIndex[i].fill(emptyValueIndexRange(), 2*mValueIndexLeafCount);
+    mValueIndexDirtyBegin = 0;
+    mValueIndexDirtyEnd = blockCount;
+    mValueIndexValid = true;
+  }
+  if (mValueIndexDirtyBegin >= mValueIndexDirtyEnd)
+    return;
+  
+  // recalculate dirty leaves (blocks beyond the data become empty):
+  mValueIndexDirtyEnd = qMin(mValueIndexDirtyEnd, mValueIndexLeafCount);
+  for (int block=mValueIndexDirtyBegin; block<mValueIndexDirtyEnd; ++block)
+  {
+    QCPRange blockRange[3] = {emptyValueIndexRange(), emptyValueIndexRange(), emptyValueIndexRange()};
+    const int pointEnd = qMin((block+1)*blockSize, int(mData.size()));
+    for (int i=block*blockSize; i<pointEnd; ++i)
+    {
+      const QCPRange current = mData.at(i).valueRange();
+      expandValueIndexRange(blockRange[QCP::sdNegative], current, QCP::sdNegative);
+      expandValueIndexRange(blockRange[QCP::sdBoth], current, QCP::sdBoth);
+      expandValueIndexRange(blockRange[QCP::sdPositive], current, QCP::sdPositive);
+    }
+    for (int d=0; d<3; ++d)
+      mValueIndex[d][mValueIndexLeafCount+block] = blockRange[d];
+  }
+  
+  // propagate changes to the ancestors, level by level:
+  int lower = (mValueIndexLeafCount+mValueIndexDirtyBegin)/2;
+  int upper = (mValueIndexLeafCount+mValueIndexDirtyEnd-1)/2;
+  while (lower > 0)
+  {
+    for (int node=lower; node<=upper; ++node)
+    {
+      for (int d=0; d<3; ++d)
+      {
+        const QCPRange &left = mValueIndex[d].at(2*node);
+        const QCPRange &right = mValueIndex[d].at(2*node+1);
+        QCPRange &parent = mValueIndex[d][node];
+        parent.lower = qMin(left.lower, right.lower);
+        parent.upper = qMax(left.upper, right.upper);
+      }
+    }
+    lower /= 2;
+    upper /= 2;
+  }
+  mValueIndexDirtyBegin = 0;
+  mValueIndexDirtyEnd = 0;
+}
+
+/*! \internal
+
+  Returns the value range of the data points with internal indices (including the preallocation)
+  from \a indexBegin to \a indexEnd. The partial blocks at the borders of the interval are scanned
+  directly, the range of the blocks in between is taken from the segment tree in O(log n).
+
+  Bounds for which no value was found are left infinite, see \ref emptyValueIndexRange.
+
+  Since this is reached from const drawing code, several paint buffers that are drawn concurrently
+  (see \ref QCP::phParallelLayers) may query the same container at once. The lazy update of the
+  index and the query itself are therefore serialized with a mutex.
+*/
+template <class DataType>
+QCPRange QCPDataContainer<DataType>::indexedValueRange(int indexBegin, int indexEnd, QCP::SignDomain signDomain)
+{
+  QMutexLocker locker(&mValueIndexMutex);
+  updateValueIndex();
+  const int blockSize = valueIndexBlockSize();
+  const int blockBegin = (indexBegin+blockSize-1)/blockSize;
+  const int blockEnd = indexEnd/blockSize;
+  QCPRange range = emptyValueIndexRange();
+  
+  // scan partial blocks at the borders:
+  const int headEnd = qMin(blockBegin*blockSize, indexEnd);
+  for (int i=indexBegin; i<headEnd; ++i)
+    expandValueIndexRange(range, mData.at(i).valueRange(), signDomain);
+  for (int i=qMax(blockEnd*blockSize, headEnd); i<indexEnd; ++i)
+    expandValueIndexRange(range, mData.at(i).valueRange(), signDomain);
+  
+  // combine complete blocks from segment tree:
+  const QVector<QCPRange> &tree = mValueIndex[signDomain];
+  int left = blockBegin+mValueIndexLeafCount;
+  int right = blockEnd+mValueIndexLeafCount;
+  while (left < right)
+  {
+    if (left & 1)
+    {
+      range.lower = qMin(range.lower, tree.at(left).lower);
+      range.upper = qMax(range.upper, tree.at(left).upper);
+      ++left;
+    }
+    if (right & 1)
+    {
+      --right;
+      range.lower = qMin(range.lower, tree.at(right).lower);
+      range.upper = qMax(range.upper, tree.at(right).upper);
+    }
+    left /= 2;
+    right /= 2;
+  }
+  return range;
+}
+
+/*! \internal
+
+  Returns the neutral element of the value index, a range with lower bound +Inf and upper bound
+  -Inf. It is created directly, since the QCPRange constructor would normalize it.
+*/
+template <class DataType>
+QCPRange QCPDataContainer<DataType>::emptyValueIndexRange()
+{
+  QCPRange result;
+  result.lower = std::numeric_limits<double>::infinity();
+  result.upper = -std::numeric_limits<double>::infinity();
+  return result;
+}
+
+/*! \internal
+
+  Expands \a range by the value range \a current of one data point, with the same rules as \ref
+  valueRange: NaN and infinite values are ignored, and the lower and upper bound are only considered
+  if they lie in the given \a signDomain.
+*/
+template <class DataType>
+void QCPDataContainer<DataType>::expandValueIndexRange(QCPRange &range, const QCPRange &current, QCP::SignDomain signDomain)
+{
+  if (current.lower < range.lower && std::isfinite(current.lower) &&
+      (signDomain == QCP::sdBoth || (signDomain == QCP::sdNegative && current.lower < 0) || (signDomain == QCP::sdPositive && current.lower > 0)))
+    range.lower = current.lower;
+  if (current.upper > range.upper && std::isfinite(current.upper) &&
+      (signDomain == QCP::sdBoth || (signDomain == QCP::sdNegative && current.upper < 0) || (signDomain == QCP::sdPositive && current.upper > 0)))
+    range.upper = current.upper;
+}
+
 
 /* end of 'src/datacontainer.h' */
 
@@ -3580,12 +4216,18 @@ protected:
   virtual void selectEvent(QMouseEvent *event, bool additive, const QVariant &details, bool *selectionStateChanged) Q_DECL_OVERRIDE;
   virtual void deselectEvent(bool *selectionStateChanged) Q_DECL_OVERRIDE;
   
+  // non-property members:
+  quint32 mDrawnDataRevision;
+  
   // introduced virtual methods:
   virtual void drawLegendIcon(QCPPainter *painter, const QRectF &rect) const = 0;
+  virtual quint32 dataRevision() const;
   
   // non-virtual methods:
   void applyFillAntialiasingHint(QCPPainter *painter) const;
   void applyScattersAntialiasingHint(QCPPainter *painter) const;
+  void markStyleDirty();
+  QVector<double> hitTestSignature() const;
 
 private:
   Q_DISABLE_COPY(QCPAbstractPlottable)
@@ -3593,6 +4235,7 @@ private:
   friend class QCustomPlot;
   friend class QCPAxis;
   friend class QCPPlottableLegendItem;
+  friend class QCPErrorBars;
 };
 
 
@@ -3787,6 +4430,83 @@ private:
 /* including file 'src/core.h'              */
 /* modified 2022-11-06T12:45:56, size 19304 */
 
+class QCP_LIB_DECL QCPReplotProfiler
+{
+public:
+  /*!
+    Defines the phases of \ref QCustomPlot::replot that are timed by the profiler.
+  */
+  enum Phase { ppMergeDataQueues   ///< Merging the data queues of graphs (\ref QCPGraph::setDataQueue)
+               ,ppUpdateLayout     ///< Updating the layout, including the tick generation of the axes, and finding changed paint buffers for incremental replots
+               ,ppSetupPaintBuffers ///< Assigning layers to paint buffers and clearing them
+               ,ppDrawLayers       ///< Drawing the layers into their paint buffers
+               ,ppRefresh          ///< Requesting the widget update, or repainting it immediately (see \ref QCustomPlot::RefreshPriority)
+             };
+  
+  /*!
+    Holds the time a layerable took to draw during the last replot.
+  */
+  struct LayerableTiming
+  {
+    QPointer<QCPLayerable> layerable; ///< the layerable, becomes \c nullptr if the layerable was deleted since the replot
+    QString layer;                    ///< the name of the layer the layerable was drawn on
+    double drawTime;                  ///< the time of the draw call in milliseconds
+    double dataTime;                  ///< the part of \a drawTime spent preparing the data, e.g. extracting and reducing the line points of a graph
+  };
+  
+  explicit QCPReplotProfiler(QCustomPlot *parentPlot);
+  
+  // getters:
+  bool overlayVisible() const { return mOverlayVisible; }
+  
+  // setters:
+  void setOverlayVisible(bool visible);
+  
+  // non-property methods:
+  double phaseTime(Phase phase, bool average=false) const;
+  double totalTime(bool average=false) const;
+  QMap<QString, double> layerTimes() const;
+  QList<LayerableTiming> layerableTimings() const;
+  int labelCacheHits() const { return mLabelCacheHits.loadAcquire(); }
+  int labelCacheMisses() const { return mLabelCacheMisses.loadAcquire(); }
+  QString summary(int maxLayerables=5) const;
+  void addDataTime(const QCPLayerable *layerable, double milliseconds);
+  void addLabelCacheLookup(bool hit);
+  
+protected:
+  // property members:
+  bool mOverlayVisible;
+  
+  // non-property members:
+  QCustomPlot *mParentPlot;
+  bool mRecording;
+  QElapsedTimer mPhaseTimer;
+  double mPhaseTimes[ppRefresh+1];
+  double mPhaseTimeAverages[ppRefresh+1];
+  QMap<QString, double> mLayerTimes;
+  QList<LayerableTiming> mLayerableTimings;
+  QHash<const QCPLayerable*, int> mLayerableIndices;
+  QAtomicInt mLabelCacheHits, mLabelCacheMisses;
+  mutable QMutex mMutex;
+  
+  // non-virtual methods:
+  void beginReplot();
+  void startPhase();
+  void endPhase(Phase phase);
+  void endReplot();
+  void addDrawTime(QCPLayerable *layerable, const QCPLayer *layer, double milliseconds);
+  int layerableIndex(const QCPLayerable *layerable);
+  void drawOverlay(QCPPainter *painter) const;
+  static bool greaterDrawTime(const LayerableTiming &a, const LayerableTiming &b);
+  
+private:
+  Q_DISABLE_COPY(QCPReplotProfiler)
+  
+  friend class QCustomPlot;
+  friend class QCPLayer;
+};
+
+
 class QCP_LIB_DECL QCustomPlot : public QWidget
 {
   Q_OBJECT
@@ -3846,6 +4566,9 @@ public:
   QCP::SelectionRectMode selectionRectMode() const { return mSelectionRectMode; }
   QCPSelectionRect *selectionRect() const { return mSelectionRect; }
   bool openGl() const { return mOpenGl; }
+  bool softwareRasterizer() const { return mSoftwareRasterizer; }
+  bool profiling() const { return mProfiler; }
+  QCPReplotProfiler *profiler() const { return mProfiler; }
   
   // setters:
   void setViewport(const QRect &rect);
@@ -3870,6 +4593,8 @@ public:
   void setSelectionRectMode(QCP::SelectionRectMode mode);
   void setSelectionRect(QCPSelectionRect *selectionRect);
   void setOpenGl(bool enabled, int multisampling=16);
+  void setSoftwareRasterizer(bool enabled);
+  void setProfiling(bool enabled);
   
   // non-property methods:
   // plottable interface:
@@ -3990,6 +4715,8 @@ protected:
   QCP::SelectionRectMode mSelectionRectMode;
   QCPSelectionRect *mSelectionRect;
   bool mOpenGl;
+  bool mSoftwareRasterizer;
+  QCPReplotProfiler *mProfiler;
   
   // non-property members:
   QList<QSharedPointer<QCPAbstractPaintBuffer> > mPaintBuffers;
@@ -4002,9 +4729,9 @@ protected:
   bool mReplotting;
   bool mReplotQueued;
   double mReplotTime, mReplotTimeAverage;
+  QVector<double> mDrawnGeometry;
   int mOpenGlMultisamples;
   QCP::AntialiasedElements mOpenGlAntialiasedElementsBackup;
-  bool mOpenGlCacheLabelsBackup;
 #ifdef QCP_OPENGL_FBO
   QSharedPointer<QOpenGLContext> mGlContext;
   QSharedPointer<QSurface> mGlSurface;
@@ -4040,8 +4767,10 @@ protected:
   QList<QCPLayerable*> layerableListAt(const QPointF &pos, bool onlySelectable, QList<QVariant> *selectionDetails=nullptr) const;
   void drawBackground(QCPPainter *painter);
   void setupPaintBuffers();
+  void invalidateChangedPaintBuffers();
+  void drawToPaintBuffers();
   QCPAbstractPaintBuffer *createPaintBuffer();
-  bool hasInvalidatedPaintBuffers();
+  bool hasInvalidatedPaintBuffers(const QSharedPointer<QCPAbstractPaintBuffer> &ignoredBuffer=QSharedPointer<QCPAbstractPaintBuffer>());
   bool setupOpenGl();
   void freeOpenGl();
   
@@ -4203,6 +4932,9 @@ protected:
   // property members:
   QSharedPointer<QCPDataContainer<DataType> > mDataContainer;
   
+  // reimplemented virtual methods:
+  virtual quint32 dataRevision() const Q_DECL_OVERRIDE;
+  
   // helpers for subclasses:
   void getDataSegments(QList<QCPDataRange> &selectedSegments, QList<QCPDataRange> &unselectedSegments) const;
   void drawPolyline(QCPPainter *painter, const QVector<QPointF> &lineData) const;
@@ -4582,6 +5314,16 @@ int QCPAbstractPlottable1D<DataType>::findEnd(double sortKey, bool expandedRange
   return int(mDataContainer->findEnd(sortKey, expandedRange)-mDataContainer->constBegin());
 }
 
+/*! \internal
+  
+  Returns the revision of the data container, see \ref QCPDataContainer::revision.
+*/
+template <class DataType>
+quint32 QCPAbstractPlottable1D<DataType>::dataRevision() const
+{
+  return mDataContainer->revision();
+}
+
 /*!
   Implements a point-selection algorithm assuming the data (accessed via the 1D data interface) is
   point-like. Most subclasses will want to reimplement this method again, to provide a more
@@ -4698,6 +5440,23 @@ void QCPAbstractPlottable1D<DataType>::drawPolyline(QCPPainter *painter, const Q
     newPen.setWidth(0);
     painter->setPen(newPen);
   }
+  
+  // draw antialiased solid lines directly into the paint buffer, if the software rasterizer is enabled:
+  if (QCPRasterizer::drawPolyline(painter, lineData.constData(), lineData.size()))
+    return;
+  
+  // rasterize long solid lines in tiles on multiple threads (dashes would restart in each tile):
+  const int tiledRenderingMinimumSize = 20000;
+  if (mParentPlot->plottingHints().testFlag(QCP::phTiledRendering) &&
+      lineData.size() >= tiledRenderingMinimumSize &&
+      painter->pen().style() == Qt::SolidLine &&
+      QCPTiledRenderer::canRender(painter))
+  {
+    const bool fastPolylines = mParentPlot->plottingHints().testFlag(QCP::phFastPolylines) && !painter->modes().testFlag(QCPPainter::pmNoCaching);
+    QCPPolylineTileRenderer renderer(painter, mKeyAxis ? mKeyAxis.data()->orientation() : Qt::Horizontal, lineData, fastPolylines);
+    renderer.render();
+    return;
+  }
 
   // if drawing solid line and not in PDF, use much faster line drawing instead of polyline:
   if (mParentPlot->plottingHints().testFlag(QCP::phFastPolylines) &&
@@ -4837,10 +5596,17 @@ protected:
   // non-property members:
   QVector<QRgb> mColorBuffer; // have colors premultiplied with alpha (for usage with QImage::Format_ARGB32_Premultiplied)
   bool mColorBufferInvalidated;
+  QCPRange mLogLookupRange;
+  int mLogLookupLevelCount, mLogLookupShift;
+  quint64 mLogLookupBase;
+  QVector<int> mLogLookupLevels;
+  QVector<double> mLogLookupThresholds;
   
   // non-virtual methods:
   bool stopsUseAlpha() const;
   void updateColorBuffer();
+  void updateLogLookup(const QCPRange &range);
+  bool colorizeClamped(const double *data, const QCPRange &range, QRgb *scanLine, int n, int dataIndexFactor, bool logarithmic);
 };
 Q_DECLARE_METATYPE(QCPColorGradient::ColorInterpolation)
 Q_DECLARE_METATYPE(QCPColorGradient::NanHandling)
@@ -5491,6 +6257,106 @@ Q_DECLARE_TYPEINFO(QCPGraphData, Q_PRIMITIVE_TYPE);
 */
 typedef QCPDataContainer<QCPGraphData> QCPGraphDataContainer;
 
+class QCP_LIB_DECL QCPGraphDataColumns
+{
+public:
+  QCPGraphDataColumns();
+  
+  // getters:
+  int size() const { return mSize; }
+  bool isEmpty() const { return mSize == 0; }
+  bool isExternal() const { return mExternal; }
+  int capacity() const { return mCapacity; }
+  quint32 revision() const { return mRevision; }
+  const double *keys() const { return mKeyData; }
+  const double *values() const { return mValueData; }
+  double key(int index) const { return mKeyData[index]; }
+  double value(int index) const { return mValueData[index]; }
+  QCPGraphData at(int index) const { return QCPGraphData(mKeyData[index], mValueData[index]); }
+  
+  // setters:
+  void setCapacity(int capacity);
+  
+  // non-property methods:
+  void set(const QVector<double> &keys, const QVector<double> &values, bool alreadySorted=false);
+  void setRawData(const double *keys, const double *values, int size);
+  void add(const QVector<double> &keys, const QVector<double> &values, bool alreadySorted=false);
+  void add(double key, double value);
+  void clear();
+  int findBegin(double sortKey, bool expandedRange=true) const;
+  int findEnd(double sortKey, bool expandedRange=true) const;
+  QCPRange keyRange(bool &foundRange, QCP::SignDomain signDomain=QCP::sdBoth) const;
+  QCPRange valueRange(bool &foundRange, QCP::SignDomain signDomain=QCP::sdBoth, const QCPRange &inKeyRange=QCPRange()) const;
+  QCPRange valueRange(bool &foundRange, int begin, int end, QCP::SignDomain signDomain=QCP::sdBoth) const;
+  
+protected:
+  // non-property members:
+  QVector<double> mKeys, mValues;
+  const double *mKeyData, *mValueData;
+  int mSize;
+  bool mExternal;
+  int mCapacity, mStart;
+  quint32 mRevision;
+  
+  // non-virtual methods:
+  void detach();
+  void updateDataPointers();
+  void copyWindow(QVector<double> &keys, QVector<double> &values) const;
+  void layoutRing(const QVector<double> &keys, const QVector<double> &values);
+  void appendToRing(double key, double value);
+  static void sortColumns(QVector<double> &keys, QVector<double> &values);
+};
+
+class QCP_LIB_DECL QCPGraphDataQueue : public QObject
+{
+  Q_OBJECT
+public:
+  explicit QCPGraphDataQueue(QObject *parent=nullptr);
+  virtual ~QCPGraphDataQueue() Q_DECL_OVERRIDE;
+  
+  // getters:
+  qint64 mergedCount() const { return mMergedCount; }
+  qint64 mergedBatchCount() const { return mMergedBatchCount; }
+  double latency(bool average=false) const;
+  double maxLatency() const { return mMaxLatency; }
+  double throughput() const { return mThroughput; }
+  
+  // non-property methods:
+  void push(const QVector<double> &keys, const QVector<double> &values);
+  void push(const QVector<QCPGraphData> &data);
+  void push(double key, double value);
+  bool takeAll(QVector<QCPGraphData> &data);
+  void resetStatistics();
+  
+signals:
+  void dataPushed();
+  
+protected:
+  struct Batch
+  {
+    QVector<QCPGraphData> data;
+    qint64 pushTime;
+    QAtomicPointer<Batch> next;
+  };
+  
+  // non-property members:
+  QAtomicPointer<Batch> mHead;
+  Batch *mTail;
+  Batch mStub;
+  QAtomicInt mNotifyPending;
+  QElapsedTimer mClock;
+  qint64 mLastMergeTime;
+  qint64 mMergedCount, mMergedBatchCount;
+  double mLatency, mLatencyAverage, mMaxLatency, mThroughput;
+  
+  // non-virtual methods:
+  void enqueue(Batch *batch);
+  Batch *dequeue();
+  
+private:
+  Q_DISABLE_COPY(QCPGraphDataQueue)
+};
+
 class QCP_LIB_DECL QCPGraph : public QCPAbstractPlottable1D<QCPGraphData>
 {
   Q_OBJECT
@@ -5522,6 +6388,8 @@ public:
   
   // getters:
   QSharedPointer<QCPGraphDataContainer> data() const { return mDataContainer; }
+  QSharedPointer<QCPGraphDataColumns> dataColumns() const { return mDataColumns; }
+  QSharedPointer<QCPGraphDataQueue> dataQueue() const { return mDataQueue; }
   LineStyle lineStyle() const { return mLineStyle; }
   QCPScatterStyle scatterStyle() const { return mScatterStyle; }
   int scatterSkip() const { return mScatterSkip; }
@@ -5531,6 +6399,8 @@ public:
   // setters:
   void setData(QSharedPointer<QCPGraphDataContainer> data);
   void setData(const QVector<double> &keys, const QVector<double> &values, bool alreadySorted=false);
+  void setDataColumns(QSharedPointer<QCPGraphDataColumns> columns);
+  void setDataQueue(QSharedPointer<QCPGraphDataQueue> queue);
   void setLineStyle(LineStyle ls);
   void setScatterStyle(const QCPScatterStyle &style);
   void setScatterSkip(int skip);
@@ -5540,8 +6410,18 @@ public:
   // non-property methods:
   void addData(const QVector<double> &keys, const QVector<double> &values, bool alreadySorted=false);
   void addData(double key, double value);
+  int mergeDataQueue();
   
   // reimplemented virtual methods:
+  virtual int dataCount() const Q_DECL_OVERRIDE;
+  virtual double dataMainKey(int index) const Q_DECL_OVERRIDE;
+  virtual double dataSortKey(int index) const Q_DECL_OVERRIDE;
+  virtual double dataMainValue(int index) const Q_DECL_OVERRIDE;
+  virtual QCPRange dataValueRange(int index) const Q_DECL_OVERRIDE;
+  virtual QPointF dataPixelPosition(int index) const Q_DECL_OVERRIDE;
+  virtual QCPDataSelection selectTestRect(const QRectF &rect, bool onlySelectable) const Q_DECL_OVERRIDE;
+  virtual int findBegin(double sortKey, bool expandedRange=true) const Q_DECL_OVERRIDE;
+  virtual int findEnd(double sortKey, bool expandedRange=true) const Q_DECL_OVERRIDE;
   virtual double selectTest(const QPointF &pos, bool onlySelectable, QVariant *details=nullptr) const Q_DECL_OVERRIDE;
   virtual QCPRange getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain=QCP::sdBoth) const Q_DECL_OVERRIDE;
   virtual QCPRange getValueRange(bool &foundRange, QCP::SignDomain inSignDomain=QCP::sdBoth, const QCPRange &inKeyRange=QCPRange()) const Q_DECL_OVERRIDE;
@@ -5553,10 +6433,16 @@ protected:
   int mScatterSkip;
   QPointer<QCPGraph> mChannelFillGraph;
   bool mAdaptiveSampling;
+  QSharedPointer<QCPGraphDataColumns> mDataColumns;
+  QSharedPointer<QCPGraphDataQueue> mDataQueue;
+  
+  // non-property members:
+  mutable QCPSegmentIndex mLineIndex;
   
   // reimplemented virtual methods:
   virtual void draw(QCPPainter *painter) Q_DECL_OVERRIDE;
   virtual void drawLegendIcon(QCPPainter *painter, const QRectF &rect) const Q_DECL_OVERRIDE;
+  virtual quint32 dataRevision() const Q_DECL_OVERRIDE;
   
   // introduced virtual methods:
   virtual void drawFill(QCPPainter *painter, QVector<QPointF> *lines) const;
@@ -5568,7 +6454,13 @@ protected:
   virtual void getOptimizedScatterData(QVector<QCPGraphData> *scatterData, QCPGraphDataContainer::const_iterator begin, QCPGraphDataContainer::const_iterator end) const;
   
   // non-virtual methods:
+  Q_SLOT void dataQueueFilled();
+  QCPGraphData dataAt(int index) const;
+  void getPixelSampledLineData(QVector<QCPGraphData> *lineData, int begin, int end) const;
+  void getColumnLineData(QVector<QCPGraphData> *lineData, int begin, int end) const;
+  void getSampledScatterData(QVector<QCPGraphData> *scatterData, int begin, int end) const;
   void getVisibleDataBounds(QCPGraphDataContainer::const_iterator &begin, QCPGraphDataContainer::const_iterator &end, const QCPDataRange &rangeRestriction) const;
+  void getVisibleColumnBounds(int &begin, int &end, const QCPDataRange &rangeRestriction) const;
   void getLines(QVector<QPointF> *lines, const QCPDataRange &dataRange) const;
   void getScatters(QVector<QPointF> *scatters, const QCPDataRange &dataRange) const;
   QVector<QPointF> dataToLines(const QVector<QCPGraphData> &data) const;
@@ -5587,6 +6479,8 @@ protected:
   int findIndexBelowY(const QVector<QPointF> *data, double y) const;
   int findIndexAboveY(const QVector<QPointF> *data, double y) const;
   double pointDistance(const QPointF &pixelPoint, QCPGraphDataContainer::const_iterator &closestData) const;
+  double pointDistance(const QPointF &pixelPoint, int &closestIndex) const;
+  double lineDistanceSquared(const QPointF &pixelPoint) const;
   
   friend class QCustomPlot;
   friend class QCPLegend;
@@ -5684,6 +6578,9 @@ protected:
   int mScatterSkip;
   LineStyle mLineStyle;
   
+  // non-property members:
+  mutable QCPSegmentIndex mPointIndex, mLineIndex;
+  
   // reimplemented virtual methods:
   virtual void draw(QCPPainter *painter) Q_DECL_OVERRIDE;
   virtual void drawLegendIcon(QCPPainter *painter, const QRectF &rect) const Q_DECL_OVERRIDE;
@@ -6033,6 +6930,7 @@ public:
   QCPRange keyRange() const { return mKeyRange; }
   QCPRange valueRange() const { return mValueRange; }
   QCPRange dataBounds() const { return mDataBounds; }
+  quint32 revision() const { return mRevision; }
   double data(double key, double value);
   double cell(int keyIndex, int valueIndex);
   unsigned char alpha(int keyIndex, int valueIndex);
@@ -6054,6 +6952,9 @@ public:
   void clearAlpha();
   void fill(double z);
   void fillAlpha(unsigned char alpha);
+  void scroll(int keyCells, int valueCells, double z=0);
+  void appendKeyColumn(const QVector<double> &z);
+  void appendValueRow(const QVector<double> &z);
   bool isEmpty() const { return mIsEmpty; }
   void coordToCell(double key, double value, int *keyIndex, int *valueIndex) const;
   void cellToCoord(int keyIndex, int valueIndex, double *key, double *value) const;
@@ -6068,9 +6969,18 @@ protected:
   double *mData;
   unsigned char *mAlpha;
   QCPRange mDataBounds;
+  QVector<QCPRange> mRowBounds;
+  QVector<bool> mRowBoundsStale;
   bool mDataModified;
+  QRect mModifiedCells;
+  QPoint mScrolledCells;
+  quint32 mRevision;
   
   bool createAlpha(bool initializeOpaque=true);
+  void writeCell(int keyIndex, int valueIndex, double z);
+  void markModified(const QRect &cells);
+  void recalculateRowBounds(int valueIndex);
+  template <typename T> void scrollCells(T *cells, int keyCells, int valueCells, T fillValue);
   
   friend class QCPColorMap;
 };
@@ -6137,6 +7047,7 @@ protected:
   QImage mMapImage, mUndersampledMapImage;
   QPixmap mLegendIcon;
   bool mMapImageInvalidated;
+  Qt::Orientation mMapImageKeyOrientation;
   
   // introduced virtual methods:
   virtual void updateMapImage();
@@ -6144,9 +7055,15 @@ protected:
   // reimplemented virtual methods:
   virtual void draw(QCPPainter *painter) Q_DECL_OVERRIDE;
   virtual void drawLegendIcon(QCPPainter *painter, const QRectF &rect) const Q_DECL_OVERRIDE;
+  virtual quint32 dataRevision() const Q_DECL_OVERRIDE;
+  
+  // non-virtual methods:
+  void colorizeCells(uchar *imageBits, int bytesPerLine, Qt::Orientation keyOrientation, const QRect &cells);
+  static void scrollImage(QImage *image, int dx, int dy);
   
   friend class QCustomPlot;
   friend class QCPLegend;
+  friend class QCPColorMapColorizeTask;
 };
 
 /* end of 'src/plottables/plottable-colormap.h' */
@@ -6394,9 +7311,15 @@ protected:
   double mWhiskerWidth;
   double mSymbolGap;
   
+  // non-property members:
+  quint32 mDataRevision;
+  mutable QCPSegmentIndex mBackboneIndex;
+  mutable QVector<int> mBackboneDataIndices;
+  
   // reimplemented virtual methods:
   virtual void draw(QCPPainter *painter) Q_DECL_OVERRIDE;
   virtual void drawLegendIcon(QCPPainter *painter, const QRectF &rect) const Q_DECL_OVERRIDE;
+  virtual quint32 dataRevision() const Q_DECL_OVERRIDE;
   virtual QCPRange getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain=QCP::sdBoth) const Q_DECL_OVERRIDE;
   virtual QCPRange getValueRange(bool &foundRange, QCP::SignDomain inSignDomain=QCP::sdBoth, const QCPRange &inKeyRange=QCPRange()) const Q_DECL_OVERRIDE;
   
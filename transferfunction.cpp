@@ -1,29 +1,182 @@
 #include "transferfunction.h"
+#include <algorithm>
 #include <complex>
 #include <cmath>
 #include <limits>
+#include <QStringBuilder>
+
+// Evaluates a polynomial with coefficients in descending powers of s at the complex point s using the Horner scheme
+static std::complex<double> evaluatePolynomial(const std::vector<double> &coefficients, std::complex<double> s)
+{
+    std::complex<double> result = 0.0;
+    for (double coefficient : coefficients) {
+        result = result * s + coefficient;
+    }
+    return result;
+}
+
+// Finds all roots of a polynomial in descending powers of s numerically with the Durand-Kerner iteration
+static void findPolynomialRoots(const std::vector<double> &coefficients, std::vector<std::complex<double>> &roots)
+{
+    // Ignores vanishing leading coefficients and splits off the roots in the origin
+    size_t first = 0;
+    while (first < coefficients.size() && coefficients[first] == 0) {
+        ++first;
+    }
+    size_t last = coefficients.size();
+    while (last > first && coefficients[last - 1] == 0) {
+        roots.push_back(0.0);
+        --last;
+    }
+    if (last - first < 2) {
+        return;
+    }
+
+    // Normalizes the polynomial to a leading coefficient of 1 and bounds the roots with the Cauchy bound
+    std::vector<double> monic(coefficients.begin() + first, coefficients.begin() + last);
+    double leading = monic[0];
+    double radius = 0;
+    for (double &coefficient : monic) {
+        coefficient /= leading;
+        radius = std::max(radius, std::abs(coefficient));
+    }
+    size_t degree = monic.size() - 1;
+
+    // Starts with points distributed on a circle that aren't symmetric to the real axis
+    std::vector<std::complex<double>> estimates(degree);
+    for (size_t k = 0; k < degree; ++k) {
+        estimates[k] = std::polar(radius, 2 * M_PI * k / degree + 0.4);
+    }
+
+    for (int iteration = 0; iteration < 500; ++iteration) {
+        double largestStep = 0;
+        for (size_t k = 0; k < degree; ++k) {
+            std::complex<double> value = evaluatePolynomial(monic, estimates[k]);
+            std::complex<double> product = 1.0;
+            for (size_t j = 0; j < degree; ++j) {
+                if (j != k) {
+                    product *= estimates[k] - estimates[j];
+                }
+            }
+            std::complex<double> step = value / product;
+            estimates[k] -= step;
+            largestStep = std::max(largestStep, std::abs(step) / std::max(1.0, std::abs(estimates[k])));
+        }
+        if (largestStep < 1e-14) {
+            break;
+        }
+    }
+
+    // Removes numerical noise from the imaginary parts of real roots
+    for (std::complex<double> &estimate : estimates) {
+        if (std::abs(estimate.imag()) < 1e-10 * std::max(1.0, std::abs(estimate))) {
+            estimate.imag(0.0);
+        }
+        roots.push_back(estimate);
+    }
+}
+
+// Appends the roots of a factor, which are exact for linear and quadratic factors, and returns false if they had to be found numerically
+static bool appendFactorRoots(const std::vector<double> &factor, std::vector<std::complex<double>> &roots)
+{
+    // Ignores vanishing leading coefficients, which don't contribute to the degree of the factor
+    size_t first = 0;
+    while (first < factor.size() && factor[first] == 0) {
+        ++first;
+    }
+    size_t degree = factor.size() - first - 1;
+
+    if (first == factor.size() || degree == 0) {
+        return true;
+    } else if (degree == 1) {
+        roots.push_back(-factor[first + 1] / factor[first]);
+        return true;
+    } else if (degree == 2) {
+        double a = factor[first];
+        double b = factor[first + 1];
+        double c = factor[first + 2];
+        std::complex<double> root = std::sqrt(std::complex<double>(b * b - 4 * a * c));
+
+        // Avoids cancellation by computing the larger root first and the second root from the product c/a
+        std::complex<double> q = -0.5 * (b + (b < 0 ? -root : root));
+        if (q == 0.0) {
+            roots.push_back(0.0);
+            roots.push_back(0.0);
+        } else {
+            roots.push_back(q / a);
+            roots.push_back(c / q);
+        }
+        return true;
+    }
+
+    findPolynomialRoots(std::vector<double>(factor.begin() + first, factor.end()), roots);
+    return false;
+}
+
+// Constructor for coefficient vectors, the whole polynomials are the only factors
+TransferFunction::TransferFunction(const std::vector<double> &numerator, const std::vector<double> &denominator)
+    : numerator(numerator), denominator(denominator), numeratorGain(1.0), denominatorGain(1.0),
+      numeratorFactors{numerator}, denominatorFactors{denominator}, factored(false)
+{
+    determineRoots();
+}
+
+// Constructor for parsed polynomials, keeps the factors for the evaluation and determines the zeros and poles of the factors
+TransferFunction::TransferFunction(const ParsedPolynomial &numerator, const ParsedPolynomial &denominator)
+    : numerator(numerator.coefficients), denominator(denominator.coefficients),
+      numeratorGain(numerator.gain), denominatorGain(denominator.gain),
+      numeratorFactors(numerator.factors), denominatorFactors(denominator.factors), factored(true)
+{
+    determineRoots();
+}
+
+// Determines the zeros and poles factor by factor, exactly for linear and quadratic factors and numerically otherwise
+void TransferFunction::determineRoots()
+{
+    exactRoots = true;
+    for (const std::vector<double> &factor : numeratorFactors) {
+        exactRoots &= appendFactorRoots(factor, zeros);
+    }
+    for (const std::vector<double> &factor : denominatorFactors) {
+        exactRoots &= appendFactorRoots(factor, poles);
+    }
+}
 
 // Evaluates the transfer function H(jw) at a given frequency w in rad/s and represent j * w in the complex plane
-std::complex<double> TransferFunction::evaluate(double w)
+std::complex<double> TransferFunction::evaluate(double w) const
 {
     std::complex<double> jw(0, w);
-    std::complex<double> num = 0.0;
-    std::complex<double> den = 0.0;
 
-    // Computes the numerator polynomial at jw
-    for (size_t i = 0; i < numerator.size(); ++i)
-    {
-        num += numerator[i] * std::pow(jw, numerator.size() - i - 1);
+    // Evaluates the factors separately if they are known, which is more accurate than the expanded polynomials
+    if (factored) {
+        std::complex<double> num = numeratorGain;
+        std::complex<double> den = denominatorGain;
+        for (const std::vector<double> &factor : numeratorFactors) {
+            num *= evaluatePolynomial(factor, jw);
+        }
+        for (const std::vector<double> &factor : denominatorFactors) {
+            den *= evaluatePolynomial(factor, jw);
+        }
+        return num / den;
     }
 
-    // Computes the denominator polynomial at jw
-    for (size_t i = 0; i < denominator.size(); ++i)
-    {
-        den += denominator[i] * std::pow(jw, denominator.size() - i - 1);
-    }
+    // Computes the numerator and denominator polynomials at jw and returns H(jw) = numerator(jw) / denominator(jw)
+    return evaluatePolynomial(numerator, jw) / evaluatePolynomial(denominator, jw);
+}
 
-    // Returns the transfer function H(jw) = numerator(jw) / denominator(jw)
-    return num / den;
+// Sums the angles of the vectors from the zeros and poles to jw, roots in the right half plane are measured from jw to the root,
+// so that no angle crosses the branch cut of arg when w passes the imaginary part of the root, which only adds a constant 180°
+double TransferFunction::continuousPhase(double w) const
+{
+    std::complex<double> jw(0, w);
+    double phase = 0.0;
+    for (const std::complex<double> &zero : zeros) {
+        phase += zero.real() > 0 ? std::arg(zero - jw) : std::arg(jw - zero);
+    }
+    for (const std::complex<double> &pole : poles) {
+        phase -= pole.real() > 0 ? std::arg(pole - jw) : std::arg(jw - pole);
+    }
+    return phase * 180 / M_PI;
 }
 
 // Generates the bode plot data with frequency in rad/s, magnitude in dB and phase in °
@@ -66,86 +219,531 @@ void TransferFunction::bodeData(std::vector<double> &frequencies, std::vector<do
     }
 }
 
-// Formats the numerator as a string for display and returns a warning if the numerator is empty
-QString TransferFunction::getFormattedNumerator()
+// Searches the maximum of a unimodal function on the interval [a, b] by golden-section search and returns its position
+template <typename Function>
+static double goldenSectionMaximum(Function f, double a, double b, double &maximum)
 {
-    if (numerator.empty()) {
-        return "Ungültiger Zähler";
+    const double invPhi = (std::sqrt(5.0) - 1) / 2;
+    double c = b - invPhi * (b - a);
+    double d = a + invPhi * (b - a);
+    double fc = f(c);
+    double fd = f(d);
+
+    // Shrinks the interval until it is small compared to a decade of frequency
+    for (int i = 0; i < 60 && (b - a) > 1e-10; ++i) {
+        if (fc > fd) {
+            b = d;
+            d = c;
+            fd = fc;
+            c = b - invPhi * (b - a);
+            fc = f(c);
+        } else {
+            a = c;
+            c = d;
+            fc = fd;
+            d = a + invPhi * (b - a);
+            fd = f(d);
+        }
     }
 
-    QString numeratorEq = "";
-    int numDegree = numerator.size() - 1;
+    if (fc > fd) {
+        maximum = fc;
+        return c;
+    }
+    maximum = fd;
+    return d;
+}
 
-    // Formats the numerator polynomial and skips the coefficient "1" for terms with "s" in it
-    for (int i = 0; i < numerator.size(); ++i) {
-        if (numerator[i] == 1 && (numDegree - i) > 0) {
-        } else if (numerator[i] == -1 && (numDegree - i) > 0) {
-            numeratorEq += "-";
-        } else {
-            numeratorEq += QString::number(numerator[i]);
+// Generates |S(jw)| and |T(jw)| in dB on a logarithmic grid, where S = 1/(1+H) and T = H/(1+H) with the transfer function H as open loop,
+// and refines the peaks of |S|, |T| and |S - 1/2| found on the grid by golden-section search between the neighbouring grid points.
+// Also checks the closed loop poles, since the peaks don't describe robustness if the nominal closed loop is unstable
+SensitivityPeaks TransferFunction::sensitivityData(std::vector<double> &frequencies, std::vector<double> &sensitivity,
+                                                   std::vector<double> &complementarySensitivity, double freqStart, double freqEnd, int numPoints) const
+{
+    frequencies.resize(numPoints);
+    sensitivity.resize(numPoints);
+    complementarySensitivity.resize(numPoints);
+
+    double logStart = std::log10(freqStart);
+    double logEnd = std::log10(freqEnd);
+
+    // Tracks the grid points with the largest |S|, |T| and |S - 1/2| while the grid is evaluated
+    int sensitivityPeakIndex = 0;
+    int complementaryPeakIndex = 0;
+    int diskPeakIndex = 0;
+    double maxSensitivity = -1;
+    double maxComplementary = -1;
+    double maxDisk = -1;
+
+    for (int i = 0; i < numPoints; ++i) {
+        double logFreq = logStart + (logEnd - logStart) * i / (numPoints - 1);
+        double w = std::pow(10, logFreq);
+        frequencies[i] = w;
+
+        // Evaluates the open loop once and derives both sensitivity functions from it
+        std::complex<double> L = evaluate(w);
+        std::complex<double> S = 1.0 / (1.0 + L);
+        double absS = std::abs(S);
+        double absT = std::abs(L * S);
+        double absDisk = std::abs(S - 0.5);
+
+        sensitivity[i] = 20 * std::log10(absS);
+        complementarySensitivity[i] = 20 * std::log10(absT);
+
+        if (absS > maxSensitivity) {
+            maxSensitivity = absS;
+            sensitivityPeakIndex = i;
+        }
+        if (absT > maxComplementary) {
+            maxComplementary = absT;
+            complementaryPeakIndex = i;
         }
+        if (absDisk > maxDisk) {
+            maxDisk = absDisk;
+            diskPeakIndex = i;
+        }
+    }
 
-        // Adds the variable part "s" and its exponent, if necessary
-        if (numDegree - i > 0) {
-            numeratorEq += "s";
-            if (numDegree - i > 1) {
-                numeratorEq += "<sup>" + QString::number(numDegree - i) + "</sup>";
+    // Refines a peak in log frequency between the neighbours of the grid point and returns its frequency in rad/s
+    auto refine = [&](int index, auto magnitudeAt, double &peak) {
+        double lower = logStart + (logEnd - logStart) * std::max(index - 1, 0) / (numPoints - 1);
+        double upper = logStart + (logEnd - logStart) * std::min(index + 1, numPoints - 1) / (numPoints - 1);
+        double refinedPeak;
+        double logPeak = goldenSectionMaximum([&](double logFreq) { return magnitudeAt(evaluate(std::pow(10, logFreq))); },
+                                              lower, upper, refinedPeak);
+        if (refinedPeak > peak) {
+            peak = refinedPeak;
+            return std::pow(10, logPeak);
+        }
+        return frequencies[index];
+    };
+
+    SensitivityPeaks peaks;
+
+    // Determines the closed loop poles as roots of N + D, poles on the imaginary axis (apart from numerical noise) count as unstable
+    std::vector<double> characteristic(std::max(numerator.size(), denominator.size()), 0.0);
+    std::copy_backward(numerator.begin(), numerator.end(), characteristic.end());
+    for (size_t k = 0; k < denominator.size(); ++k) {
+        characteristic[characteristic.size() - denominator.size() + k] += denominator[k];
+    }
+    std::vector<std::complex<double>> closedLoopPoles;
+    findPolynomialRoots(characteristic, closedLoopPoles);
+    peaks.closedLoopStable = std::any_of(characteristic.begin(), characteristic.end(), [](double c) { return c != 0; }) &&
+        std::none_of(closedLoopPoles.begin(), closedLoopPoles.end(), [](const std::complex<double> &pole) {
+            return pole.real() >= -1e-10 * std::max(1.0, std::abs(pole));
+        });
+
+    peaks.peakSensitivity = maxSensitivity;
+    peaks.peakSensitivityFrequency = refine(sensitivityPeakIndex,
+        [](std::complex<double> L) { return std::abs(1.0 / (1.0 + L)); }, peaks.peakSensitivity);
+    peaks.peakComplementarySensitivity = maxComplementary;
+    peaks.peakComplementarySensitivityFrequency = refine(complementaryPeakIndex,
+        [](std::complex<double> L) { return std::abs(L / (1.0 + L)); }, peaks.peakComplementarySensitivity);
+    double peakDisk = maxDisk;
+    peaks.diskMarginFrequency = refine(diskPeakIndex,
+        [](std::complex<double> L) { return std::abs(1.0 / (1.0 + L) - 0.5); }, peakDisk);
+
+    // Calculates the symmetric disk margin alpha = 1 / max|S - 1/2| and the gain (in dB) and phase (in °) variations it tolerates
+    peaks.diskMargin = 1.0 / peakDisk;
+    if (peaks.diskMargin >= 2) {
+        peaks.diskGainMargin = std::numeric_limits<double>::infinity();
+    } else {
+        peaks.diskGainMargin = 20 * std::log10((2 + peaks.diskMargin) / (2 - peaks.diskMargin));
+    }
+    peaks.diskPhaseMargin = 2 * std::atan(peaks.diskMargin / 2) * 180 / M_PI;
+
+    return peaks;
+}
+
+// Checks if two frequencies are equal apart from rounding errors, e.g. the corner frequencies of a complex conjugate pair
+static bool nearlyEqual(double a, double b)
+{
+    return std::abs(a - b) <= 1e-9 * std::max(std::abs(a), std::abs(b));
+}
+
+// Returns the highest non-vanishing coefficient of a polynomial in descending powers of s, or 0 for the zero polynomial
+static double leadingCoefficient(const std::vector<double> &coefficients)
+{
+    for (double coefficient : coefficients) {
+        if (coefficient != 0) {
+            return coefficient;
+        }
+    }
+    return 0.0;
+}
+
+// Calculates the characteristics from the magnitude in dB as sum of the logarithmic distances of jw to the zeros and poles. Between
+// neighbouring corner frequencies the magnitude is monotone or unimodal, so the -3 dB crossing and the resonance peak are bracketed
+// on a grid that contains the corner frequencies and refined by bisection and golden-section search
+FrequencyCharacteristics TransferFunction::frequencyCharacteristics() const
+{
+    FrequencyCharacteristics characteristics;
+    double gain = leadingCoefficient(denominator) != 0 ? leadingCoefficient(numerator) / leadingCoefficient(denominator) : 0.0;
+    if (gain == 0) {
+        return characteristics;
+    }
+
+    // Collects the corner frequencies |p| of all zeros and poles outside the origin
+    for (const std::vector<std::complex<double>> *roots : {&zeros, &poles}) {
+        for (const std::complex<double> &root : *roots) {
+            if (std::abs(root) > 0) {
+                characteristics.cornerFrequencies.push_back(std::abs(root));
+            }
+        }
+    }
+    std::sort(characteristics.cornerFrequencies.begin(), characteristics.cornerFrequencies.end());
+    characteristics.cornerFrequencies.erase(std::unique(characteristics.cornerFrequencies.begin(), characteristics.cornerFrequencies.end(),
+                                                        nearlyEqual), characteristics.cornerFrequencies.end());
+
+    // The DC gain only exists without zeros and poles in the origin
+    double numeratorDc = numerator.empty() ? 0.0 : numerator.back();
+    double denominatorDc = denominator.empty() ? 0.0 : denominator.back();
+    if (numeratorDc != 0 && denominatorDc != 0) {
+        characteristics.dcGain = 20 * std::log10(std::abs(numeratorDc / denominatorDc));
+    }
+
+    // Without corner frequencies the magnitude is a straight line, which has neither a resonance nor a -3 dB crossing
+    if (characteristics.cornerFrequencies.empty()) {
+        return characteristics;
+    }
+
+    auto magnitudeAt = [&](double logFreq) {
+        std::complex<double> jw(0, std::pow(10, logFreq));
+        double magnitude = 20 * std::log10(std::abs(gain));
+        for (const std::complex<double> &zero : zeros) {
+            magnitude += 20 * std::log10(std::abs(jw - zero));
+        }
+        for (const std::complex<double> &pole : poles) {
+            magnitude -= 20 * std::log10(std::abs(jw - pole));
+        }
+        return magnitude;
+    };
+
+    // Samples the magnitude at the corner frequencies and at eight steps between neighbouring corners, from two decades below the
+    // lowest to two decades above the highest corner frequency
+    std::vector<double> logCorners{std::log10(characteristics.cornerFrequencies.front()) - 2};
+    for (double corner : characteristics.cornerFrequencies) {
+        logCorners.push_back(std::log10(corner));
+    }
+    logCorners.push_back(logCorners.back() + 2);
+    const int steps = 8;
+    std::vector<double> logFrequencies;
+    for (size_t k = 0; k + 1 < logCorners.size(); ++k) {
+        for (int step = 0; step < steps; ++step) {
+            logFrequencies.push_back(logCorners[k] + (logCorners[k + 1] - logCorners[k]) * step / steps);
+        }
+    }
+    logFrequencies.push_back(logCorners.back());
+    std::vector<double> magnitudes;
+    for (double logFreq : logFrequencies) {
+        magnitudes.push_back(magnitudeAt(logFreq));
+    }
+
+    // Refines every sampled local maximum between its neighbouring samples and keeps the highest as resonance peak
+    for (size_t i = 1; i + 1 < magnitudes.size(); ++i) {
+        if (magnitudes[i] > magnitudes[i - 1] && magnitudes[i] >= magnitudes[i + 1]) {
+            double peak;
+            double logPeak = goldenSectionMaximum(magnitudeAt, logFrequencies[i - 1], logFrequencies[i + 1], peak);
+            if (peak > std::max(magnitudes[i - 1], magnitudes[i + 1]) + 1e-9 &&
+                (characteristics.resonanceFrequency < 0 || peak > characteristics.resonancePeak)) {
+                characteristics.resonanceFrequency = std::pow(10, logPeak);
+                characteristics.resonancePeak = peak;
             }
         }
+    }
 
-        // Adds "+" or "-" between the terms
-        if (i < numerator.size() - 1) {
-            numeratorEq += (numerator[i + 1] >= 0) ? " + " : " - ";
-            numerator[i + 1] = std::abs(numerator[i + 1]);
+    // The bandwidth is the lowest frequency at which the magnitude has dropped 3 dB below the DC gain
+    if (std::isnan(characteristics.dcGain)) {
+        return characteristics;
+    }
+    double target = characteristics.dcGain - 10 * std::log10(2.0);
+
+    // Continues the samples by decades while the high frequency asymptote still falls towards the target
+    for (int decade = 0; decade < 40 && magnitudes.back() >= target && zeros.size() < poles.size(); ++decade) {
+        logFrequencies.push_back(logFrequencies.back() + 1);
+        magnitudes.push_back(magnitudeAt(logFrequencies.back()));
+    }
+    for (size_t i = 1; i < magnitudes.size(); ++i) {
+        if (magnitudes[i] < target) {
+            double lower = logFrequencies[i - 1];
+            double upper = logFrequencies[i];
+            for (int iteration = 0; iteration < 60 && upper - lower > 1e-12; ++iteration) {
+                double middle = (lower + upper) / 2;
+                if (magnitudeAt(middle) >= target) {
+                    lower = middle;
+                } else {
+                    upper = middle;
+                }
+            }
+            characteristics.bandwidth = std::pow(10, (lower + upper) / 2);
+            break;
         }
     }
 
-    return numeratorEq;
+    return characteristics;
 }
 
-// Formats the denominator as a string for display and returns a warning if the denominator is empty
-QString TransferFunction::getFormattedDenominator()
+// Generates the straight-line approximation of the bode plot: every zero or pole outside the origin bends the magnitude by
+// ±20 dB per decade at its corner frequency and turns the phase by ±90° between corner / 10^ζ and corner * 10^ζ,
+// where ζ is the damping of the root (1 for real roots)
+void TransferFunction::asymptoteData(std::vector<double> &frequencies, std::vector<double> &magnitude, std::vector<double> &phase,
+                                     double freqStart, double freqEnd) const
 {
-    if (denominator.empty()) {
-        return "Ungültiger Nenner";
+    frequencies.clear();
+    magnitude.clear();
+    phase.clear();
+    if (numerator.empty() || denominator.empty()) {
+        return;
+    }
+
+    // Holds the corner frequency, damping and direction (+1 for zeros, -1 for poles) of a root outside the origin
+    struct Corner
+    {
+        double frequency;
+        double damping;
+        double magnitudeSlope;
+        double phaseChange;
+    };
+    std::vector<Corner> corners;
+
+    // Determines the low frequency approximation H(s) ≈ K * s^m with m = zeros - poles in the origin
+    size_t firstNumerator = 0;
+    while (firstNumerator < numerator.size() - 1 && numerator[firstNumerator] == 0) {
+        ++firstNumerator;
+    }
+    size_t firstDenominator = 0;
+    while (firstDenominator < denominator.size() - 1 && denominator[firstDenominator] == 0) {
+        ++firstDenominator;
+    }
+    std::complex<double> lowFrequencyGain = numerator[firstNumerator] / denominator[firstDenominator];
+    int originOrder = 0;
+
+    for (int direction : {1, -1}) {
+        for (const std::complex<double> &root : (direction > 0 ? zeros : poles)) {
+            double frequency = std::abs(root);
+            if (frequency == 0) {
+                originOrder += direction;
+                continue;
+            }
+            lowFrequencyGain = (direction > 0) ? lowFrequencyGain * -root : lowFrequencyGain / -root;
+
+            // Left half-plane zeros and right half-plane poles raise the phase, the others lower it
+            double phaseChange = (root.real() <= 0 ? 90.0 : -90.0) * direction;
+            corners.push_back({frequency, std::abs(root.real()) / frequency, 20.0 * direction, phaseChange});
+        }
+    }
+
+    // Uses the range limits and all break frequencies of the asymptotes within the range as data points
+    frequencies.push_back(freqStart);
+    frequencies.push_back(freqEnd);
+    for (const Corner &corner : corners) {
+        double spread = std::pow(10, corner.damping);
+        for (double frequency : {corner.frequency / spread, corner.frequency, corner.frequency * spread}) {
+            if (frequency > freqStart && frequency < freqEnd) {
+                frequencies.push_back(frequency);
+            }
+        }
+    }
+    std::sort(frequencies.begin(), frequencies.end());
+    frequencies.erase(std::unique(frequencies.begin(), frequencies.end(), nearlyEqual), frequencies.end());
+
+    double baseMagnitude = 20 * std::log10(std::abs(lowFrequencyGain));
+    double basePhase = std::arg(lowFrequencyGain) * 180 / M_PI + 90.0 * originOrder;
+
+    for (double w : frequencies) {
+        double logW = std::log10(w);
+        double magnitudeDb = baseMagnitude + 20.0 * originOrder * logW;
+        double phaseDeg = basePhase;
+
+        for (const Corner &corner : corners) {
+            double logCorner = std::log10(corner.frequency);
+            if (logW > logCorner) {
+                magnitudeDb += corner.magnitudeSlope * (logW - logCorner);
+            }
+
+            double progress;
+            if (corner.damping > 0) {
+                progress = std::clamp((logW - logCorner + corner.damping) / (2 * corner.damping), 0.0, 1.0);
+            } else {
+                progress = (logW >= logCorner) ? 1.0 : 0.0;
+            }
+            phaseDeg += corner.phaseChange * progress;
+        }
+
+        magnitude.push_back(magnitudeDb);
+        phase.push_back(phaseDeg);
     }
 
-    QString denominatorEq = "";
-    int denDegree = denominator.size() - 1;
+    // Shifts the phase asymptote by multiples of 360° so that it starts at the same branch as the exact phase
+    double exactPhase = std::arg(evaluate(frequencies.front())) * 180 / M_PI;
+    double offset = 360 * std::round((exactPhase - phase.front()) / 360);
+    for (double &value : phase) {
+        value += offset;
+    }
+}
+
+// Appends a polynomial in descending powers of s as HTML and skips the coefficient "1" for terms with "s" in it
+static void appendPolynomial(QString &text, const std::vector<double> &coefficients)
+{
+    int degree = int(coefficients.size()) - 1;
+    for (int i = 0; i <= degree; ++i) {
+        double coefficient = coefficients[i];
+        int power = degree - i;
 
-    // Formats the denominator polynomial and skips the coefficient "1" for terms with "s" in it
-    for (int i = 0; i < denominator.size(); ++i) {
-        if (denominator[i] == 1 && (denDegree - i) > 0) {
-        } else if (denominator[i] == -1 && (denDegree - i) > 0) {
-            denominatorEq += "-";
+        // Adds "+" or "-" between the terms and continues with the absolute value of the coefficient
+        if (i > 0) {
+            text += (coefficient >= 0) ? QLatin1String(" + ") : QLatin1String(" - ");
+            coefficient = std::abs(coefficient);
+        }
+
+        if (coefficient == 1 && power > 0) {
+        } else if (coefficient == -1 && power > 0) {
+            text += QLatin1Char('-');
         } else {
-            denominatorEq += QString::number(denominator[i]);
+            text += QString::number(coefficient);
         }
 
         // Adds the variable part "s" and its exponent, if necessary
-        if (denDegree - i > 0) {
-            denominatorEq += "s";
-            if (denDegree - i > 1) {
-                denominatorEq += "<sup>" + QString::number(denDegree - i) + "</sup>";
+        if (power > 0) {
+            text += QLatin1Char('s');
+            if (power > 1) {
+                text += QLatin1String("<sup>") % QString::number(power) % QLatin1String("</sup>");
+            }
+        }
+    }
+}
+
+// Appends the multiplicity of a repeated factor as exponent
+static void appendMultiplicity(QString &text, int multiplicity)
+{
+    if (multiplicity > 1) {
+        text += QLatin1String("<sup>") % QString::number(multiplicity) % QLatin1String("</sup>");
+    }
+}
+
+// Appends a constant gain in front of factors, skipping "1" and writing "-1" as "-"
+static void appendGain(QString &text, double gain, bool hasFactors)
+{
+    if (!hasFactors) {
+        text += QString::number(gain);
+    } else if (gain == -1) {
+        text += QLatin1Char('-');
+    } else if (gain != 1) {
+        text += QString::number(gain);
+    }
+}
+
+// Appends the term (s - root) for a zero or pole, e.g. "s", "(s + 2)" or "(s + 1 - j3)"
+static void appendRootTerm(QString &text, std::complex<double> root)
+{
+    double realPart = -root.real();
+    double imaginaryPart = -root.imag();
+    if (realPart == 0 && imaginaryPart == 0) {
+        text += QLatin1Char('s');
+        return;
+    }
+
+    text += QLatin1String("(s");
+    if (realPart != 0) {
+        text += (realPart > 0 ? QLatin1String(" + ") : QLatin1String(" - ")) % QString::number(std::abs(realPart));
+    }
+    if (imaginaryPart != 0) {
+        text += (imaginaryPart > 0 ? QLatin1String(" + j") : QLatin1String(" - j")) % QString::number(std::abs(imaginaryPart));
+    }
+    text += QLatin1Char(')');
+}
+
+// Formats a polynomial given as coefficients and as gain times factors in the requested display form
+static QString formatPolynomialText(const std::vector<double> &coefficients, double gain,
+                                    const std::vector<std::vector<double>> &factors, TransferFunction::DisplayForm form)
+{
+    // Reserves the typical length of a term up front, so the text is built without reallocations
+    QString text;
+    text.reserve(int(coefficients.size()) * 24 + 16);
+
+    if (form == TransferFunction::Expanded) {
+        appendPolynomial(text, coefficients);
+        return text;
+    }
+
+    if (form == TransferFunction::Factored) {
+        appendGain(text, gain, !factors.empty());
+        for (size_t i = 0; i < factors.size();) {
+            // Combines consecutive identical factors into one factor with an exponent
+            size_t next = i + 1;
+            while (next < factors.size() && factors[next] == factors[i]) {
+                ++next;
+            }
+
+            // Omits the parentheses around "s" and around a single polynomial without gain
+            bool isMonomial = factors[i].size() == 2 && factors[i][0] == 1 && factors[i][1] == 0;
+            bool isSingleFactor = factors.size() == 1 && gain == 1;
+            if (isSingleFactor) {
+                appendPolynomial(text, factors[i]);
+            } else if (isMonomial) {
+                text += QLatin1Char('s');
+            } else {
+                text += QLatin1Char('(');
+                appendPolynomial(text, factors[i]);
+                text += QLatin1Char(')');
             }
+            appendMultiplicity(text, int(next - i));
+            i = next;
+        }
+        return text;
+    }
+
+    // Pole-zero form: pulls the leading coefficients into the gain and writes each factor as product of (s - root)
+    double totalGain = gain;
+    std::vector<std::complex<double>> roots;
+    for (const std::vector<double> &factor : factors) {
+        size_t first = 0;
+        while (first < factor.size() && factor[first] == 0) {
+            ++first;
+        }
+        if (first == factor.size()) {
+            totalGain = 0;
+            continue;
         }
 
-        // Adds "+" or "-" between the terms
-        if (i < denominator.size() - 1) {
-            denominatorEq += (denominator[i + 1] >= 0) ? " + " : " - ";
-            denominator[i + 1] = std::abs(denominator[i + 1]);
+        std::vector<double> normalized(factor.begin() + first, factor.end());
+        double leading = normalized[0];
+        for (double &coefficient : normalized) {
+            coefficient /= leading;
         }
+        totalGain *= leading;
+
+        appendFactorRoots(normalized, roots);
     }
 
-    return denominatorEq;
+    appendGain(text, totalGain, totalGain != 0 && !roots.empty());
+    if (totalGain == 0) {
+        return text;
+    }
+    for (size_t i = 0; i < roots.size();) {
+        size_t next = i + 1;
+        while (next < roots.size() && roots[next] == roots[i]) {
+            ++next;
+        }
+        appendRootTerm(text, roots[i]);
+        appendMultiplicity(text, int(next - i));
+        i = next;
+    }
+    return text;
+}
+
+// Formats a parsed polynomial for display, e.g. while the transfer function is being entered
+QString TransferFunction::formatPolynomial(const ParsedPolynomial &polynomial, DisplayForm form)
+{
+    return formatPolynomialText(polynomial.coefficients, polynomial.gain, polynomial.factors, form);
 }
 
 // Calculates the gain margin of the system
 double TransferFunction::calculateGainMargin()
 {
     // Searches for a phase crossover (where the phase crosses -180°) in a given frequency range and with a given number of samples
-    double freqStart = 10e-3;
-    double freqEnd = 10e6;
+    double freqStart = analysisFreqStart;
+    double freqEnd = analysisFreqEnd;
     int numPoints = 1000000;
 
     // Initializes as no phase crossover found and a magnitude of 0 at the phase crossover
@@ -203,8 +801,8 @@ double TransferFunction::calculateGainMargin()
 double TransferFunction::calculatePhaseMargin()
 {
     // Searches for a gain crossover (where the magnitude crosses 0 dB) in a given frequency range and with a given number of samples
-    double freqStart = 10e-3;
-    double freqEnd = 10e6;
+    double freqStart = analysisFreqStart;
+    double freqEnd = analysisFreqEnd;
     int numPoints = 1000000;
 
     // Initializes as no gain crossover found and a phase of 0 at the gain crossover
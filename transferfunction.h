@@ -3,37 +3,122 @@
 
 #include <vector>
 #include <complex>
+#include <limits>
 #include <QString>
+#include "polynomialparser.h"
+
+// Holds the peaks of the sensitivity S = 1/(1+L) and complementary sensitivity T = L/(1+L) of the closed loop with the
+// transfer function as open loop L, and the resulting symmetric disk margin with the gain and phase variations it tolerates
+struct SensitivityPeaks
+{
+    // Whether all closed loop poles lie in the open left half plane, the peaks and the disk margin are only meaningful then
+    bool closedLoopStable = false;
+
+    double peakSensitivity = 0.0;
+    double peakSensitivityFrequency = 0.0;
+    double peakComplementarySensitivity = 0.0;
+    double peakComplementarySensitivityFrequency = 0.0;
+    double diskMargin = 0.0;
+    double diskMarginFrequency = 0.0;
+    double diskGainMargin = 0.0;
+    double diskPhaseMargin = 0.0;
+};
+
+// Holds frequency domain characteristics of the transfer function, frequencies are negative if they don't exist
+struct FrequencyCharacteristics
+{
+    // Magnitude for w -> 0 in dB, which is only finite without poles and zeros in the origin
+    double dcGain = std::numeric_limits<double>::quiet_NaN();
+
+    // Frequency in rad/s at which the magnitude has dropped 3 dB below the DC gain
+    double bandwidth = -1.0;
+
+    // Frequency in rad/s and magnitude in dB of the highest resonance peak
+    double resonanceFrequency = -1.0;
+    double resonancePeak = 0.0;
+
+    // Corner frequencies of the zeros and poles in rad/s in ascending order
+    std::vector<double> cornerFrequencies;
+};
 
 // The TransferFunction class calculates properties of a transfer function and provides data for the bode plots
 class TransferFunction
 {
 public:
+    // Defines how numerator and denominator are displayed: expanded polynomial, product of the entered factors or product of (s - root) terms
+    enum DisplayForm { Expanded, Factored, PoleZero };
+
+    // Frequency range in rad/s over which the closed loop and the margins are analyzed, independent of the displayed range
+    static constexpr double analysisFreqStart = 10e-3;
+    static constexpr double analysisFreqEnd = 10e6;
+
+    // Number of points of the logarithmic grid on which the sensitivity functions are evaluated before their peaks are refined
+    static constexpr int sensitivityPoints = 2000;
+
     // Initializes the transfer function with given numerator and denominator coefficients
-    TransferFunction(const std::vector<double> &numerator, const std::vector<double> &denominator)
-        : numerator(numerator), denominator(denominator) {}
+    TransferFunction(const std::vector<double> &numerator, const std::vector<double> &denominator);
+
+    // Initializes the transfer function with parsed numerator and denominator polynomials and keeps their factors
+    TransferFunction(const ParsedPolynomial &numerator, const ParsedPolynomial &denominator);
 
     // Evaluates the transfer function H(jw) at the frequency w in rad/s
-    std::complex<double> evaluate(double w);
+    std::complex<double> evaluate(double w) const;
+
+    // Calculates a phase in ° from the angles of the zeros and poles, which is continuous in w unlike arg(H(jw))
+    // It differs from the unwrapped phase by a constant, so it selects the branch of arg(H(jw)) for points computed in any order
+    double continuousPhase(double w) const;
 
     // Generates the bode plot data (frequencies, magnitude, phase) over a specified frequency range
     void bodeData(std::vector<double> &frequencies, std::vector<double> &magnitude,
                   std::vector<double> &phase, double freqStart, double freqEnd, int numPoints);
 
+    // Generates the magnitudes of the sensitivity and complementary sensitivity in dB and determines their peaks in the same pass
+    SensitivityPeaks sensitivityData(std::vector<double> &frequencies, std::vector<double> &sensitivity,
+                                     std::vector<double> &complementarySensitivity, double freqStart = analysisFreqStart,
+                                     double freqEnd = analysisFreqEnd, int numPoints = sensitivityPoints) const;
+
     // Calculates the gain margin of the transfer function
     double calculateGainMargin();
 
     // Calculates the phase margin of the transfer function
     double calculatePhaseMargin();
 
-    // Returns the formatted numerator and denominator expressions as strings
-    QString getFormattedNumerator();
-    QString getFormattedDenominator();
+    // Formats a parsed polynomial as HTML in the given display form
+    static QString formatPolynomial(const ParsedPolynomial &polynomial, DisplayForm form);
+
+    // Returns the zeros and poles, which are determined factor by factor
+    const std::vector<std::complex<double>> &getZeros() const { return zeros; }
+    const std::vector<std::complex<double>> &getPoles() const { return poles; }
+
+    // Returns whether all zeros and poles are known exactly, i.e. no factor has a degree of more than two
+    bool hasExactRoots() const { return exactRoots; }
+
+    // Calculates the DC gain, the -3 dB bandwidth, the resonance peak and the corner frequencies from the zeros and poles
+    FrequencyCharacteristics frequencyCharacteristics() const;
+
+    // Generates the straight-line asymptotes of the magnitude in dB and the phase in ° at their break frequencies within the range
+    void asymptoteData(std::vector<double> &frequencies, std::vector<double> &magnitude, std::vector<double> &phase,
+                       double freqStart, double freqEnd) const;
 
 private:
     // Creates a vector with the coefficients of the numerator polynomial and the denominator polynomial
     std::vector<double> numerator;
     std::vector<double> denominator;
+
+    // Stores the constant gains and polynomial factors, which are evaluated separately if the input was factored
+    double numeratorGain;
+    double denominatorGain;
+    std::vector<std::vector<double>> numeratorFactors;
+    std::vector<std::vector<double>> denominatorFactors;
+    bool factored;
+
+    // Stores the zeros and poles of the factors and whether they are exact
+    std::vector<std::complex<double>> zeros;
+    std::vector<std::complex<double>> poles;
+    bool exactRoots = false;
+
+    // Determines the zeros and poles of all factors
+    void determineRoots();
 };
 
 #endif